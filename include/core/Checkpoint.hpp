@@ -0,0 +1,85 @@
+#ifndef NGEN_CHECKPOINT_HPP
+#define NGEN_CHECKPOINT_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hy_features {
+
+    /**
+     * @brief The saved state of the features on a single process at one point in a simulation.
+     *
+     * A checkpoint holds an opaque block of state for each catchment formulation and each nexus, keyed by id, along
+     * with the output time index and epoch time at which it was taken.  It is stored as a single binary file per
+     * process, consisting of a versioned header followed by the state records:
+     *
+     * - the magic bytes ``NGENCKPT``
+     * - a ``uint32`` format version, then a ``uint32`` byte order marker (``0x01020304`` as written)
+     * - an ``int32`` process rank, an ``int64`` output time index, and an ``int64`` epoch time
+     * - the ``uint64`` size and ``uint64`` FNV-1a checksum of the remainder of the file
+     * - a ``uint64`` count of catchment records, then each one as a length-prefixed id and length-prefixed state
+     * - the same for nexus records
+     *
+     * Values are in native byte order, so checkpoints are only portable between systems of the same byte order.
+     */
+    class Checkpoint {
+
+      public:
+
+        typedef std::pair<std::string, std::vector<char>> state_record;
+
+        /** The current version of the checkpoint file format. */
+        static const uint32_t FORMAT_VERSION = 1;
+
+        Checkpoint() : rank(0), output_time_index(0), epoch_time(0) {}
+
+        Checkpoint(int rank, long output_time_index, time_t epoch_time) :
+            rank(rank), output_time_index(output_time_index), epoch_time(epoch_time) {}
+
+        /**
+         * @brief Get the path of the checkpoint file for a process.
+         *
+         * @param prefix The configured checkpoint path prefix.
+         * @param rank The process rank.
+         * @return The checkpoint file path.
+         */
+        static std::string get_file_path(const std::string &prefix, int rank);
+
+        /**
+         * @brief Write this checkpoint to a file.
+         *
+         * The file is written under a temporary name and then renamed, so an existing checkpoint at @p path is only
+         * replaced once the new one is complete.
+         *
+         * @param path The path of the file to write.
+         * @throws std::runtime_error If the file cannot be written.
+         */
+        void write(const std::string &path) const;
+
+        /**
+         * @brief Read a checkpoint from a file.
+         *
+         * @param path The path of the file to read.
+         * @return The checkpoint read.
+         * @throws std::runtime_error If the file cannot be read, is not a checkpoint, has an unsupported version or
+         *                            byte order, or is corrupt.
+         */
+        static Checkpoint read(const std::string &path);
+
+        /** The rank of the process whose state was saved. */
+        int rank;
+        /** The output time index that runs next after the saved state. */
+        long output_time_index;
+        /** The epoch time at the beginning of @ref output_time_index. */
+        time_t epoch_time;
+        /** The state of each catchment formulation, by catchment id. */
+        std::vector<state_record> catchment_states;
+        /** The state of each nexus, by nexus id. */
+        std::vector<state_record> nexus_states;
+    };
+}
+
+#endif //NGEN_CHECKPOINT_HPP
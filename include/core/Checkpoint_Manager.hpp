@@ -0,0 +1,229 @@
+#ifndef NGEN_CHECKPOINT_MANAGER_HPP
+#define NGEN_CHECKPOINT_MANAGER_HPP
+
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Checkpoint.hpp"
+#include "Checkpoint_Params.hpp"
+#include "Execution_Plan.hpp"
+#include "State_Serialization.hpp"
+
+namespace hy_features {
+
+    /**
+     * @brief Saves and restores the state of an execution plan's catchments and nexuses as checkpoints.
+     *
+     * Capturing state is done on the calling thread, since it must happen while models are between time steps, but
+     * writing the checkpoint file is then done in the background so the time loop can carry on.  Only one checkpoint
+     * write is outstanding at a time; starting another first waits for the previous one to finish.
+     *
+     * Forcing providers need no state of their own here, since they are read by time rather than through a cursor.
+     */
+    class Checkpoint_Manager {
+
+      public:
+
+        /**
+         * @param params The checkpoint configuration.
+         * @param rank The rank of this process, which identifies its checkpoint file.
+         */
+        Checkpoint_Manager(const checkpoint_params &params, int rank) : params(params), rank(rank) {}
+
+        ~Checkpoint_Manager() {
+            if (pending_write.valid()) {
+                pending_write.wait();
+            }
+        }
+
+        /**
+         * @param output_time_index An output time index.
+         * @return Whether a checkpoint is to be written at the given output time index.
+         */
+        bool is_checkpoint_time(int output_time_index) const {
+            return params.is_checkpoint_time(output_time_index);
+        }
+
+        /**
+         * @brief Get the earliest output time index after @p after at which a checkpoint is written, up to @p limit.
+         *
+         * @param after The output time index after which to search.
+         * @param limit The largest output time index to return.
+         * @return The next checkpoint output time index, or @p limit if there is none before it.
+         */
+        int next_checkpoint_time(int after, int limit) const {
+            for (int t = after + 1; t < limit; ++t) {
+                if (is_checkpoint_time(t)) {
+                    return t;
+                }
+            }
+            return limit;
+        }
+
+        /**
+         * @brief Make sure every catchment in the plan can be checkpointed, if checkpoints are in use.
+         *
+         * @param plan The execution plan.
+         * @throws std::runtime_error If checkpoints are configured but some formulation does not support them.
+         */
+        void validate(const Execution_Plan &plan) const {
+            if (!params.is_writing() && !params.is_restoring()) {
+                return;
+            }
+            for (size_t i = 0; i < plan.catchment_count(); ++i) {
+                if (!plan.catchment_formulations[i]->is_checkpointable()) {
+                    throw std::runtime_error("Checkpoints are configured, but the "
+                                             + plan.catchment_formulations[i]->get_formulation_type()
+                                             + " formulation of " + plan.catchment_ids[i] + " does not support them"
+                                             + " (BMI formulations need their 'state_variables' configured)");
+                }
+            }
+        }
+
+        /**
+         * @brief Capture the current state of the plan's catchments and nexuses, and write it in the background.
+         *
+         * @param plan The execution plan.
+         * @param output_time_index The output time index that runs next.
+         * @param epoch_time The epoch time at the beginning of @p output_time_index.
+         */
+        void write(const Execution_Plan &plan, int output_time_index, time_t epoch_time) {
+            wait();
+
+            Checkpoint checkpoint(rank, output_time_index, epoch_time);
+            checkpoint.catchment_states.reserve(plan.catchment_count());
+            for (size_t i = 0; i < plan.catchment_count(); ++i) {
+                utils::State_Writer out;
+                plan.catchment_formulations[i]->save_state(out);
+                checkpoint.catchment_states.emplace_back(plan.catchment_ids[i], out.release());
+            }
+            for (const auto &nexus : get_nexuses(plan)) {
+                utils::State_Writer out;
+                nexus->save_state(out);
+                checkpoint.nexus_states.emplace_back(nexus->get_id(), out.release());
+            }
+
+            std::string path = Checkpoint::get_file_path(params.path, rank);
+            pending_write = std::async(std::launch::async, [path](const Checkpoint &c) { c.write(path); },
+                                       std::move(checkpoint));
+        }
+
+        /**
+         * @brief Wait for any checkpoint being written in the background to finish.
+         *
+         * @throws std::runtime_error If writing the checkpoint failed.
+         */
+        void wait() {
+            if (pending_write.valid()) {
+                pending_write.get();
+            }
+        }
+
+        /**
+         * @brief Restore the state of the plan's catchments and nexuses from the configured checkpoint.
+         *
+         * The checkpoint may come from a different simulation than this one, e.g., the end of a previous operational
+         * cycle, as long as the time at which it was taken is one of this simulation's output times.  Time step indices
+         * in the saved state are shifted accordingly.
+         *
+         * @param plan The execution plan.
+         * @param total_output_times The total number of output times in this simulation.
+         * @param start_epoch_time The epoch time at the beginning of this simulation.
+         * @param output_interval_seconds The length of each output time in this simulation, in seconds.
+         * @return The output time index from which this simulation resumes.
+         * @throws std::runtime_error If the checkpoint cannot be read or does not match this simulation.
+         */
+        int restore(Execution_Plan &plan, int total_output_times, time_t start_epoch_time, int output_interval_seconds) {
+            std::string path = Checkpoint::get_file_path(params.restart_from, rank);
+            Checkpoint checkpoint = Checkpoint::read(path);
+            if (checkpoint.rank != rank) {
+                throw std::runtime_error("Checkpoint file " + path + " was written by process "
+                                         + std::to_string(checkpoint.rank) + ", not " + std::to_string(rank));
+            }
+            time_t since_start = checkpoint.epoch_time - start_epoch_time;
+            if (since_start < 0 || since_start % output_interval_seconds != 0
+                || since_start / output_interval_seconds > total_output_times) {
+                throw std::runtime_error("Checkpoint file " + path + " was not taken at an output time of this simulation");
+            }
+            int resume_index = since_start / output_interval_seconds;
+            long step_offset = resume_index - checkpoint.output_time_index;
+
+            std::unordered_map<std::string, size_t> catchment_index;
+            for (size_t i = 0; i < plan.catchment_count(); ++i) {
+                catchment_index[plan.catchment_ids[i]] = i;
+            }
+            for (const auto &record : checkpoint.catchment_states) {
+                auto it = catchment_index.find(record.first);
+                if (it == catchment_index.end()) {
+                    throw std::runtime_error("Checkpoint file " + path + " has state for unknown catchment " + record.first);
+                }
+                utils::State_Reader in(record.second);
+                plan.catchment_formulations[it->second]->load_state(in, step_offset);
+                require_fully_read(in, path, record.first);
+                catchment_index.erase(it);
+            }
+            if (!catchment_index.empty()) {
+                throw std::runtime_error("Checkpoint file " + path + " has no state for catchment "
+                                         + catchment_index.begin()->first);
+            }
+
+            std::unordered_map<std::string, std::shared_ptr<HY_HydroNexus>> nexus_index;
+            for (const auto &nexus : get_nexuses(plan)) {
+                nexus_index[nexus->get_id()] = nexus;
+            }
+            for (const auto &record : checkpoint.nexus_states) {
+                auto it = nexus_index.find(record.first);
+                if (it == nexus_index.end()) {
+                    throw std::runtime_error("Checkpoint file " + path + " has state for unknown nexus " + record.first);
+                }
+                utils::State_Reader in(record.second);
+                it->second->load_state(in, step_offset);
+                require_fully_read(in, path, record.first);
+                nexus_index.erase(it);
+            }
+            if (!nexus_index.empty()) {
+                throw std::runtime_error("Checkpoint file " + path + " has no state for nexus " + nexus_index.begin()->first);
+            }
+            return resume_index;
+        }
+
+      private:
+
+        static void require_fully_read(const utils::State_Reader &in, const std::string &path, const std::string &id) {
+            if (in.remaining() != 0) {
+                throw std::runtime_error("Checkpoint file " + path + " has " + std::to_string(in.remaining())
+                                         + " unexpected extra bytes of state for " + id);
+            }
+        }
+
+        /**
+         * Get every nexus the plan's catchments or outputs touch, each once, in a stable order.
+         */
+        static std::vector<std::shared_ptr<HY_HydroNexus>> get_nexuses(const Execution_Plan &plan) {
+            std::vector<std::shared_ptr<HY_HydroNexus>> all_nexuses;
+            std::unordered_map<HY_HydroNexus*, bool> seen;
+            auto add = [&](const std::shared_ptr<HY_HydroNexus> &nexus) {
+                if (nexus != nullptr && seen.emplace(nexus.get(), true).second) {
+                    all_nexuses.push_back(nexus);
+                }
+            };
+            for (const auto &nexus : plan.nexuses) {
+                add(nexus);
+            }
+            for (const auto &nexus : plan.catchment_destinations) {
+                add(nexus);
+            }
+            return all_nexuses;
+        }
+
+        checkpoint_params params;
+        int rank;
+        std::future<void> pending_write;
+    };
+}
+
+#endif //NGEN_CHECKPOINT_MANAGER_HPP
@@ -0,0 +1,67 @@
+#ifndef NGEN_CHECKPOINT_PARAMS_HPP
+#define NGEN_CHECKPOINT_PARAMS_HPP
+
+#include <set>
+#include <string>
+
+/**
+ * @brief checkpoint_params providing configuration information for saving and restoring simulation state.
+ *
+ * Values are read from the optional ``checkpoint`` section of the realization config.  A checkpoint "at" an output
+ * time index ``t`` holds the state of the simulation immediately before time step ``t`` runs; a checkpoint at the total
+ * number of output times therefore holds the state at the end of the simulation.
+ */
+struct checkpoint_params
+{
+    /**
+     * The path prefix of the checkpoint files to write, to which the process rank is appended; empty if none are written.
+     */
+    std::string path;
+
+    /**
+     * Write a checkpoint at every positive multiple of this many output times, or 0 for no periodic checkpoints.
+     */
+    unsigned int interval;
+
+    /**
+     * Specific output time indices at which to write a checkpoint.
+     */
+    std::set<int> write_at;
+
+    /**
+     * The path prefix of the checkpoint files from which to restore state at startup; empty to start from cold state.
+     */
+    std::string restart_from;
+
+    /**
+     * Default constructor, for neither writing nor restoring checkpoints.
+     */
+    checkpoint_params() : interval(0) {}
+
+    /**
+     * @return Whether any checkpoints are to be written.
+     */
+    bool is_writing() const {
+        return !path.empty() && (interval > 0 || !write_at.empty());
+    }
+
+    /**
+     * @return Whether state is to be restored from a checkpoint at startup.
+     */
+    bool is_restoring() const {
+        return !restart_from.empty();
+    }
+
+    /**
+     * @param output_time_index An output time index.
+     * @return Whether a checkpoint is to be written at the given output time index.
+     */
+    bool is_checkpoint_time(int output_time_index) const {
+        if (!is_writing() || output_time_index <= 0) {
+            return false;
+        }
+        return (interval > 0 && output_time_index % interval == 0) || write_at.count(output_time_index) > 0;
+    }
+};
+
+#endif // NGEN_CHECKPOINT_PARAMS_HPP
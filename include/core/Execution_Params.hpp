@@ -0,0 +1,76 @@
+#ifndef NGEN_EXECUTION_PARAMS_HPP
+#define NGEN_EXECUTION_PARAMS_HPP
+
+/**
+ * @brief The order in which the driver advances catchments through time.
+ */
+enum class ExecutionMode {
+    /**
+     * Advance every catchment by one time step before moving on to the next time step.
+     */
+    TimeStep,
+    /**
+     * Advance each catchment through a block of time steps before moving on to the next catchment.
+     *
+     * This is valid because catchments are only coupled through nexus summation, and it keeps a single model's state
+     * and forcing data hot in cache for the whole block.
+     */
+    TimeBlocked,
+    /**
+     * Advance each catchment as soon as the catchments upstream of it have reached the same time step.
+     *
+     * Catchments may run ahead of the oldest incomplete time step by up to a window of time steps, so work in one part
+     * of the network overlaps with later time steps elsewhere, and with nexus output for completed time steps.
+     */
+    Wavefront
+};
+
+/**
+ * @brief execution_params providing configuration information for how the driver executes the model domain.
+ *
+ * Values are read from the optional ``execution`` section of the realization config.
+ */
+struct execution_params
+{
+    /**
+     * The total number of threads used to run catchment formulations within a time step.
+     *
+     * A value of 1 (the default) runs everything serially; a value of 0 uses the hardware concurrency.
+     */
+    unsigned int threads;
+
+    /**
+     * The order in which the driver advances catchments through time.
+     */
+    ExecutionMode mode;
+
+    /**
+     * The number of time steps each catchment is advanced at once when using @ref ExecutionMode::TimeBlocked, or the
+     * number of time steps catchments may be spread across when using @ref ExecutionMode::Wavefront.
+     */
+    unsigned int block_size;
+
+    /**
+     * Default constructor, for serial execution one time step at a time.
+     */
+    execution_params() : threads(1), mode(ExecutionMode::TimeStep), block_size(16) {}
+
+    /*
+     * @brief Constructor for execution_params
+     *
+     * @param threads
+     * @param mode
+     * @param block_size
+     */
+    execution_params(unsigned int threads, ExecutionMode mode = ExecutionMode::TimeStep, unsigned int block_size = 16) :
+        threads(threads), mode(mode), block_size(block_size) {}
+
+    /**
+     * @return The number of time steps to advance each catchment at once, which is 1 unless time-blocked.
+     */
+    unsigned int get_time_block_size() const {
+        return mode == ExecutionMode::TimeBlocked ? block_size : 1;
+    }
+};
+
+#endif // NGEN_EXECUTION_PARAMS_HPP
@@ -0,0 +1,148 @@
+#ifndef NGEN_EXECUTION_PLAN_HPP
+#define NGEN_EXECUTION_PLAN_HPP
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <HY_HydroNexus.hpp>
+#include <Catchment_Formulation.hpp>
+#include <FeatureCollection.hpp>
+
+namespace hy_features {
+
+    /**
+     * @brief Flattened, index-based view of a HY_Features collection for use by the driver time loop.
+     *
+     * Everything the driver needs for each time step that does not change over the course of a simulation is resolved
+     * once here: catchment formulations, the areas used to scale their responses, their destination nexuses, their
+     * upstream dependencies and topological levels, and the nexuses that produce output along with the id each one
+     * should be queried with.  This keeps id filtering, map
+     * lookups, pointer casts, and hydrofabric property access out of the per-time step loop.
+     *
+     * Catchments and nexuses appear in the same order as the ``catchments()`` and ``nexuses()`` iteration of the
+     * collection from which the plan was built.
+     */
+    class Execution_Plan {
+
+      public:
+
+        /**
+         * @brief Build a plan for the given features collection.
+         *
+         * @tparam Features The features collection type (e.g., HY_Features or HY_Features_MPI).
+         * @param features The collection of constructed features.
+         * @param catchment_collection The catchment hydrofabric, used to obtain catchment areas.
+         */
+        template<class Features>
+        Execution_Plan(Features &features, const geojson::GeoJSON &catchment_collection)
+        {
+            for (const auto &id : features.catchments()) {
+                //TODO redesign to avoid this cast
+                auto formulation = std::dynamic_pointer_cast<realization::Catchment_Formulation>(features.catchment_at(id));
+                if (formulation == nullptr) {
+                    throw std::runtime_error("Execution plan could not find a catchment formulation for " + id);
+                }
+
+                double area_sqkm;
+                geojson::Feature feature = catchment_collection->get_feature(id);
+                try {
+                    area_sqkm = feature->get_property("areasqkm").as_real_number();
+                }
+                catch (std::invalid_argument &e) {
+                    area_sqkm = feature->get_property("area_sqkm").as_real_number();
+                }
+
+                //TODO in a DENDRIDIC network, only one destination nexus per catchment
+                //If there is more than one, some form of catchment partitioning will be required.
+                //for now, only contribute to the first one in the list
+                auto destinations = features.destination_nexuses(id);
+
+                catchment_ids.push_back(id);
+                catchment_formulations.push_back(formulation);
+                catchment_areas_m2.push_back(area_sqkm * 1000000);
+                catchment_destinations.push_back(destinations.empty() ? nullptr : destinations[0]);
+            }
+
+            std::unordered_map<std::string, size_t> catchment_index;
+            for (size_t i = 0; i < catchment_ids.size(); ++i) {
+                catchment_index[catchment_ids[i]] = i;
+            }
+            catchment_levels.resize(catchment_ids.size(), 0);
+            int level = 0;
+            for (const auto &ids : features.catchment_levels()) {
+                for (const auto &id : ids) {
+                    auto it = catchment_index.find(id);
+                    if (it != catchment_index.end()) {
+                        catchment_levels[it->second] = level;
+                    }
+                }
+                ++level;
+            }
+            catchment_upstream.resize(catchment_ids.size());
+            for (size_t i = 0; i < catchment_ids.size(); ++i) {
+                // Upstream catchments on other processes have no local index, and are not tracked here
+                for (const auto &id : features.upstream_catchments(catchment_ids[i])) {
+                    auto it = catchment_index.find(id);
+                    if (it != catchment_index.end()) {
+                        catchment_upstream[i].push_back(it->second);
+                    }
+                }
+            }
+
+            for (const auto &id : features.nexuses()) {
+                //Ensures only one side of the dual sided remote nexus actually doing this...
+                if (features.is_remote_sender_nexus(id)) {
+                    continue;
+                }
+                auto nexus = features.nexus_at(id);
+                //Get the correct "requesting" id for downstream_flow
+                const auto &cat_ids = nexus->get_receiving_catchments();
+                //Assumes dendridic, e.g. only a single downstream...it will consume 100% of the available flow
+                //Otherwise, this is a terminal node, SHOULDN'T be remote, so ID shouldn't matter too much
+                std::string requester = cat_ids.size() > 0 ? cat_ids[0] : "terminal";
+
+                nexus_ids.push_back(id);
+                nexuses.push_back(nexus);
+                nexus_requesting_ids.push_back(requester);
+            }
+        }
+
+        /**
+         * @return The number of catchments in the plan.
+         */
+        size_t catchment_count() const {
+            return catchment_ids.size();
+        }
+
+        /**
+         * @return The number of (output producing) nexuses in the plan.
+         */
+        size_t nexus_count() const {
+            return nexus_ids.size();
+        }
+
+        /** Catchment ids, by catchment index. */
+        std::vector<std::string> catchment_ids;
+        /** Catchment formulations, by catchment index. */
+        std::vector<std::shared_ptr<realization::Catchment_Formulation>> catchment_formulations;
+        /** Catchment areas in square meters, by catchment index, used to convert responses to volumes. */
+        std::vector<double> catchment_areas_m2;
+        /** The nexus receiving each catchment's flow, by catchment index, or ``nullptr`` if there is none. */
+        std::vector<std::shared_ptr<HY_HydroNexus>> catchment_destinations;
+        /** The topological level of each catchment, by catchment index, with headwater catchments at level 0. */
+        std::vector<int> catchment_levels;
+        /** The indices of the catchments immediately upstream of each catchment, by catchment index. */
+        std::vector<std::vector<size_t>> catchment_upstream;
+
+        /** Ids of nexuses that produce output on this process, by nexus index (i.e., nexus output slot). */
+        std::vector<std::string> nexus_ids;
+        /** Nexuses that produce output on this process, by nexus index. */
+        std::vector<std::shared_ptr<HY_HydroNexus>> nexuses;
+        /** The id with which to request downstream flow from each nexus, by nexus index. */
+        std::vector<std::string> nexus_requesting_ids;
+    };
+}
+
+#endif //NGEN_EXECUTION_PLAN_HPP
@@ -123,6 +123,48 @@ namespace hy_features {
          */
         inline auto nexuses(){return network.filter("nex");}
 
+        /**
+         * @brief The catchment feature ids grouped by topological level, upstream levels first
+         *
+         * Catchments in the same level do not depend on each other through the network.
+         *
+         * @return std::vector<std::vector<std::string>>
+         */
+        inline std::vector<std::vector<std::string>> catchment_levels(){return network.get_topological_levels("cat");}
+
+        /**
+         * @brief Get the ids of the catchments immediately upstream of catchment @p id
+         *
+         * These are the catchments contributing to the nexuses that flow into @p id.
+         *
+         * @param id
+         * @return std::vector<std::string>
+         */
+        inline std::vector<std::string> upstream_catchments(std::string id)
+        {
+          std::vector<std::string> upstream;
+          for(const auto& nex_id : network.get_origination_ids(id))
+          {
+            for(const auto& cat_id : network.get_origination_ids(nex_id))
+            {
+              if(cat_id.substr(0,3) == "cat")
+                upstream.push_back(cat_id);
+            }
+          }
+          return upstream;
+        }
+
+        /**
+         * @brief Whether the nexus identified by @p id is the sending side of a remote nexus.
+         * 
+         * Without MPI there are no remote nexuses, so this is always false; it exists so code can treat this
+         * type and HY_Features_MPI uniformly.
+         * 
+         * @param id 
+         * @return false 
+         */
+        inline bool is_remote_sender_nexus(std::string id){return false;}
+
         /**
          * @brief Get a vector of destination (downstream) nexus pointers.
          * 
@@ -51,6 +51,22 @@ namespace hy_features {
             return network.filter("nex");
         }
 
+        inline std::vector<std::vector<std::string>> catchment_levels() {
+            return network.get_topological_levels("cat");
+        }
+
+        inline std::vector<std::string> upstream_catchments(std::string id) {
+            std::vector<std::string> upstream;
+            for(const auto& nex_id : network.get_origination_ids(id)) {
+                for(const auto& cat_id : network.get_origination_ids(nex_id)) {
+                    if(cat_id.substr(0,3) == "cat") {
+                        upstream.push_back(cat_id);
+                    }
+                }
+            }
+            return upstream;
+        }
+
         void validate_dendridic() {
             for(const auto& id : catchments()) {
                 auto downstream = network.get_destination_ids(id);
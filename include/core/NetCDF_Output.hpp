@@ -0,0 +1,139 @@
+#ifdef NETCDF_ACTIVE
+#ifndef NGEN_NETCDF_OUTPUT_HPP
+#define NGEN_NETCDF_OUTPUT_HPP
+
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <netcdf>
+
+namespace hy_features {
+
+    /**
+     * @brief Writes the output time series of every catchment and nexus on a process to a single NetCDF4 file.
+     *
+     * The file has a ``time`` dimension, with a ``time`` variable of epoch seconds, along with ``catchment`` and
+     * ``nexus`` dimensions, with ``catchment_id`` and ``nexus_id`` variables naming each feature.  Each distinct catchment
+     * output field becomes a ``(time, catchment)`` variable, with catchments lacking that field left as fill values,
+     * and nexus flows are written to a ``(time, nexus)`` variable named ``nexus_flow``.
+     *
+     * Values are buffered in memory and written a block of time steps at a time, with variables chunked to match, so
+     * each write is a few large hyperslabs rather than a small write per feature per time step.  The buffer holds a
+     * block and a given number of time steps more, so values may be set for time steps that far ahead of those still
+     * waiting to be written.
+     *
+     * Setting values for distinct catchments or time steps may be done concurrently, but writing may not.
+     */
+    class NetCDF_Output {
+
+      public:
+
+        /**
+         * @brief Create the output file, replacing any existing one.
+         *
+         * @param path The path of the file.
+         * @param catchment_ids The id of each catchment, by catchment index.
+         * @param catchment_fields The names of the output fields of each catchment, by catchment index.
+         * @param nexus_ids The id of each nexus, by nexus index.
+         * @param first_step The index of the first time step that is written, which is written at time index 0.
+         * @param first_epoch_time The epoch time of @p first_step.
+         * @param interval_seconds The length of each time step, in seconds.
+         * @param block_steps The most time steps written at once, which is also the chunk size in time.
+         * @param ahead_steps How many time steps past a block still to be written values may be set for.
+         * @param compression_level The deflate compression level (0-9), with 0 for no compression.
+         */
+        NetCDF_Output(const std::string &path, const std::vector<std::string> &catchment_ids,
+                      const std::vector<std::vector<std::string>> &catchment_fields,
+                      const std::vector<std::string> &nexus_ids, int first_step, time_t first_epoch_time,
+                      int interval_seconds, int block_steps, int ahead_steps, int compression_level);
+
+        /**
+         * @brief Buffer the output values of a catchment for a time step.
+         *
+         * @param catchment The index of the catchment.
+         * @param step The time step.
+         * @param values The values of the catchment's output fields, in the order they were given at construction.
+         */
+        void set_catchment_values(size_t catchment, int step, const std::vector<double> &values);
+
+        /**
+         * @brief Buffer the flow of a nexus for a time step.
+         *
+         * @param nexus The index of the nexus.
+         * @param step The time step.
+         * @param flow The flow through the nexus.
+         */
+        void set_nexus_flow(size_t nexus, int step, double flow);
+
+        /**
+         * @brief Write the buffered values for a range of time steps to the file.
+         *
+         * @param begin The first time step to write.
+         * @param end The time step after the last one to write; at most ``block_steps + ahead_steps`` after @p begin.
+         */
+        void write(int begin, int end);
+
+        /**
+         * @brief Write each whole block of buffered values not yet written by this method before a given time step.
+         *
+         * @param end The time step after the last one whose values are all set.
+         * @param partial Whether to also write any time steps before @p end left over after the whole blocks, e.g., at
+         *                the end of the run or at a checkpoint.
+         */
+        void write_blocks(int end, bool partial);
+
+        /**
+         * @brief The number of time steps written at once, which is also the chunk size in time.
+         */
+        int get_block_steps() const {
+            return block_steps;
+        }
+
+        /**
+         * @brief Write anything the library still holds and close the file.
+         */
+        void close();
+
+        /**
+         * @brief Turn an output field name into a valid NetCDF variable name.
+         *
+         * @param field The output field name, e.g., as from a formulation's output header line.
+         * @return The field name with anything other than letters, digits and underscores replaced by underscores, and
+         *         prefixed if it would otherwise clash with the file's own names.
+         */
+        static std::string get_variable_name(const std::string &field);
+
+      private:
+
+        size_t slot(int step) const;
+
+        void write_slots(int begin, int end);
+
+        std::unique_ptr<netCDF::NcFile> file;
+        size_t catchment_count;
+        size_t nexus_count;
+        int first_step;
+        time_t first_epoch_time;
+        int interval_seconds;
+        int block_steps;
+        size_t buffer_steps;
+        /** The time step after the last one written by @ref write_blocks. */
+        int written_step;
+
+        std::vector<netCDF::NcVar> field_vars;
+        netCDF::NcVar time_var;
+        netCDF::NcVar nexus_var;
+
+        /** For each catchment, the index of the field variable of each of its output fields. */
+        std::vector<std::vector<size_t>> catchment_field_vars;
+        /** For each field variable, buffered values by time step slot, then catchment. */
+        std::vector<std::vector<double>> field_values;
+        /** Buffered nexus flows, by time step slot, then nexus. */
+        std::vector<double> nexus_flows;
+    };
+}
+
+#endif //NGEN_NETCDF_OUTPUT_HPP
+#endif //NETCDF_ACTIVE
@@ -0,0 +1,61 @@
+#ifndef NGEN_OUTPUT_PARAMS_HPP
+#define NGEN_OUTPUT_PARAMS_HPP
+
+#include <string>
+
+/**
+ * @brief The form in which the driver writes catchment and nexus output.
+ */
+enum class OutputFormat {
+    /**
+     * A CSV file per catchment (``<id>.csv``) and per nexus (``<id>_output.csv``).
+     */
+    Csv,
+    /**
+     * A single NetCDF4 file per process, holding the time series of every catchment and nexus.
+     */
+    NetCDF
+};
+
+/**
+ * @brief output_params providing configuration information for how the driver writes output.
+ *
+ * Values are read from the optional ``output`` section of the realization config.
+ */
+struct output_params
+{
+    /**
+     * The form in which output is written.
+     */
+    OutputFormat format;
+
+    /**
+     * The path of the NetCDF output file, without extension; under MPI, the process rank is appended.
+     */
+    std::string path;
+
+    /**
+     * The deflate compression level (0-9) of NetCDF output variables, with 0 for no compression.
+     */
+    unsigned int compression_level;
+
+    /**
+     * The number of time steps of NetCDF output buffered and written at a time, which is also the chunk size of
+     * variables in time, whatever the execution mode.
+     */
+    unsigned int block_timesteps;
+
+    /**
+     * Default constructor, for CSV output.
+     */
+    output_params() : format(OutputFormat::Csv), path("./ngen_output"), compression_level(1), block_timesteps(24) {}
+
+    /**
+     * @return Whether output is written as NetCDF.
+     */
+    bool is_netcdf() const {
+        return format == OutputFormat::NetCDF;
+    }
+};
+
+#endif // NGEN_OUTPUT_PARAMS_HPP
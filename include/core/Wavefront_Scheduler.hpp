@@ -0,0 +1,114 @@
+#ifndef NGEN_WAVEFRONT_SCHEDULER_HPP
+#define NGEN_WAVEFRONT_SCHEDULER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace hy_features {
+
+    /**
+     * @brief Dependency-driven scheduler advancing catchments through time as a wavefront over the network.
+     *
+     * Each unit of work is a single (catchment, time step) pair.  A catchment may run time step ``t`` once it has
+     * finished ``t - 1`` and every catchment immediately upstream of it has finished ``t``, so downstream work begins as
+     * soon as its own upstream subtree is done rather than waiting on an entire topological level, and a headwater
+     * catchment can already be working on later time steps while a downstream one is still catching up.
+     *
+     * How far ahead catchments may run is bounded by a window of time steps: nothing runs time step ``t`` until every
+     * time step before ``t - window + 1`` has been completed.  Once all catchments have finished a time step, a
+     * completion function is run for it on the calling thread, strictly in time step order and concurrently with
+     * catchments working on later time steps.  This is where coupled work, such as nexus summation and output, happens.
+     *
+     * Ready work is kept in per-thread deques: a thread runs the most recent work it made ready itself (typically the
+     * next time step of the same catchment, or the catchment just downstream), and idle threads steal the oldest work
+     * from other threads.  Catchments restricted to the main thread are only ever run by the calling thread.
+     */
+    class Wavefront_Scheduler {
+
+      public:
+
+        /**
+         * @brief Construct a scheduler for a set of catchments identified by index.
+         *
+         * @param upstream The indices of the catchments immediately upstream of each catchment, by catchment index.
+         * @param levels The topological level of each catchment, by catchment index, used to order the initial work.
+         * @param main_thread_only Whether each catchment, by catchment index, must only be run on the calling thread.
+         * @param num_threads The total number of threads to use, including the calling thread; if 0, the hardware
+         *                    concurrency is used.
+         * @param window The number of time steps catchments may be spread across at once; must be at least 1.
+         */
+        Wavefront_Scheduler(std::vector<std::vector<size_t>> upstream, const std::vector<int> &levels,
+                            std::vector<bool> main_thread_only, size_t num_threads, size_t window);
+
+        /**
+         * @return The total number of threads participating in work, including the calling thread.
+         */
+        size_t size() const {
+            return num_threads;
+        }
+
+        /**
+         * @brief Run every catchment through every time step, blocking until done.
+         *
+         * If either function throws, no further work is started, and the first exception caught is rethrown on the
+         * calling thread once all threads have stopped.
+         *
+         * A barrier time step is not started by any catchment until every earlier time step has been completed, so the
+         * completion function for the time step just before it sees every catchment stopped between time steps (e.g.,
+         * to save their state).
+         *
+         * @param total_steps The number of time steps to run.
+         * @param run_step The function to run a catchment (first argument) for a time step (second argument).
+         * @param complete_step The function to run, on the calling thread, once all catchments have run a time step.
+         * @param first_step The time step from which to start, with all earlier time steps treated as already done.
+         * @param is_barrier Optional function indicating whether a time step is a barrier.
+         */
+        void run(int total_steps, const std::function<void(size_t, int)> &run_step,
+                 const std::function<void(int)> &complete_step, int first_step = 0,
+                 const std::function<bool(int)> &is_barrier = std::function<bool(int)>());
+
+      private:
+
+        typedef std::pair<size_t, int> Task;
+
+        void worker_loop(size_t thread);
+
+        void execute(size_t thread, const Task &task, std::unique_lock<std::mutex> &lock);
+
+        bool try_schedule(size_t catchment, size_t thread);
+
+        bool take_task(size_t thread, Task &task);
+
+        void record_error(std::exception_ptr e);
+
+        std::vector<std::vector<size_t>> upstream;
+        std::vector<std::vector<size_t>> downstream;
+        std::vector<size_t> seed_order;
+        std::vector<bool> main_thread_only;
+        size_t num_threads;
+        int window;
+
+        // State of a single run, all guarded by scheduler_mutex
+        std::mutex scheduler_mutex;
+        std::condition_variable state_changed;
+        const std::function<void(size_t, int)> *run_step_func;
+        const std::function<bool(int)> *is_barrier_func;
+        int total_steps;
+        int finalized_steps;
+        std::vector<int> next_step;
+        std::vector<bool> in_flight;
+        std::vector<size_t> done_counts;
+        std::vector<size_t> window_blocked;
+        std::vector<std::deque<Task>> thread_queues;
+        std::deque<Task> main_queue;
+        bool stop;
+        std::exception_ptr first_error;
+    };
+}
+
+#endif //NGEN_WAVEFRONT_SCHEDULER_HPP
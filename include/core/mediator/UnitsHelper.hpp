@@ -15,6 +15,20 @@ class UnitsHelper {
 
     static double* convert_values(const std::string &in_units, double* values, const std::string &out_units, double* out_values, const size_t & count);
 
+    /**
+     * Get the converter between two units, for converting many values without looking it up for each one.
+     *
+     * @return The converter, or null if the units are the same and values need no conversion.
+     * @throws std::runtime_error If values cannot be converted between the units.
+     */
+    static std::shared_ptr<cv_converter> get_shared_converter(const std::string &in_units, const std::string &out_units);
+
+    /** Convert a value with a converter from @ref get_shared_converter, which is null for no conversion. */
+    static double convert_value(const cv_converter *converter, double value)
+    {
+        return converter == nullptr ? value : cv_convert_double(converter, value);
+    }
+
     private:
      
     // Theoretically thread-safe. //TODO: Test?
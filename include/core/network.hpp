@@ -238,6 +238,21 @@ namespace network {
          */
         std::vector<std::string> get_destination_ids(std::string id);
 
+        /**
+         * @brief Group the ids of features of a given @p type by their topological level
+         *
+         * The level of a feature is the length of the longest path to it from any headwater, so headwaters are level 0
+         * and every feature is on a higher level than everything upstream of it.  All features within a single level
+         * are therefore independent of each other, and may be processed concurrently once the levels before it are done.
+         *
+         * Levels that contain no features of @p type are omitted, so the result is a sequence of non-empty groups in
+         * upstream to downstream order.
+         *
+         * @param type The type of feature to group, i.e. 'cat', 'nex'
+         * @return std::vector<std::vector<std::string>> The feature ids of each level, upstream levels first
+         */
+        std::vector<std::vector<std::string>> get_topological_levels(std::string type);
+
         /**
          * @brief The number of features in the network (number of vertices)
          * 
@@ -9,6 +9,7 @@
 #include <boost/geometry/geometries/geometries.hpp>
 #include <HY_Catchment.hpp>
 #include <HY_HydroLocation.hpp>
+#include <State_Serialization.hpp>
 
 using namespace hy_features::hydrolocation;
 class HY_HydroNexus
@@ -40,6 +41,12 @@ class HY_HydroNexus
 
     /** get the units that the flows are described in */
     virtual std::string get_flow_units()=0;
+
+    /** write the flow bookkeeping of this nexus, e.g. for a checkpoint */
+    virtual void save_state(utils::State_Writer &out)=0;
+
+    /** restore flow bookkeeping written by save_state, shifting all recorded time steps by step_offset */
+    virtual void load_state(utils::State_Reader &in, time_step_t step_offset)=0;
     
     const Catchments& get_receiving_catchments() {
         return receiving_catchments;
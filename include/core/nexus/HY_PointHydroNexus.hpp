@@ -30,6 +30,10 @@ class HY_PointHydroNexus : public HY_HydroNexus
 
         void set_mintime(time_step_t);
 
+        void save_state(utils::State_Writer &out) override;
+
+        void load_state(utils::State_Reader &in, time_step_t step_offset) override;
+
     protected:
     using flows = std::pair<std::string, double>;
     using flow_vector = std::vector< flows >;
@@ -1,12 +1,22 @@
 #ifndef GRIDPOLYGON_H
 #define GRIDPOLYGON_H
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <boost/geometry.hpp>
 #include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/geometries/point_xy.hpp>
+#include <boost/geometry/geometries/polygon.hpp>
+#include <boost/geometry/geometries/multi_polygon.hpp>
 
 namespace bg = boost::geometry;
 
 typedef bg::model::d2::point_xy<double> point_t;
 typedef bg::model::polygon<point_t> polygon_type;
+typedef bg::model::multi_polygon<polygon_type> multi_polygon_type;
 
 #include <boost/array.hpp>
 #include <boost/multi_array.hpp>
@@ -15,7 +25,7 @@ typedef boost::multi_array<polygon_type, 2> polygon_grid_type;
 typedef boost::multi_array<bool, 2> bool_grid_type;
 typedef boost::multi_array<double, 2> weight_grid_type;
 
-polygon_grid_type create_ns_cells(point_t max_corner, point_t min_corner, double x_width, double y_width)
+inline polygon_grid_type create_ns_cells(point_t max_corner, point_t min_corner, double x_width, double y_width)
 {
     // get the values for the first grid cell
     double y1 = max_corner.y();
@@ -67,7 +77,7 @@ polygon_grid_type create_ns_cells(point_t max_corner, point_t min_corner, double
     return cells;
 }
 
-bool_grid_type generate_grid_mask_for_polygon(const polygon_type& poly, polygon_grid_type& grid)
+inline bool_grid_type generate_grid_mask_for_polygon(const polygon_type& poly, polygon_grid_type& grid)
 {
     const polygon_grid_type::size_type* shape = grid.shape();
 
@@ -84,7 +94,7 @@ bool_grid_type generate_grid_mask_for_polygon(const polygon_type& poly, polygon_
     return mask;
 }
 
-polygon_grid_type create_grid_for_polygon(const polygon_type& p, double x_width, double y_width )
+inline polygon_grid_type create_grid_for_polygon(const polygon_type& p, double x_width, double y_width )
 {
     bg::model::box<point_t> box;
 
@@ -93,4 +103,82 @@ polygon_grid_type create_grid_for_polygon(const polygon_type& p, double x_width,
     return create_ns_cells(box.min_corner(),box.max_corner(),x_width,y_width);
 }
 
+/**
+ * Get the cells of a regular grid that a shape overlaps, and the fraction of the overlapped area in each.
+ *
+ * Column ``c`` of the grid spans from ``x_edge + c * x_width`` to ``x_edge + (c + 1) * x_width``, and row ``r``
+ * likewise along y, so a negative width gives a grid whose coordinates decrease with the index.  The shape and grid
+ * must be in the same coordinate system.
+ *
+ * Fractions are of the part of the shape within the grid, so they sum to 1 unless the shape misses the grid entirely.
+ *
+ * @param shape The shape, which must be closed and oriented clockwise (see ``bg::correct``).
+ * @param x_edge The x coordinate of the outer edge of the first column.
+ * @param x_width The width of each column.
+ * @param x_count The number of columns.
+ * @param y_edge The y coordinate of the outer edge of the first row.
+ * @param y_width The height of each row.
+ * @param y_count The number of rows.
+ * @return Pairs of the row-major index (``r * x_count + c``) of each overlapped cell and the fraction in it.
+ */
+inline std::vector<std::pair<size_t, double>> compute_cell_area_fractions(const multi_polygon_type& shape,
+                                                                          double x_edge, double x_width, size_t x_count,
+                                                                          double y_edge, double y_width, size_t y_count)
+{
+    std::vector<std::pair<size_t, double>> fractions;
+    if (x_count == 0 || y_count == 0) {
+        return fractions;
+    }
+
+    bg::model::box<point_t> box;
+    bg::envelope(shape, box);
+
+    // The range of cell indices along one axis that the envelope covers, or false if none
+    auto cell_range = [](double low, double high, double edge, double width, size_t count, size_t &first, size_t &last) {
+        double a = std::floor((low - edge) / width);
+        double b = std::floor((high - edge) / width);
+        if (a > b) {
+            std::swap(a, b);
+        }
+        if (b < 0 || a >= (double) count) {
+            return false;
+        }
+        first = a < 0 ? 0 : (size_t) a;
+        last = std::min((size_t) b, count - 1);
+        return true;
+    };
+    size_t c_first, c_last, r_first, r_last;
+    if (!cell_range(box.min_corner().x(), box.max_corner().x(), x_edge, x_width, x_count, c_first, c_last)
+        || !cell_range(box.min_corner().y(), box.max_corner().y(), y_edge, y_width, y_count, r_first, r_last)) {
+        return fractions;
+    }
+
+    double covered_area = 0.0;
+    std::vector<polygon_type> overlap;
+    for (size_t r = r_first; r <= r_last; ++r) {
+        double y1 = y_edge + r * y_width;
+        double y2 = y1 + y_width;
+        for (size_t c = c_first; c <= c_last; ++c) {
+            double x1 = x_edge + c * x_width;
+            double x2 = x1 + x_width;
+            bg::model::box<point_t> cell(point_t(std::min(x1, x2), std::min(y1, y2)),
+                                         point_t(std::max(x1, x2), std::max(y1, y2)));
+            overlap.clear();
+            bg::intersection(cell, shape, overlap);
+            double area = 0.0;
+            for (const polygon_type &part : overlap) {
+                area += bg::area(part);
+            }
+            if (area > 0.0) {
+                fractions.emplace_back(r * x_count + c, area);
+                covered_area += area;
+            }
+        }
+    }
+    for (auto &fraction : fractions) {
+        fraction.second /= covered_area;
+    }
+    return fractions;
+}
+
 #endif // GRIDPOLYGON_H_INCLUDED
@@ -42,6 +42,14 @@ struct forcing_params
   std::string provider;
   time_t start_t;
   time_t end_t;
+  /** For providers that read forcing a chunk of time steps at a time, the time steps per chunk (0 for the default) */
+  size_t chunk_time_steps = 0;
+  /** For providers that cache chunks of forcing, the most memory in bytes the cache may use (0 for the default) */
+  size_t cache_bytes = 0;
+  /** For providers of many catchments, the number of time steps per window read ahead in the background (0 for none) */
+  size_t prefetch_time_steps = 0;
+  /** For gridded forcing, the path of the file of catchment weights for grid cells (empty for the default) */
+  std::string weights_path;
   /*
     Constructor for forcing_params
   */
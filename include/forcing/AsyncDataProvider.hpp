@@ -5,14 +5,33 @@
 
 namespace data_access
 {
+    /**
+     * A provider of data that can be read ahead of when it is needed.
+     *
+     * Values may be requested before they are used, so they can be read in the background; a later call to
+     * @ref get_value for the same selector then does not have to wait on the read.
+     */
     template <class data_type, class selection_type> class AsyncDataProvider : public DataProvider<data_type, selection_type>
     {
-        virtual bool value_ready(selection_type selector, const std::string &variable_name, const time_t &init_time, const long &duration_s,
-                                 const std::string &output_units, ReSampleMethod m=SUM) = 0;
+        public:
 
-        virtual void request_value(selection_type selector, const std::string &variable_name, const time_t &init_time, const long &duration_s,
-                                 const std::string &output_units, ReSampleMethod m=SUM) = 0;
+        /**
+         * Get whether the value for a selector has been read, so @ref get_value for it will not wait on a read.
+         *
+         * @param selector Data required to establish what subset of the stored data should be accessed
+         * @param m How data is to be resampled if there is a mismatch in data alignment or repeat rate
+         * @return Whether the value is ready.
+         */
+        virtual bool value_ready(const selection_type& selector, ReSampleMethod m=SUM) = 0;
+
+        /**
+         * Request that the value for a selector be read in the background.
+         *
+         * @param selector Data required to establish what subset of the stored data should be accessed
+         * @param m How data is to be resampled if there is a mismatch in data alignment or repeat rate
+         */
+        virtual void request_value(const selection_type& selector, ReSampleMethod m=SUM) = 0;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
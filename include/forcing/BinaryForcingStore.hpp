@@ -0,0 +1,267 @@
+#ifndef NGEN_BINARY_FORCING_STORE_HPP
+#define NGEN_BINARY_FORCING_STORE_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "AorcForcing.hpp"
+#include "GenericDataProvider.hpp"
+
+namespace data_access
+{
+    /**
+     * @brief The layout of a binary forcing store.
+     *
+     * A store holds the forcings of many catchments over one evenly spaced period of time, and is laid out as:
+     *
+     *  - a @ref Header
+     *  - the catchment ids, each as a 32-bit length followed by its characters
+     *  - the variables, each as a length-prefixed name, a length-prefixed units string, and a byte that is 1 if its
+     *    values are sums over their time step
+     *  - starting at @ref Header::data_offset, which is aligned to @ref DATA_ALIGNMENT, one block of floats per
+     *    variable in the order listed, each holding the full time series of every catchment in the order listed
+     *    (i.e., the value of catchment ``c`` at time step ``t`` is at ``c * time_count + t`` in the block)
+     *
+     * Everything is in the native byte order of the machine that wrote it, so a store is meant as a local cache of
+     * forcings rather than a format for exchanging them.
+     */
+    namespace binary_forcing_store
+    {
+        const char MAGIC[8] = {'N', 'G', 'E', 'N', 'F', 'S', 'T', '\0'};
+        const uint32_t VERSION = 1;
+        const uint64_t DATA_ALIGNMENT = 64;
+
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t variable_count;
+            uint64_t catchment_count;
+            uint64_t time_count;
+            /** The epoch time at which the first time step begins. */
+            int64_t start_time;
+            /** The duration of every time step, in seconds. */
+            int64_t time_stride;
+            uint64_t data_offset;
+        };
+
+        struct Variable
+        {
+            std::string name;
+            std::string units;
+            bool is_sum_over_time_step;
+        };
+    }
+
+    /**
+     * @brief Writer of a @ref binary_forcing_store file.
+     *
+     * The header and tables are written when the writer is created, and the file is sized to hold every value, so
+     * the series of each catchment can then be written in any order as it is read from its source.
+     */
+    class BinaryForcingStoreWriter
+    {
+        public:
+
+        /**
+         * @brief Create a store file, replacing any existing file at the path.
+         *
+         * @param path The path of the store file.
+         * @param catchment_ids The catchments the store will hold.
+         * @param variables The variables the store will hold for each catchment.
+         * @param start_time The epoch time at which the first time step begins.
+         * @param time_stride The duration of each time step, in seconds.
+         * @param time_count The number of time steps.
+         */
+        BinaryForcingStoreWriter(const std::string &path, const std::vector<std::string> &catchment_ids,
+                                 const std::vector<binary_forcing_store::Variable> &variables, time_t start_time,
+                                 time_t time_stride, size_t time_count)
+            : path(path), catchment_ids(catchment_ids), variables(variables), start_time(start_time),
+              time_stride(time_stride), time_count(time_count)
+        {
+            if (time_stride <= 0 || time_count == 0) {
+                throw std::runtime_error("Cannot write forcing store " + path + " without any time steps.");
+            }
+            for (size_t i = 0; i < catchment_ids.size(); ++i) {
+                catchment_positions[catchment_ids[i]] = i;
+            }
+
+            std::vector<char> tables;
+            for (const std::string &id : catchment_ids) {
+                append_string(tables, id);
+            }
+            for (const auto &variable : variables) {
+                append_string(tables, variable.name);
+                append_string(tables, variable.units);
+                tables.push_back(variable.is_sum_over_time_step ? 1 : 0);
+            }
+
+            binary_forcing_store::Header header;
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic, binary_forcing_store::MAGIC, sizeof(header.magic));
+            header.version = binary_forcing_store::VERSION;
+            header.variable_count = variables.size();
+            header.catchment_count = catchment_ids.size();
+            header.time_count = time_count;
+            header.start_time = start_time;
+            header.time_stride = time_stride;
+            const uint64_t tables_end = sizeof(header) + tables.size();
+            header.data_offset = (tables_end + binary_forcing_store::DATA_ALIGNMENT - 1)
+                                 / binary_forcing_store::DATA_ALIGNMENT * binary_forcing_store::DATA_ALIGNMENT;
+            data_offset = header.data_offset;
+
+            fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                throw std::runtime_error("Could not create forcing store " + path + ": " + std::strerror(errno));
+            }
+            const uint64_t file_size = data_offset
+                                       + (uint64_t) variables.size() * catchment_ids.size() * time_count * sizeof(float);
+            if (ftruncate(fd, file_size) != 0) {
+                fail("size");
+            }
+            write_at(&header, sizeof(header), 0);
+            write_at(tables.data(), tables.size(), sizeof(header));
+        }
+
+        ~BinaryForcingStoreWriter()
+        {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+
+        BinaryForcingStoreWriter(const BinaryForcingStoreWriter&) = delete;
+        BinaryForcingStoreWriter& operator=(const BinaryForcingStoreWriter&) = delete;
+
+        /**
+         * @brief Get the variables that a provider offers, in the form to store them.
+         *
+         * Variables with several names (i.e., those in @ref WellKnownFields) are stored once, under their CSDMS
+         * standard name.  Values are stored in the units the provider holds them in, or, if it does not know them,
+         * those given in @ref WellKnownFields.
+         *
+         * @param provider A provider of forcings.
+         * @return The distinct variables of the provider.
+         */
+        static std::vector<binary_forcing_store::Variable> get_provider_variables(GenericDataProvider &provider)
+        {
+            std::vector<binary_forcing_store::Variable> variables;
+            std::set<std::string> seen;
+            for (const std::string &name : provider.get_avaliable_variable_names()) {
+                std::string canonical_name = name;
+                std::string units = provider.get_variable_units(name);
+                auto wkf = WellKnownFields.find(name);
+                if (wkf != WellKnownFields.end()) {
+                    canonical_name = std::get<0>(wkf->second);
+                    units = units.empty() ? std::get<1>(wkf->second) : units;
+                }
+                else if (units.empty()) {
+                    for (const auto &field : WellKnownFields) {
+                        if (std::get<0>(field.second) == name) {
+                            units = std::get<1>(field.second);
+                            break;
+                        }
+                    }
+                }
+                if (seen.insert(canonical_name).second) {
+                    variables.push_back({canonical_name, units, provider.is_property_sum_over_time_step(canonical_name)});
+                }
+            }
+            return variables;
+        }
+
+        /**
+         * @brief Read the series of every variable of a catchment from a provider and write them to the store.
+         *
+         * @param catchment_id The id of the catchment, which must be one the store was created with.
+         * @param provider The provider to read the catchment's forcings from.
+         */
+        void write_catchment(const std::string &catchment_id, GenericDataProvider &provider)
+        {
+            auto position = catchment_positions.find(catchment_id);
+            if (position == catchment_positions.end()) {
+                throw std::runtime_error("Catchment " + catchment_id + " is not in forcing store " + path);
+            }
+            std::vector<std::string> names, units;
+            std::vector<ReSampleMethod> methods;
+            for (const auto &variable : variables) {
+                names.push_back(variable.name);
+                units.push_back(variable.units);
+                methods.push_back(variable.is_sum_over_time_step ? SUM : MEAN);
+            }
+            BatchPlan plan = provider.prepare_batch({catchment_id}, names, units, methods);
+
+            // Read every variable of each time step at once, into a series per variable
+            std::vector<double> values(plan.size());
+            std::vector<float> series(variables.size() * time_count);
+            for (size_t t = 0; t < time_count; ++t) {
+                provider.get_batch_values(plan, start_time + t * time_stride, time_stride, values.data());
+                for (size_t v = 0; v < variables.size(); ++v) {
+                    series[v * time_count + t] = (float) values[v];
+                }
+            }
+            for (size_t v = 0; v < variables.size(); ++v) {
+                const uint64_t offset = data_offset
+                        + ((uint64_t) v * catchment_ids.size() + position->second) * time_count * sizeof(float);
+                write_at(series.data() + v * time_count, time_count * sizeof(float), offset);
+            }
+        }
+
+        private:
+
+        static void append_string(std::vector<char> &buffer, const std::string &value)
+        {
+            const uint32_t length = value.size();
+            const char *length_bytes = reinterpret_cast<const char*>(&length);
+            buffer.insert(buffer.end(), length_bytes, length_bytes + sizeof(length));
+            buffer.insert(buffer.end(), value.begin(), value.end());
+        }
+
+        void write_at(const void *data, size_t size, uint64_t offset)
+        {
+            const char *bytes = static_cast<const char*>(data);
+            while (size > 0) {
+                ssize_t written = pwrite(fd, bytes, size, offset);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    fail("write");
+                }
+                bytes += written;
+                size -= written;
+                offset += written;
+            }
+        }
+
+        void fail(const std::string &action)
+        {
+            std::string message = "Could not " + action + " forcing store " + path + ": " + std::strerror(errno);
+            close(fd);
+            fd = -1;
+            throw std::runtime_error(message);
+        }
+
+        std::string path;
+        std::vector<std::string> catchment_ids;
+        std::map<std::string, size_t> catchment_positions;
+        std::vector<binary_forcing_store::Variable> variables;
+        time_t start_time;
+        time_t time_stride;
+        size_t time_count;
+        uint64_t data_offset;
+        int fd = -1;
+    };
+}
+
+#endif // NGEN_BINARY_FORCING_STORE_HPP
@@ -0,0 +1,378 @@
+#ifndef NGEN_BINARY_FORCING_STORE_PROVIDER_HPP
+#define NGEN_BINARY_FORCING_STORE_PROVIDER_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "AorcForcing.hpp"
+#include "BinaryForcingStore.hpp"
+#include "GenericDataProvider.hpp"
+#include <UnitsHelper.hpp>
+
+namespace data_access
+{
+    /**
+     * @brief Provider of forcings from a @ref binary_forcing_store file.
+     *
+     * The store is memory mapped, and values are read straight from the mapping, so opening a store costs little more
+     * than reading its tables, and one provider can serve every catchment in the store, from any number of threads.
+     */
+    class BinaryForcingStoreProvider : public GenericDataProvider
+    {
+        public:
+
+        /**
+         * @brief Factory method that creates or returns an existing provider for the store at the given path.
+         *
+         * @param path The path of the store file.
+         * @return A provider for the store.
+         */
+        static std::shared_ptr<BinaryForcingStoreProvider> get_shared_provider(const std::string &path)
+        {
+            static std::mutex shared_providers_mutex;
+            static std::map<std::string, std::weak_ptr<BinaryForcingStoreProvider>> shared_providers;
+
+            const std::lock_guard<std::mutex> lock(shared_providers_mutex);
+            std::shared_ptr<BinaryForcingStoreProvider> p = shared_providers[path].lock();
+            if (p == nullptr) {
+                p = std::make_shared<BinaryForcingStoreProvider>(path);
+                shared_providers[path] = p;
+            }
+            return p;
+        }
+
+        explicit BinaryForcingStoreProvider(const std::string &path) : path(path)
+        {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error("Could not open forcing store " + path + ": " + std::strerror(errno));
+            }
+            struct stat info;
+            if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(binary_forcing_store::Header)) {
+                close(fd);
+                throw std::runtime_error("Forcing store " + path + " is too small to be a forcing store.");
+            }
+            mapping_size = info.st_size;
+            void *mapped = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+            if (mapped == MAP_FAILED) {
+                throw std::runtime_error("Could not map forcing store " + path + ": " + std::strerror(errno));
+            }
+            mapping = static_cast<const char*>(mapped);
+
+            try {
+                read_tables();
+            }
+            catch (...) {
+                munmap(const_cast<char*>(mapping), mapping_size);
+                throw;
+            }
+        }
+
+        ~BinaryForcingStoreProvider() override
+        {
+            munmap(const_cast<char*>(mapping), mapping_size);
+        }
+
+        BinaryForcingStoreProvider(const BinaryForcingStoreProvider&) = delete;
+        BinaryForcingStoreProvider& operator=(const BinaryForcingStoreProvider&) = delete;
+
+        const std::vector<std::string> &get_avaliable_variable_names() override
+        {
+            return variable_names;
+        }
+
+        /** Return the ids of the catchments in the store */
+        const std::vector<std::string> &get_ids() const
+        {
+            return catchment_ids;
+        }
+
+        long get_data_start_time() override
+        {
+            return header.start_time;
+        }
+
+        long get_data_stop_time() override
+        {
+            return header.start_time + header.time_count * header.time_stride;
+        }
+
+        long record_duration() override
+        {
+            return header.time_stride;
+        }
+
+        /**
+         * Get the index of the forcing time step that contains the given point in time.
+         *
+         * @param epoch_time The point in time, as a seconds-based epoch time.
+         * @return The index of the forcing time step that contains the given point in time.
+         * @throws std::out_of_range If the given point is not in any time step.
+         */
+        size_t get_ts_index_for_time(const time_t &epoch_time) override
+        {
+            if (epoch_time < get_data_start_time() || epoch_time >= get_data_stop_time()) {
+                throw std::out_of_range("Forcing store " + path + " has no time step for time "
+                                        + std::to_string(epoch_time));
+            }
+            return (epoch_time - header.start_time) / header.time_stride;
+        }
+
+        /**
+         * Get the value of a forcing property for an arbitrary time period, converting units if needed.
+         *
+         * Each time step overlapping the period contributes in proportion to the overlap: values that are sums over
+         * their time step are summed, and others are averaged over the period.  Any part of the period past the end
+         * of the store takes the value of the last time step.
+         *
+         * @param selector Object storing information about the data to be queried
+         * @param m Unused, as how values combine is stored with each variable
+         * @return The value of the forcing property for the described time period, with units converted if needed.
+         * @throws std::out_of_range If data for the time period is not available.
+         */
+        double get_value(const CatchmentAggrDataSelector& selector, ReSampleMethod m) override
+        {
+            const size_t v = get_variable_index(selector.get_variable_name());
+            const double value = get_raw_value(get_series(v, get_catchment_index(selector.get_id())),
+                                               variables[v].is_sum_over_time_step, selector.get_init_time(),
+                                               selector.get_duration_secs());
+
+            try {
+                return UnitsHelper::get_converted_value(variables[v].units, value, selector.get_output_units());
+            }
+            catch (const std::runtime_error& e) {
+                #ifndef UDUNITS_QUIET
+                std::cerr<<"WARN: Unit conversion unsuccessful - Returning unconverted value! (\""<<e.what()<<"\")"<<std::endl;
+                #endif
+                return value;
+            }
+        }
+
+        /**
+         * Bind a catchment, variable and output units to a handle, resolving its series and units conversion once.
+         *
+         * @param id The catchment to read values for.
+         * @param variable_name The variable to read values of.
+         * @param output_units The units to convert values to.
+         * @param m Unused, as how values combine is stored with each variable
+         * @return The handle, for use with @ref get_bound_value.
+         * @throws std::runtime_error If the store has no such catchment or variable.
+         */
+        value_handle_t bind_value(const std::string &id, const std::string &variable_name,
+                                  const std::string &output_units, ReSampleMethod m) override
+        {
+            const size_t v = get_variable_index(variable_name);
+            BoundValue bound;
+            bound.series = get_series(v, get_catchment_index(id));
+            bound.is_sum_over_time_step = variables[v].is_sum_over_time_step;
+            try {
+                bound.converter = UnitsHelper::get_shared_converter(variables[v].units, output_units);
+            }
+            catch (const std::runtime_error& e) {
+                #ifndef UDUNITS_QUIET
+                std::cerr<<"WARN: Unit conversion unsuccessful - Returning unconverted values! (\""<<e.what()<<"\")"<<std::endl;
+                #endif
+            }
+            bound_values.push_back(bound);
+            return bound_values.size() - 1;
+        }
+
+        double get_bound_value(value_handle_t handle, time_t init_time, long duration_s) override
+        {
+            const BoundValue &bound = bound_values[handle];
+            return UnitsHelper::convert_value(bound.converter.get(),
+                                              get_raw_value(bound.series, bound.is_sum_over_time_step, init_time, duration_s));
+        }
+
+        std::vector<double> get_values(const CatchmentAggrDataSelector& selector, ReSampleMethod m) override
+        {
+            return std::vector<double>(1, get_value(selector, m));
+        }
+
+        bool is_property_sum_over_time_step(const std::string& name) override
+        {
+            auto v = variable_indices.find(name);
+            return v != variable_indices.end() && variables[v->second].is_sum_over_time_step;
+        }
+
+        std::string get_variable_units(const std::string &variable_name) override
+        {
+            auto v = variable_indices.find(variable_name);
+            return v == variable_indices.end() ? "" : variables[v->second].units;
+        }
+
+        private:
+
+        /** A series and units conversion bound to a handle. */
+        struct BoundValue
+        {
+            const float *series;
+            bool is_sum_over_time_step;
+            std::shared_ptr<cv_converter> converter;
+        };
+
+        /**
+         * Get the value of a series for an arbitrary time period, in its native units.
+         *
+         * @param series The series of a variable for a catchment.
+         * @param is_sum_over_time_step Whether the variable's values are sums over their time step.
+         * @param init_time The epoch time (in seconds) of the start of the time period.
+         * @param duration The length of the time period, in seconds.
+         * @return The value for the described time period.
+         * @throws std::out_of_range If data for the time period is not available.
+         */
+        double get_raw_value(const float *series, bool is_sum_over_time_step, time_t init_time, long duration)
+        {
+            size_t index;
+            try {
+                index = get_ts_index_for_time(init_time);
+            }
+            catch (const std::out_of_range &e) {
+                throw std::out_of_range("Forcing store " + path + " had bad init_time " + std::to_string(init_time)
+                                        + " for value request");
+            }
+
+            const time_t stop_time = init_time + duration;
+            double value = 0.0;
+            for (time_t ts_start = header.start_time + index * header.time_stride; ts_start < stop_time;
+                 ts_start += header.time_stride, ++index) {
+                const double involved_s = std::min<time_t>(stop_time, ts_start + header.time_stride)
+                                          - std::max<time_t>(init_time, ts_start);
+                const double ts_value = series[std::min<size_t>(index, header.time_count - 1)];
+                if (is_sum_over_time_step) {
+                    value += ts_value * (involved_s / header.time_stride);
+                }
+                else {
+                    value += ts_value * (involved_s / duration);
+                }
+            }
+            return value;
+        }
+
+        void read_tables()
+        {
+            std::memcpy(&header, mapping, sizeof(header));
+            if (std::memcmp(header.magic, binary_forcing_store::MAGIC, sizeof(header.magic)) != 0) {
+                throw std::runtime_error(path + " is not a forcing store.");
+            }
+            if (header.version != binary_forcing_store::VERSION) {
+                throw std::runtime_error("Forcing store " + path + " has unsupported version "
+                                         + std::to_string(header.version));
+            }
+            if (header.time_stride <= 0 || header.time_count == 0
+                || header.data_offset % binary_forcing_store::DATA_ALIGNMENT != 0
+                || header.data_offset + (uint64_t) header.variable_count * header.catchment_count * header.time_count
+                                        * sizeof(float) > mapping_size) {
+                throw std::runtime_error("Forcing store " + path + " is truncated or corrupt.");
+            }
+
+            const char *position = mapping + sizeof(header);
+            const char *tables_end = mapping + header.data_offset;
+            for (uint64_t c = 0; c < header.catchment_count; ++c) {
+                catchment_ids.push_back(read_string(position, tables_end));
+                catchment_indices[catchment_ids.back()] = c;
+            }
+            for (uint32_t v = 0; v < header.variable_count; ++v) {
+                binary_forcing_store::Variable variable;
+                variable.name = read_string(position, tables_end);
+                variable.units = read_string(position, tables_end);
+                if (position >= tables_end) {
+                    throw std::runtime_error("Forcing store " + path + " is truncated or corrupt.");
+                }
+                variable.is_sum_over_time_step = *position++ != 0;
+                variables.push_back(variable);
+                add_variable_name(variable.name, v);
+            }
+            // Also allow lookup by the other names of well known fields
+            for (const auto &field : WellKnownFields) {
+                auto v = variable_indices.find(std::get<0>(field.second));
+                if (v != variable_indices.end()) {
+                    add_variable_name(field.first, v->second);
+                }
+            }
+        }
+
+        std::string read_string(const char *&position, const char *end)
+        {
+            uint32_t length;
+            if (end - position < (ptrdiff_t) sizeof(length)) {
+                throw std::runtime_error("Forcing store " + path + " is truncated or corrupt.");
+            }
+            std::memcpy(&length, position, sizeof(length));
+            position += sizeof(length);
+            if ((uint64_t) (end - position) < length) {
+                throw std::runtime_error("Forcing store " + path + " is truncated or corrupt.");
+            }
+            std::string value(position, length);
+            position += length;
+            return value;
+        }
+
+        void add_variable_name(const std::string &name, size_t index)
+        {
+            if (variable_indices.emplace(name, index).second) {
+                variable_names.push_back(name);
+            }
+        }
+
+        size_t get_variable_index(const std::string &name) const
+        {
+            auto v = variable_indices.find(name);
+            if (v == variable_indices.end()) {
+                throw std::runtime_error("Forcing store " + path + " has no variable '" + name + "'.");
+            }
+            return v->second;
+        }
+
+        size_t get_catchment_index(const std::string &id) const
+        {
+            // Selectors that name no catchment can still be used with a store of a single catchment
+            if (id.empty() && catchment_ids.size() == 1) {
+                return 0;
+            }
+            auto c = catchment_indices.find(id);
+            if (c == catchment_indices.end()) {
+                throw std::runtime_error("Forcing store " + path + " has no catchment '" + id + "'.");
+            }
+            return c->second;
+        }
+
+        const float *get_series(size_t variable_index, size_t catchment_index) const
+        {
+            return reinterpret_cast<const float*>(mapping + header.data_offset)
+                   + (variable_index * header.catchment_count + catchment_index) * header.time_count;
+        }
+
+        std::string path;
+        const char *mapping = nullptr;
+        size_t mapping_size = 0;
+        binary_forcing_store::Header header;
+
+        std::vector<std::string> catchment_ids;
+        std::unordered_map<std::string, size_t> catchment_indices;
+        std::vector<binary_forcing_store::Variable> variables;
+        std::vector<std::string> variable_names;
+        std::unordered_map<std::string, size_t> variable_indices;
+        /** Values bound by @ref bind_value, by handle. */
+        std::deque<BoundValue> bound_values;
+    };
+}
+
+#endif // NGEN_BINARY_FORCING_STORE_PROVIDER_HPP
@@ -2,6 +2,7 @@
 #define NGEN_CSVPERFEATUREFORCING_H
 
 #include <vector>
+#include <deque>
 #include <set>
 #include <cmath>
 #include <algorithm>
@@ -9,9 +10,12 @@
 #include <fstream>
 #include <iostream>
 #include <unordered_map>
+#include <map>
+#include <mutex>
+#include <cstdlib>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
-#include "CSV_Reader.h"
+#include "Mapped_CSV_Reader.hpp"
 #include <ctime>
 #include <time.h>
 #include <memory>
@@ -39,6 +43,36 @@ class CsvPerFeatureForcingProvider : public data_access::GenericDataProvider
         read_csv(forcing_config.path);
     }
 
+    /**
+     * @brief Factory method that creates or returns an existing provider for the given forcing file and time period.
+     *
+     * Providers are keyed by the canonical path of the file along with the model start and end times, so catchments
+     * configured with the same forcing file share one provider, and the file is read and stored only once.  Providers
+     * are only read from once constructed, so it is safe for several formulations to query one concurrently.  A
+     * provider is kept only as long as something else holds it.
+     *
+     * @param forcing_config The forcing configuration of the provider.
+     * @return A provider for the configured forcing file and time period.
+     */
+    static std::shared_ptr<CsvPerFeatureForcingProvider> get_shared_provider(const forcing_params &forcing_config)
+    {
+        char *resolved = realpath(forcing_config.path.c_str(), nullptr);
+        std::string key = resolved != nullptr ? resolved : forcing_config.path;
+        free(resolved);
+        key += "|" + std::to_string(forcing_config.start_t) + "|" + std::to_string(forcing_config.end_t);
+
+        static std::mutex shared_providers_mutex;
+        static std::map<std::string, std::weak_ptr<CsvPerFeatureForcingProvider>> shared_providers;
+
+        const std::lock_guard<std::mutex> lock(shared_providers_mutex);
+        std::shared_ptr<CsvPerFeatureForcingProvider> p = shared_providers[key].lock();
+        if (p == nullptr) {
+            p = std::make_shared<CsvPerFeatureForcingProvider>(forcing_config);
+            shared_providers[key] = p;
+        }
+        return p;
+    }
+
     // BEGIN DataProvider interface methods
 
     /**
@@ -65,7 +99,7 @@ class CsvPerFeatureForcingProvider : public data_access::GenericDataProvider
      * @return The duration of one record of this forcing source
      */
     long record_duration() override {
-        return time_epoch_vector[1] - time_epoch_vector[0];
+        return get_ts_duration(0);
     }
 
     /**
@@ -81,22 +115,17 @@ class CsvPerFeatureForcingProvider : public data_access::GenericDataProvider
         if (epoch_time < start_date_time_epoch) {
             throw std::out_of_range("Forcing had bad pre-start time for index query: " + std::to_string(epoch_time));
         }
-        size_t i = 0;
-        // 1 hour
-        time_t seconds_in_time_step = 3600;
-        time_t time = start_date_time_epoch;
-        while (epoch_time >= time + seconds_in_time_step && time < end_date_time_epoch) {
-           i++;
-           time += seconds_in_time_step;
+        if (time_epoch_vector.empty() || epoch_time < time_epoch_vector[0]) {
+            return 0;
         }
-        // The end_date_time_epoch is the epoch value of the BEGINNING of the last time step, not its end.
-        // I.e., to make sure we cover it, we have to go another time step beyond.
-        if (time >= end_date_time_epoch + 3600) {
-            throw std::out_of_range("Forcing had bad beyond-end time for index query: " + std::to_string(epoch_time));
-        }
-        else {
-            return i;
+        // Times past the end of the model period fall in the last time step.
+        if (record_stride > 0) {
+            size_t i = (epoch_time - time_epoch_vector[0]) / record_stride;
+            return std::min(i, last_ts_index);
         }
+        // Irregular series: the last time step beginning at or before the time
+        auto next = std::upper_bound(time_epoch_vector.begin(), time_epoch_vector.end(), epoch_time);
+        return std::min((size_t) (next - time_epoch_vector.begin()) - 1, last_ts_index);
     }
 
     /**
@@ -111,62 +140,62 @@ class CsvPerFeatureForcingProvider : public data_access::GenericDataProvider
      */
     double get_value(const CatchmentAggrDataSelector& selector, data_access::ReSampleMethod m) override
     {
-        size_t current_index;
-        long time_remaining = selector.get_duration_secs();
-        auto init_time = selector.get_init_time();
         auto output_name = selector.get_variable_name();
-        auto output_units = selector.get_output_units();
+        double value = get_raw_value(get_forcing_vector(output_name), is_param_sum_over_time_step(output_name),
+                                     selector.get_init_time(), selector.get_duration_secs());
 
+        // Convert units
         try {
-            current_index = get_ts_index_for_time(init_time);
-        }
-        catch (const std::out_of_range &e) {
-            throw std::out_of_range("Forcing had bad init_time " + std::to_string(init_time) + " for value request");
+            // Avoid inserting into the map, since the provider may be shared across threads
+            auto units = available_forcings_units.find(output_name);
+            return UnitsHelper::get_converted_value(units == available_forcings_units.end() ? "" : units->second,
+                                                    value, selector.get_output_units());
         }
-
-        std::vector<double> involved_time_step_values;
-
-        std::vector<long> involved_time_step_seconds;
-        long ts_involved_s;
-
-        time_t first_time_step_start_epoch = start_date_time_epoch + (current_index * 3600);
-        // Handle the first time step differently, since we need to do more to figure out how many seconds came from it
-        // Total time step size minus the offset of the beginning, before the init time
-        ts_involved_s = 3600 - (init_time - first_time_step_start_epoch);
-
-        involved_time_step_seconds.push_back(ts_involved_s);
-        involved_time_step_values.push_back(get_value_for_param_name(output_name, current_index));
-        time_remaining -= ts_involved_s;
-        current_index++;
-
-        while (time_remaining > 0) {
-            if(current_index >= time_epoch_vector.size())
-                return involved_time_step_values[involved_time_step_values.size()-1]; //TODO: Is this the right answer? Is returning any value off the end of the range valid?
-            ts_involved_s = time_remaining > 3600 ? 3600 : time_remaining;
-            involved_time_step_seconds.push_back(ts_involved_s);
-            involved_time_step_values.push_back(get_value_for_param_name(output_name, current_index));
-            time_remaining -= ts_involved_s;
-            current_index++;
-
-        }
-        double value = 0;
-        for (size_t i = 0; i < involved_time_step_values.size(); ++i) {
-            if (is_param_sum_over_time_step(output_name))
-                value += involved_time_step_values[i] * ((double)involved_time_step_seconds[i] / 3600.0);
-            else
-                value += involved_time_step_values[i] * ((double)involved_time_step_seconds[i] / (double)selector.get_duration_secs());
+        catch (const std::runtime_error& e){
+            #ifndef UDUNITS_QUIET
+            std::cerr<<"WARN: Unit conversion unsuccessful - Returning unconverted value! (\""<<e.what()<<"\")"<<std::endl;
+            #endif
+            return value;
         }
+    }
 
-        // Convert units
+    /**
+     * Bind a forcing property and output units to a handle, resolving its values and units conversion once.
+     *
+     * The catchment id is ignored, as the provider has the forcings of a single catchment.
+     *
+     * @param id Unused.
+     * @param variable_name The name of the forcing property.
+     * @param output_units The units to convert values to.
+     * @param m Unused, as how values combine depends on the property.
+     * @return The handle, for use with @ref get_bound_value.
+     * @throws std::runtime_error If the property is not recognized.
+     */
+    data_access::value_handle_t bind_value(const std::string &id, const std::string &variable_name,
+                                           const std::string &output_units, data_access::ReSampleMethod m) override
+    {
+        BoundValue bound;
+        bound.series = &get_forcing_vector(variable_name);
+        bound.is_sum_over_time_step = is_param_sum_over_time_step(variable_name);
+        auto units = available_forcings_units.find(variable_name);
         try {
-            return UnitsHelper::get_converted_value(available_forcings_units[output_name], value, output_units);
+            bound.converter = UnitsHelper::get_shared_converter(units == available_forcings_units.end() ? "" : units->second,
+                                                                output_units);
         }
         catch (const std::runtime_error& e){
             #ifndef UDUNITS_QUIET
-            std::cerr<<"WARN: Unit conversion unsuccessful - Returning unconverted value! (\""<<e.what()<<"\")"<<std::endl;
+            std::cerr<<"WARN: Unit conversion unsuccessful - Returning unconverted values! (\""<<e.what()<<"\")"<<std::endl;
             #endif
-            return value;
         }
+        bound_values.push_back(bound);
+        return bound_values.size() - 1;
+    }
+
+    double get_bound_value(data_access::value_handle_t handle, time_t init_time, long duration_s) override
+    {
+        const BoundValue &bound = bound_values[handle];
+        return UnitsHelper::convert_value(bound.converter.get(),
+                                          get_raw_value(*bound.series, bound.is_sum_over_time_step, init_time, duration_s));
     }
 
     virtual std::vector<double> get_values(const CatchmentAggrDataSelector& selector, data_access::ReSampleMethod m) override
@@ -224,6 +253,11 @@ class CsvPerFeatureForcingProvider : public data_access::GenericDataProvider
         return available_forcings;
     }
 
+    std::string get_variable_units(const std::string &variable_name) override {
+        auto units = available_forcings_units.find(variable_name);
+        return units == available_forcings_units.end() ? "" : units->second;
+    }
+
     private:
 
     /**
@@ -252,34 +286,83 @@ class CsvPerFeatureForcingProvider : public data_access::GenericDataProvider
     }
 
     /**
-     * Get the current value of a forcing param identified by its name.
+     * Get the values of a forcing param identified by its name.
      *
-     * @param name The name of the forcing param for which the current value is desired.
-     * @param index The index of the desired forcing time step from which to obtain the value.
-     * @return The particular param's value at the given forcing time step.
+     * @param name The name of the forcing param, or another name for it in @ref data_access::WellKnownFields.
+     * @return The param's values, by forcing time step.
+     * @throws std::runtime_error If the param is not recognized.
      */
-    inline double get_value_for_param_name(const std::string& name, int index) {
-        if (index >= time_epoch_vector.size() ) {
-            throw std::out_of_range("Forcing had bad index " + std::to_string(index) + " for value lookup of " + name);
-        }
-
+    const std::vector<double>& get_forcing_vector(const std::string& name) {
         std::string can_name = name;
-        if(data_access::WellKnownFields.count(can_name) > 0){
-            auto t = data_access::WellKnownFields.find(can_name)->second;
-            can_name = std::get<0>(t);
+        auto wkf = data_access::WellKnownFields.find(can_name);
+        if (wkf != data_access::WellKnownFields.end()) {
+            can_name = std::get<0>(wkf->second);
         }
 
-        if (forcing_vectors.count(can_name) > 0) {
-            return forcing_vectors[can_name].at(index);
+        auto forcing_vector = forcing_vectors.find(can_name);
+        if (forcing_vector != forcing_vectors.end()) {
+            return forcing_vector->second;
         }
         else {
             throw std::runtime_error("Cannot get forcing value for unrecognized parameter name '" + name + "'.");
         }
     }
 
+    /**
+     * Get the value of a forcing param for an arbitrary time period, in its native units.
+     *
+     * @param series The param's values, by forcing time step.
+     * @param is_sum_over_time_step Whether the param's value is an aggregate sum over each time step.
+     * @param init_time The epoch time (in seconds) of the start of the time period.
+     * @param duration_s The length of the time period, in seconds.
+     * @return The value of the param for the described time period.
+     * @throws std::out_of_range If data for the time period is not available.
+     */
+    double get_raw_value(const std::vector<double>& series, bool is_sum_over_time_step, time_t init_time, long duration_s)
+    {
+        size_t current_index;
+        long time_remaining = duration_s;
+
+        try {
+            current_index = get_ts_index_for_time(init_time);
+        }
+        catch (const std::out_of_range &e) {
+            throw std::out_of_range("Forcing had bad init_time " + std::to_string(init_time) + " for value request");
+        }
+        if (current_index >= series.size()) {
+            throw std::out_of_range("Forcing had bad index " + std::to_string(current_index) + " for value lookup");
+        }
+
+        // Handle the first time step differently, since we need to do more to figure out how many seconds came from it
+        // Total time step size minus the offset of the beginning, before the init time
+        long ts_duration = get_ts_duration(current_index);
+        long ts_involved_s = ts_duration - (init_time - get_ts_start_time(current_index));
+        double value = 0;
+        while (true) {
+            if (is_sum_over_time_step)
+                value += series[current_index] * ((double)ts_involved_s / (double)ts_duration);
+            else
+                value += series[current_index] * ((double)ts_involved_s / (double)duration_s);
+            time_remaining -= ts_involved_s;
+            current_index++;
+            if (time_remaining <= 0) {
+                return value;
+            }
+            if (current_index >= series.size()) {
+                //TODO: Is this the right answer? Is returning any value off the end of the range valid?
+                return series.back();
+            }
+            ts_duration = get_ts_duration(current_index);
+            ts_involved_s = time_remaining > ts_duration ? ts_duration : time_remaining;
+        }
+    }
+
     /**
      * @brief Read Forcing Data from CSV
      * Reads only data within the specified model start and end date-times.
+     *
+     * The file is memory mapped and parsed in place, converting each value straight into its column vector.  Only the
+     * timestamp of rows outside the model period is parsed.
      * @param file_name Forcing file name
      */
     void read_csv(std::string file_name)
@@ -288,15 +371,17 @@ class CsvPerFeatureForcingProvider : public data_access::GenericDataProvider
         //std::map<std::string, int> col_indices;
         std::vector<std::vector<double>*> local_valvec_index = {};
 
-        //Call CSVReader constuctor
-        CSVReader reader(file_name);
+        Mapped_CSV_Reader reader(file_name);
+        std::vector<Mapped_CSV_Reader::Field> row;
 
-        //Get the data from CSV File
-        std::vector<std::vector<std::string> > data_list = reader.getData();
+        if (!reader.next_row(row)) {
+            throw std::runtime_error("Error: Forcing data " + file_name + " is empty.");
+        }
 
         // Process the header (first) row..
         int col_num = 0;
-        for (const auto& col_head : data_list[0]){
+        for (const auto& col_field : row){
+            std::string col_head = col_field.str();
             //std::cerr << s << std::endl;
             if(col_head == "Time" || col_head == "time"){
                 time_col_index = col_num;
@@ -326,18 +411,20 @@ class CsvPerFeatureForcingProvider : public data_access::GenericDataProvider
         time_t current_row_date_time_epoch;
         //Iterate through CSV starting on the second row
         int i = 1;
-        for (i = 1; i < data_list.size(); i++)
+        for (i = 1; reader.next_row(row); i++)
         {
-            //Row vector
-            std::vector<std::string>& vec = data_list[i];
+            if (row.size() != local_valvec_index.size()) {
+                throw std::runtime_error("Error: Forcing data " + file_name + " line "
+                                         + std::to_string(reader.get_line_number()) + " has " + std::to_string(row.size())
+                                         + " columns, but its header has " + std::to_string(local_valvec_index.size()));
+            }
 
-            struct tm current_row_date_time_utc = tm();
-            std::string time_str = vec[time_col_index];
             //TODO: Support more time string formats? This is basically ISO8601 but not complete, support TZ?
-            strptime(time_str.c_str(), "%Y-%m-%d %H:%M:%S", &current_row_date_time_utc);
-
-            //Convert current row date-time UTC to epoch time
-            current_row_date_time_epoch = timegm(&current_row_date_time_utc);
+            if (!Mapped_CSV_Reader::parse_timestamp(row[time_col_index], current_row_date_time_epoch)) {
+                throw std::runtime_error("Error: Forcing data " + file_name + " line "
+                                         + std::to_string(reader.get_line_number()) + " has invalid time '"
+                                         + row[time_col_index].str() + "'");
+            }
 
             //TODO: I am not sure this is a concern of this object. If forcing is retrieved that doesn't cover the
             //needed time period, isn't that the requester's concern? (Methods exist to check this...)
@@ -349,21 +436,32 @@ class CsvPerFeatureForcingProvider : public data_access::GenericDataProvider
                 
                 char tm_buff[128];
                 strftime(tm_buff, 128, "%Y-%m-%d %H:%M:%S", &start_date_tm);
-                throw std::runtime_error("Error: Forcing data " + file_name + " begins after the model start time:" + std::string(tm_buff) + " < " + time_str);
+                throw std::runtime_error("Error: Forcing data " + file_name + " begins after the model start time:" + std::string(tm_buff) + " < " + row[time_col_index].str());
             }
 
             
-            if (start_date_time_epoch <= current_row_date_time_epoch && current_row_date_time_epoch <= end_date_time_epoch)
+            //Rows are in time order, so nothing after a row past the model period is needed
+            if (current_row_date_time_epoch > end_date_time_epoch) {
+                break;
+            }
+
+            if (start_date_time_epoch <= current_row_date_time_epoch)
             {
                 time_epoch_vector.push_back(current_row_date_time_epoch);
+                if (time_epoch_vector.size() == 2) {
+                    reserve_for_period(reader, row);
+                }
 
-                int c = -1;
-                for (auto& s : vec){
-                    c++;
+                for (int c = 0; c < (int) row.size(); c++){
                     if(c == time_col_index)
                         continue;
-                    boost::algorithm::trim(s);
-                    local_valvec_index[c]->push_back(boost::lexical_cast<double>(s)); // This is supposed to update the vector in the map...
+                    double value;
+                    if (!Mapped_CSV_Reader::parse_double(row[c], value)) {
+                        throw std::runtime_error("Error: Forcing data " + file_name + " line "
+                                                 + std::to_string(reader.get_line_number()) + " has invalid value '"
+                                                 + row[c].str() + "'");
+                    }
+                    local_valvec_index[c]->push_back(value);
                 }
 
             }
@@ -375,6 +473,91 @@ class CsvPerFeatureForcingProvider : public data_access::GenericDataProvider
             std::cout << "WARNING: Forcing data ends before the model end time." << std::endl;
             //throw std::runtime_error("Error: Forcing data ends before the model end time.");
         }
+    
+        detect_record_stride();
+    }
+
+    /**
+     * @brief Find whether the records read are evenly spaced, so time step indices can be computed arithmetically.
+     *
+     * Sets @ref record_stride to the spacing of the records, or to 0 if they are irregular, and @ref last_ts_index to
+     * the index of the time step containing the end of the model period.
+     */
+    void detect_record_stride()
+    {
+        if (time_epoch_vector.size() < 2) {
+            // Nothing to detect from, so assume hourly records
+            record_stride = 3600;
+        }
+        else {
+            record_stride = time_epoch_vector[1] - time_epoch_vector[0];
+            for (size_t i = 2; i < time_epoch_vector.size(); ++i) {
+                if (time_epoch_vector[i] - time_epoch_vector[i - 1] != record_stride) {
+                    record_stride = 0;
+                    break;
+                }
+            }
+        }
+        if (record_stride > 0 && !time_epoch_vector.empty()) {
+            // Rounding up, as the end time may fall part way through a time step
+            last_ts_index = (end_date_time_epoch - time_epoch_vector[0] + record_stride - 1) / record_stride;
+        }
+        else {
+            last_ts_index = time_epoch_vector.empty() ? 0 : time_epoch_vector.size() - 1;
+        }
+    }
+
+    /**
+     * Get the beginning of a forcing time step.
+     *
+     * @param index The index of the time step.
+     * @return The epoch time at which the time step begins.
+     */
+    inline time_t get_ts_start_time(size_t index) const {
+        if (record_stride > 0) {
+            return (time_epoch_vector.empty() ? start_date_time_epoch : time_epoch_vector[0]) + index * record_stride;
+        }
+        return time_epoch_vector[index];
+    }
+
+    /**
+     * Get the duration of a forcing time step.
+     *
+     * For irregular records, this is the time until the next record, with the last record taken to be as long as the
+     * one before it.
+     *
+     * @param index The index of the time step.
+     * @return The duration of the time step in seconds.
+     */
+    inline long get_ts_duration(size_t index) const {
+        if (record_stride > 0) {
+            return record_stride;
+        }
+        if (index + 1 < time_epoch_vector.size()) {
+            return time_epoch_vector[index + 1] - time_epoch_vector[index];
+        }
+        return time_epoch_vector[index] - time_epoch_vector[index - 1];
+    }
+
+    /**
+     * @brief Reserve the column vectors for the rest of the model period, once the first two rows of it are read.
+     *
+     * The number of rows is estimated from the time between the two rows, capped by how many rows of the same length
+     * as the last one the rest of the file could hold.
+     */
+    void reserve_for_period(const Mapped_CSV_Reader& reader, const std::vector<Mapped_CSV_Reader::Field>& row)
+    {
+        const time_t stride = time_epoch_vector[1] - time_epoch_vector[0];
+        if (stride <= 0) {
+            return;
+        }
+        const size_t row_bytes = (row.back().end - row.front().begin) + 1;
+        const size_t rows = std::min<size_t>((end_date_time_epoch - time_epoch_vector[0]) / stride + 1,
+                                             2 + reader.remaining_bytes() / row_bytes);
+        time_epoch_vector.reserve(rows);
+        for (auto& forcing_vector : forcing_vectors) {
+            forcing_vector.second.reserve(rows);
+        }
     }
 
     std::vector<std::string> available_forcings;
@@ -383,10 +566,24 @@ class CsvPerFeatureForcingProvider : public data_access::GenericDataProvider
     /// \todo: Look into aggregation of data, relevant libraries, and storing frequency information
     std::unordered_map<std::string, std::vector<double>> forcing_vectors;
 
+    /// A forcing property and units conversion bound to a handle
+    struct BoundValue {
+        const std::vector<double>* series;
+        bool is_sum_over_time_step;
+        std::shared_ptr<cv_converter> converter;
+    };
+    /// Values bound by @ref bind_value, by handle
+    std::deque<BoundValue> bound_values;
+
     /// \todo: Consider making epoch time the iterator
     std::vector<time_t> time_epoch_vector;     
     int forcing_vector_index;
 
+    /// The spacing in seconds of evenly spaced records, or 0 if the records are irregular.
+    time_t record_stride = 0;
+    /// The index of the time step containing the end of the model period.
+    size_t last_ts_index = 0;
+
     /// \todo: Are these used?
     double precipitation_rate_meters_per_second;
     double air_temperature_fahrenheit;
@@ -5,6 +5,7 @@
 #include <utility>
 #include <vector>
 #include <algorithm>
+#include <deque>
 #include "WrappedDataProvider.hpp"
 
 using namespace std;
@@ -100,6 +101,37 @@ namespace data_access {
             return isWrappedProviderSet();
         }
 
+        /**
+         * Bind an output to a handle, binding it with the wrapped provider when it is to be read straight from there.
+         *
+         * When the wrapped provider is not yet set (or the output is not read straight from it), the output is bound
+         * by name, so it is still read through @ref get_value.  Outputs should be bound again once the wrapped
+         * provider is set to read them straight from it.
+         *
+         * @param id The catchment to read values for.
+         * @param variable_name The output to read values of.
+         * @param output_units The units to convert values to.
+         * @param m How data is to be resampled if there is a mismatch in data alignment or repeat rate
+         * @return The handle, for use with @ref get_bound_value.
+         */
+        value_handle_t bind_value(const std::string &id, const std::string &variable_name,
+                                  const std::string &output_units, ReSampleMethod m) override
+        {
+            ForwardedHandle bound;
+            bound.forwarded = isBoundValueForwarded(variable_name);
+            bound.handle = bound.forwarded ? wrapped_provider->bind_value(id, variable_name, output_units, m)
+                                           : GenericDataProvider::bind_value(id, variable_name, output_units, m);
+            forwarded_handles.push_back(bound);
+            return forwarded_handles.size() - 1;
+        }
+
+        double get_bound_value(value_handle_t handle, time_t init_time, long duration_s) override
+        {
+            const ForwardedHandle &bound = forwarded_handles[handle];
+            return bound.forwarded ? wrapped_provider->get_bound_value(bound.handle, init_time, duration_s)
+                                   : GenericDataProvider::get_bound_value(bound.handle, init_time, duration_s);
+        }
+
         /**
          * Get whether the backing provider this instance wraps has been set yet.
          *
@@ -154,6 +186,16 @@ namespace data_access {
         }
 
     protected:
+        /**
+         * Get whether values of an output bound by @ref bind_value are to be read straight from the wrapped provider.
+         *
+         * @param outputName The output in question.
+         * @return Whether values of the output are read straight from the wrapped provider, which must be set.
+         */
+        virtual bool isBoundValueForwarded(const string &outputName) {
+            return isWrappedProviderSet();
+        }
+
         /** The collection of names of the outputs this type can/will be able to provide from its wrapped source. */
         vector<string> providedOutputs;
 
@@ -164,6 +206,16 @@ namespace data_access {
          * info message set explaining more detail on the failure.
          */
         string setMessage;
+
+    private:
+        /** A handle of either the wrapped provider or of this instance's own binding by name. */
+        struct ForwardedHandle
+        {
+            bool forwarded;
+            value_handle_t handle;
+        };
+        /** Outputs bound by @ref bind_value, by handle. */
+        std::deque<ForwardedHandle> forwarded_handles;
     };
 
 }
@@ -1,17 +1,192 @@
 #ifndef NGEN_GENRIC_DATA_PROVIDER
 #define NGEN_GENRIC_DATA_PROVIDER
 
+#include <ctime>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include "DataProvider.hpp"
 #include "DataProviderSelectors.hpp"
 
 namespace data_access
 {
+    class GenericDataProvider;
+
+    /**
+     * @brief A plan for reading many values from a provider in one call.
+     *
+     * A plan covers every combination of a list of catchments and a list of variables, and is made once by
+     * @ref GenericDataProvider::prepare_batch, which resolves the names in it to whatever the provider indexes its
+     * data by.  It can then be passed to @ref GenericDataProvider::get_batch_values of the same provider for each time
+     * period of interest.
+     */
+    struct BatchPlan
+    {
+        /** The catchments to read values for. */
+        std::vector<std::string> catchment_ids;
+        /** The variables to read values of. */
+        std::vector<std::string> variable_names;
+        /** The units to convert the values of each variable to, in the order of @ref variable_names. */
+        std::vector<std::string> output_units;
+        /** How to resample the values of each variable, in the order of @ref variable_names. */
+        std::vector<ReSampleMethod> methods;
+
+        /** Provider-specific positions of the catchments, set by the provider that prepared the plan. */
+        std::vector<size_t> catchment_indices;
+        /** Provider-specific positions of the variables, set by the provider that prepared the plan. */
+        std::vector<size_t> variable_indices;
+        /** The provider that prepared the plan. */
+        const GenericDataProvider *prepared_by = nullptr;
+
+        /** @return The number of values read for each time period, and so the size of the buffer to read them into. */
+        size_t size() const
+        {
+            return catchment_ids.size() * variable_names.size();
+        }
+    };
+
+    /** An opaque handle to a value bound with @ref GenericDataProvider::bind_value, valid only for that provider. */
+    typedef size_t value_handle_t;
+
     class GenericDataProvider : public DataProvider<double, CatchmentAggrDataSelector>
     {
         public:
 
+        /**
+         * @brief Get the units in which this provider holds the values of a variable, before any conversion.
+         *
+         * @param variable_name The variable.
+         * @return The native units of the variable, or an empty string if they are not known.
+         */
+        virtual std::string get_variable_units(const std::string &variable_name)
+        {
+            return "";
+        }
+
+        /**
+         * @brief Bind a catchment, variable, units and resampling method to a handle, for reading its value quickly.
+         *
+         * Providers that look up names for each value should override this to resolve them, and the conversion to the
+         * output units, once here, and fail here for any catchment or variable they do not have.  Values should be
+         * bound while setting up, before the provider is read from several threads, and each handle should only be
+         * read by one caller at a time.
+         *
+         * @param id The catchment to read values for.
+         * @param variable_name The variable to read values of.
+         * @param output_units The units to convert values to.
+         * @param m How data is to be resampled if there is a mismatch in data alignment or repeat rate
+         * @return The handle, for use with @ref get_bound_value.
+         */
+        virtual value_handle_t bind_value(const std::string &id, const std::string &variable_name,
+                                          const std::string &output_units, ReSampleMethod m=SUM)
+        {
+            bound_selectors.push_back({CatchmentAggrDataSelector(id, variable_name, 0, 1, output_units), m});
+            return bound_selectors.size() - 1;
+        }
+
+        /**
+         * @brief Get the value bound to a handle for an arbitrary time period, converting units if needed.
+         *
+         * By default this reads the value with @ref get_value.
+         *
+         * @param handle A handle from @ref bind_value of this provider.
+         * @param init_time The epoch time (in seconds) of the start of the time period.
+         * @param duration_s The length of the time period, in seconds.
+         * @return The value for the described time period, with units converted if needed.
+         * @throws std::out_of_range If data for the time period is not available.
+         */
+        virtual double get_bound_value(value_handle_t handle, time_t init_time, long duration_s)
+        {
+            BoundSelector &bound = bound_selectors[handle];
+            bound.selector.set_init_time(init_time);
+            bound.selector.set_duration_secs(duration_s);
+            return get_value(bound.selector, bound.method);
+        }
+
+        /**
+         * @brief Prepare a plan for reading the values of many catchments and variables at once.
+         *
+         * Providers that can read many values more efficiently than one at a time should override this to resolve the
+         * catchments and variables to their own indices, and fail here for any they do not have.
+         *
+         * @param catchment_ids The catchments to read values for.
+         * @param variable_names The variables to read values of.
+         * @param output_units The units to convert the values of each variable to.
+         * @param methods How to resample the values of each variable.
+         * @return The plan.
+         * @throws std::invalid_argument If there are not as many units and methods as variables.
+         */
+        virtual BatchPlan prepare_batch(const std::vector<std::string> &catchment_ids,
+                                        const std::vector<std::string> &variable_names,
+                                        const std::vector<std::string> &output_units,
+                                        const std::vector<ReSampleMethod> &methods)
+        {
+            if (output_units.size() != variable_names.size() || methods.size() != variable_names.size()) {
+                throw std::invalid_argument("A batch plan needs output units and a resampling method for each variable.");
+            }
+            BatchPlan plan;
+            plan.catchment_ids = catchment_ids;
+            plan.variable_names = variable_names;
+            plan.output_units = output_units;
+            plan.methods = methods;
+            plan.prepared_by = this;
+            return plan;
+        }
+
+        /**
+         * @brief Read the values of every catchment and variable of a plan for a time period, converting units if needed.
+         *
+         * Values are written variable by variable, so the value of the ``c``th catchment and ``v``th variable of the
+         * plan is at ``v * plan.catchment_ids.size() + c`` in the buffer.
+         *
+         * By default this reads each value with @ref get_value.
+         *
+         * @param plan A plan prepared by this provider.
+         * @param init_time The epoch time (in seconds) of the start of the time period.
+         * @param duration_s The length of the time period, in seconds.
+         * @param values A buffer of at least @ref BatchPlan::size values to write the values to.
+         * @throws std::invalid_argument If the plan was prepared by another provider.
+         * @throws std::out_of_range If data for the time period is not available.
+         */
+        virtual void get_batch_values(const BatchPlan &plan, time_t init_time, long duration_s, double *values)
+        {
+            check_batch_plan(plan);
+            const size_t catchment_count = plan.catchment_ids.size();
+            CatchmentAggrDataSelector selector;
+            selector.set_init_time(init_time);
+            selector.set_duration_secs(duration_s);
+            for (size_t v = 0; v < plan.variable_names.size(); ++v) {
+                selector.set_variable_name(plan.variable_names[v]);
+                selector.set_output_units(plan.output_units[v]);
+                for (size_t c = 0; c < catchment_count; ++c) {
+                    selector.set_id(plan.catchment_ids[c]);
+                    values[v * catchment_count + c] = get_value(selector, plan.methods[v]);
+                }
+            }
+        }
+
+        protected:
+
+        void check_batch_plan(const BatchPlan &plan) const
+        {
+            if (plan.prepared_by != this) {
+                throw std::invalid_argument("A batch plan can only be used with the provider that prepared it.");
+            }
+        }
+
         private:
+
+        struct BoundSelector
+        {
+            CatchmentAggrDataSelector selector;
+            ReSampleMethod method;
+        };
+
+        /** Selectors for the values bound by the default @ref bind_value, by handle. */
+        std::deque<BoundSelector> bound_selectors;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,765 @@
+#ifdef NETCDF_ACTIVE
+#ifndef NGEN_GRIDDED_FORCING_PROVIDER_HPP
+#define NGEN_GRIDDED_FORCING_PROVIDER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include <boost/compute/detail/lru_cache.hpp>
+
+#include <netcdf>
+
+#include <FeatureBuilder.hpp>
+#include "core/utility/GridPolygon.hpp"
+#include <StreamHandler.hpp>
+#include <UnitsHelper.hpp>
+
+#include "AorcForcing.hpp"
+#include "GenericDataProvider.hpp"
+#include "NetCDFPerFeatureDataProvider.hpp"
+
+namespace data_access
+{
+    /**
+     * @brief Provider of catchment forcings from a gridded NetCDF file, as the area weighted mean of the cells each
+     * catchment covers.
+     *
+     * The file needs 1-D ``time``, ``y`` and ``x`` coordinate variables (``lat`` and ``lon``, or ``latitude`` and
+     * ``longitude``, are also accepted for the last two), each evenly spaced, with ``x`` and ``y`` giving the centres
+     * of the grid cells and ``time`` in CF form (e.g., ``hours since 1970-01-01 00:00:00``) giving the start of each
+     * time step.  Every variable with dimensions ``(time, y, x)`` is provided.  The hydrofabric must use the same
+     * coordinate system as the grid.
+     *
+     * When created, the provider works out what fraction of each catchment's area is in each grid cell, and keeps
+     * these weights as a sparse catchment by cell matrix.  As that takes a while for large hydrofabrics, the matrix is
+     * saved to a weights file, and read back from it by later runs for the same grid and catchments.  The file is named
+     * for a key of the set of catchments, so processes each providing forcings for their own part of the hydrofabric
+     * (e.g., MPI ranks) keep separate files.  Every catchment must cover at least one grid cell.  For each time
+     * step and variable needed, the part of the grid covered by the catchments is read, and multiplied by the matrix
+     * to get the values of every catchment at once, which are cached.
+     */
+    class GriddedForcingProvider : public GenericDataProvider
+    {
+        public:
+
+        /** The default most memory, in bytes, for cached catchment values. */
+        static const size_t DEFAULT_CACHE_BYTES = 64 * 1024 * 1024;
+
+        /**
+         * @brief Factory method that creates or returns an existing provider for the configured forcing file.
+         *
+         * @param forcing_config The forcing configuration, giving the path of the gridded file, and the path prefix of
+         * weights files (or the gridded file's path with ``.weights`` appended, if not set) and cache size.
+         * @param fabric The catchments to provide forcings for. If a provider for the file already exists, this
+         * argument will be ignored.
+         * @param log_s An output log stream for messages. If a provider for the file already exists, this argument
+         * will be ignored.
+         * @return A provider for the file.
+         */
+        static std::shared_ptr<GriddedForcingProvider> get_shared_provider(const forcing_params &forcing_config,
+                                                                           geojson::GeoJSON fabric,
+                                                                           utils::StreamHandler log_s)
+        {
+            static std::mutex shared_providers_mutex;
+            static std::map<std::string, std::weak_ptr<GriddedForcingProvider>> shared_providers;
+
+            const std::lock_guard<std::mutex> lock(shared_providers_mutex);
+            std::shared_ptr<GriddedForcingProvider> p = shared_providers[forcing_config.path].lock();
+            if (p == nullptr) {
+                std::string weights_path = forcing_config.weights_path.empty() ? forcing_config.path + ".weights"
+                                                                                : forcing_config.weights_path;
+                p = std::make_shared<GriddedForcingProvider>(forcing_config.path, weights_path, fabric, log_s,
+                                                             forcing_config.cache_bytes);
+                shared_providers[forcing_config.path] = p;
+            }
+            return p;
+        }
+
+        /**
+         * @brief Open a gridded forcing file, and read or work out the weights of its cells for each catchment.
+         *
+         * @param input_path The path of the gridded NetCDF file.
+         * @param weights_path The path prefix of the weights file, to which the key of the set of catchments is
+         * appended; the file is written if it is missing or is for another grid or set of catchments.
+         * @param fabric The catchments to provide forcings for; those without polygon geometry are skipped.
+         * @param log_s An output log stream for messages.
+         * @param cache_bytes The most memory in bytes for cached catchment values, or 0 for the default.
+         * @throws std::runtime_error If a catchment covers no cell of the grid.
+         */
+        GriddedForcingProvider(const std::string &input_path, const std::string &weights_path, geojson::GeoJSON fabric,
+                               utils::StreamHandler log_s, size_t cache_bytes = 0) : log_stream(log_s)
+        {
+            const std::lock_guard<std::mutex> lock(NetCDFPerFeatureDataProvider::netcdf_access_mutex);
+            nc_file = std::make_shared<netCDF::NcFile>(input_path, netCDF::NcFile::read);
+
+            read_grid();
+            read_times();
+            read_variables();
+
+            for (const geojson::Feature &feature : *fabric) {
+                if (feature->get_type() == geojson::FeatureType::Polygon
+                    || feature->get_type() == geojson::FeatureType::MultiPolygon) {
+                    catchment_positions[feature->get_id()] = catchment_ids.size();
+                    catchment_ids.push_back(feature->get_id());
+                }
+            }
+            weights_key = get_catchments_key(catchment_ids);
+            const std::string keyed_weights_path = get_weights_path(weights_path, weights_key);
+            if (!read_weights(keyed_weights_path)) {
+                compute_weights(fabric);
+                write_weights(keyed_weights_path);
+            }
+            check_coverage();
+            prepare_slab();
+
+            size_t entry_bytes = std::max<size_t>(catchment_ids.size(), 1) * sizeof(double);
+            size_t cache_entries = std::max((cache_bytes > 0 ? cache_bytes : (size_t) DEFAULT_CACHE_BYTES) / entry_bytes,
+                                            variable_ncvars.size());
+            means_cache = std::make_unique<boost::compute::detail::lru_cache<uint64_t, std::shared_ptr<std::vector<double>>>>(cache_entries);
+        }
+
+        GriddedForcingProvider(const GriddedForcingProvider&) = delete;
+        GriddedForcingProvider& operator=(const GriddedForcingProvider&) = delete;
+
+        /**
+         * @brief Get the key of a list of catchments that names and is checked against their weights file.
+         *
+         * @param catchment_ids The catchments, in order.
+         * @return A 64-bit FNV-1a hash of the ids.
+         */
+        static uint64_t get_catchments_key(const std::vector<std::string> &catchment_ids)
+        {
+            uint64_t key = 14695981039346656037ULL;
+            for (const std::string &id : catchment_ids) {
+                // Hash the terminating null too, so ids cannot run together
+                for (size_t i = 0; i <= id.size(); ++i) {
+                    key = (key ^ (unsigned char) id.c_str()[i]) * 1099511628211ULL;
+                }
+            }
+            return key;
+        }
+
+        /**
+         * @brief Get the path of the weights file for a set of catchments.
+         *
+         * @param weights_path The configured path prefix of weights files.
+         * @param key The key of the catchments, from @ref get_catchments_key.
+         * @return The prefix followed by ``.`` and the key in hexadecimal.
+         */
+        static std::string get_weights_path(const std::string &weights_path, uint64_t key)
+        {
+            char hex[17];
+            std::snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) key);
+            return weights_path + "." + hex;
+        }
+
+        const std::vector<std::string> &get_avaliable_variable_names() override
+        {
+            return variable_names;
+        }
+
+        std::string get_variable_units(const std::string &variable_name) override
+        {
+            auto var_id = var_ids.find(variable_name);
+            return var_id == var_ids.end() ? "" : variable_units[var_id->second];
+        }
+
+        /** Return the ids of the catchments forcings are provided for */
+        const std::vector<std::string> &get_ids() const
+        {
+            return catchment_ids;
+        }
+
+        long get_data_start_time() override
+        {
+            return start_time;
+        }
+
+        long get_data_stop_time() override
+        {
+            return stop_time;
+        }
+
+        long record_duration() override
+        {
+            return time_stride;
+        }
+
+        /**
+         * Get the index of the data time step that contains the given point in time.
+         *
+         * @param epoch_time The point in time, as a seconds-based epoch time.
+         * @return The index of the forcing time step that contains the given point in time.
+         * @throws std::out_of_range If the given point is not in any time step.
+         */
+        size_t get_ts_index_for_time(const time_t &epoch_time) override
+        {
+            if (epoch_time < start_time || epoch_time >= stop_time) {
+                throw std::out_of_range("Gridded forcing has no time step for time " + std::to_string(epoch_time));
+            }
+            return (size_t) ((epoch_time - start_time) / time_stride);
+        }
+
+        /**
+         * Get the value of a forcing property for a catchment for an arbitrary time period, converting units if needed.
+         *
+         * Each time step overlapping the period contributes in proportion to the overlap, and any part of the period
+         * past the last time step is left out.
+         *
+         * @param selector Data required to establish what subset of the stored data should be accessed
+         * @param m How data is to be resampled if there is a mismatch in data alignment or repeat rate
+         * @return The value of the forcing property for the described time period, with units converted if needed.
+         * @throws std::out_of_range If data for the time period or catchment is not available.
+         */
+        double get_value(const CatchmentAggrDataSelector& selector, ReSampleMethod m) override
+        {
+            const size_t cat = get_catchment_position(selector.get_id());
+            const size_t var_id = get_var_id(selector.get_variable_name());
+            double value;
+            {
+                const std::lock_guard<std::mutex> lock(NetCDFPerFeatureDataProvider::netcdf_access_mutex);
+                value = get_raw_value(cat, var_id, selector.get_init_time(), selector.get_duration_secs(), m);
+            }
+
+            try {
+                return UnitsHelper::get_converted_value(variable_units[var_id], value, selector.get_output_units());
+            }
+            catch (const std::runtime_error& e) {
+                #ifndef UDUNITS_QUIET
+                std::cerr<<"WARN: Unit conversion unsuccessful - Returning unconverted value! (\""<<e.what()<<"\")"<<std::endl;
+                #endif
+                return value;
+            }
+        }
+
+        std::vector<double> get_values(const CatchmentAggrDataSelector& selector, ReSampleMethod m) override
+        {
+            return std::vector<double>(1, get_value(selector, m));
+        }
+
+        value_handle_t bind_value(const std::string &id, const std::string &variable_name,
+                                  const std::string &output_units, ReSampleMethod m) override
+        {
+            BoundValue bound;
+            bound.cat = get_catchment_position(id);
+            bound.var_id = get_var_id(variable_name);
+            bound.method = m;
+            try {
+                bound.converter = UnitsHelper::get_shared_converter(variable_units[bound.var_id], output_units);
+            }
+            catch (const std::runtime_error& e) {
+                #ifndef UDUNITS_QUIET
+                std::cerr<<"WARN: Unit conversion unsuccessful - Returning unconverted values! (\""<<e.what()<<"\")"<<std::endl;
+                #endif
+            }
+            bound_values.push_back(bound);
+            return bound_values.size() - 1;
+        }
+
+        double get_bound_value(value_handle_t handle, time_t init_time, long duration_s) override
+        {
+            const BoundValue &bound = bound_values[handle];
+            double value;
+            {
+                const std::lock_guard<std::mutex> lock(NetCDFPerFeatureDataProvider::netcdf_access_mutex);
+                value = get_raw_value(bound.cat, bound.var_id, init_time, duration_s, bound.method);
+            }
+            return UnitsHelper::convert_value(bound.converter.get(), value);
+        }
+
+        private:
+
+        /** The version of the weights file format written. */
+        static const uint32_t WEIGHTS_VERSION = 2;
+
+        /** @return The magic bytes at the start of a weights file. */
+        static const char *weights_magic()
+        {
+            return "NGENGWT";
+        }
+
+        struct BoundValue
+        {
+            size_t cat;
+            size_t var_id;
+            ReSampleMethod method;
+            std::shared_ptr<cv_converter> converter;
+        };
+
+        /**
+         * Read a 1-D evenly spaced coordinate variable of cell centres, as the outer edge of the first cell, the
+         * signed width of cells, and the number of cells.
+         */
+        void read_axis(const std::vector<std::string> &names, double &edge, double &width, size_t &count,
+                       std::string &dim_name)
+        {
+            for (const std::string &name : names) {
+                netCDF::NcVar var = nc_file->getVar(name);
+                if (var.isNull()) {
+                    continue;
+                }
+                if (var.getDimCount() != 1) {
+                    throw std::runtime_error("Gridded forcing coordinate variable " + name + " is not 1-D");
+                }
+                dim_name = var.getDim(0).getName();
+                count = var.getDim(0).getSize();
+                std::vector<double> centres(count);
+                var.getVar(centres.data());
+                if (count < 2) {
+                    throw std::runtime_error("Gridded forcing needs at least 2 cells along " + name);
+                }
+                width = centres[1] - centres[0];
+                for (size_t i = 2; i < count; ++i) {
+                    if (std::abs(centres[i] - centres[i - 1] - width) > std::abs(width) * 1e-6) {
+                        throw std::runtime_error("Gridded forcing coordinate " + name + " is not evenly spaced");
+                    }
+                }
+                edge = centres[0] - width / 2;
+                return;
+            }
+            throw std::runtime_error("Gridded forcing has no coordinate variable " + names[0]);
+        }
+
+        void read_grid()
+        {
+            read_axis({"x", "lon", "longitude"}, x_edge, x_width, x_count, x_dim_name);
+            read_axis({"y", "lat", "latitude"}, y_edge, y_width, y_count, y_dim_name);
+        }
+
+        void read_times()
+        {
+            netCDF::NcVar time_var = nc_file->getVar("time");
+            if (time_var.isNull() || time_var.getDimCount() != 1) {
+                throw std::runtime_error("Gridded forcing has no 1-D time variable");
+            }
+            time_dim_name = time_var.getDim(0).getName();
+            std::vector<double> raw_time(time_var.getDim(0).getSize());
+            if (raw_time.size() < 2) {
+                throw std::runtime_error("Gridded forcing needs at least 2 time steps");
+            }
+            time_var.getVar(raw_time.data());
+
+            std::string units;
+            netCDF::NcVarAtt units_att = time_var.getAtt("units");
+            units_att.getValues(units);
+            double scale_factor;
+            time_t epoch;
+            parse_cf_time_units(units, scale_factor, epoch);
+
+            time_vals.resize(raw_time.size());
+            std::transform(raw_time.begin(), raw_time.end(), time_vals.begin(),
+                           [&](double t) { return t * scale_factor + epoch; });
+            time_stride = time_vals[1] - time_vals[0];
+            for (size_t i = 2; i < time_vals.size(); ++i) {
+                if (std::abs(time_vals[i] - time_vals[i - 1] - time_stride) > 0.000001) {
+                    throw std::runtime_error("Time intervals in gridded forcing file are not constant");
+                }
+            }
+            start_time = time_vals[0];
+            stop_time = time_vals.back() + time_stride;
+        }
+
+        /** Parse CF time units, like ``hours since 1970-01-01 00:00:00``, into seconds per unit and the epoch. */
+        static void parse_cf_time_units(const std::string &units, double &scale_factor, time_t &epoch)
+        {
+            size_t since = units.find(" since ");
+            if (since == std::string::npos) {
+                throw std::runtime_error("Gridded forcing time units '" + units + "' are not of the form '<units> since <date>'");
+            }
+            std::string unit = units.substr(0, since);
+            if (unit == "seconds" || unit == "second" || unit == "s") {
+                scale_factor = 1;
+            }
+            else if (unit == "minutes" || unit == "minute" || unit == "min") {
+                scale_factor = 60;
+            }
+            else if (unit == "hours" || unit == "hour" || unit == "h") {
+                scale_factor = 3600;
+            }
+            else if (unit == "days" || unit == "day" || unit == "d") {
+                scale_factor = 86400;
+            }
+            else {
+                throw std::runtime_error("Gridded forcing has unsupported time unit '" + unit + "'");
+            }
+
+            struct tm tm{};
+            int parsed = std::sscanf(units.c_str() + since + 7, "%d-%d-%d%*[ T]%d:%d:%d", &tm.tm_year, &tm.tm_mon,
+                                     &tm.tm_mday, &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
+            if (parsed < 3) {
+                throw std::runtime_error("Gridded forcing has unparseable time units '" + units + "'");
+            }
+            tm.tm_year -= 1900;
+            tm.tm_mon -= 1;
+            epoch = timegm(&tm);
+        }
+
+        void read_variables()
+        {
+            for (const auto &element : nc_file->getVars()) {
+                const std::string &var_name = element.first;
+                const netCDF::NcVar &ncvar = element.second;
+                if (ncvar.getDimCount() != 3 || ncvar.getDim(0).getName() != time_dim_name
+                    || ncvar.getDim(1).getName() != y_dim_name || ncvar.getDim(2).getName() != x_dim_name) {
+                    continue;
+                }
+                size_t var_id = variable_ncvars.size();
+                variable_ncvars.push_back(ncvar);
+
+                std::string native_units;
+                netCDF::NcVarAtt units_att = ncvar.getAtt("units");
+                if (!units_att.isNull()) {
+                    units_att.getValues(native_units);
+                }
+                double fill_value = std::numeric_limits<double>::quiet_NaN();
+                netCDF::NcVarAtt fill_att = ncvar.getAtt("_FillValue");
+                if (!fill_att.isNull()) {
+                    fill_att.getValues(&fill_value);
+                }
+                variable_fill_values.push_back(fill_value);
+
+                variable_names.push_back(var_name);
+                var_ids[var_name] = var_id;
+                auto wkf = WellKnownFields.find(var_name);
+                if (wkf != WellKnownFields.end()) {
+                    native_units = native_units.empty() ? std::get<1>(wkf->second) : native_units;
+                    variable_names.push_back(std::get<0>(wkf->second));
+                    var_ids[std::get<0>(wkf->second)] = var_id;
+                }
+                variable_units.push_back(native_units);
+            }
+        }
+
+        /** Work out the weights of the cells each catchment covers, from the catchment polygons. */
+        void compute_weights(geojson::GeoJSON fabric)
+        {
+            log_stream << "Computing gridded forcing weights for " + std::to_string(catchment_ids.size()) + " catchments\n";
+            weight_offsets.assign(1, 0);
+            weight_cells.clear();
+            weight_values.clear();
+            for (const std::string &id : catchment_ids) {
+                for (const auto &fraction : compute_cell_area_fractions(get_shape(fabric->get_feature(id)), x_edge,
+                                                                        x_width, x_count, y_edge, y_width, y_count)) {
+                    weight_cells.push_back(fraction.first);
+                    weight_values.push_back(fraction.second);
+                }
+                weight_offsets.push_back(weight_cells.size());
+            }
+        }
+
+        /** Get a catchment's polygons in the cartesian form used for intersecting them with grid cells. */
+        static multi_polygon_type get_shape(const geojson::Feature &feature)
+        {
+            auto to_cartesian = [](const geojson::polygon_t &polygon) {
+                polygon_type p;
+                for (const auto &point : polygon.outer()) {
+                    bg::append(p.outer(), point_t(bg::get<0>(point), bg::get<1>(point)));
+                }
+                p.inners().resize(polygon.inners().size());
+                for (size_t i = 0; i < polygon.inners().size(); ++i) {
+                    for (const auto &point : polygon.inners()[i]) {
+                        bg::append(p.inners()[i], point_t(bg::get<0>(point), bg::get<1>(point)));
+                    }
+                }
+                // GeoJSON rings run counterclockwise, and need not be in the orientation boost expects
+                bg::correct(p);
+                return p;
+            };
+
+            multi_polygon_type shape;
+            if (feature->get_type() == geojson::FeatureType::Polygon) {
+                shape.push_back(to_cartesian(feature->geometry<geojson::polygon_t>()));
+            }
+            else {
+                for (const geojson::polygon_t &polygon : feature->geometry<geojson::multipolygon_t>()) {
+                    shape.push_back(to_cartesian(polygon));
+                }
+            }
+            return shape;
+        }
+
+        /**
+         * Read the weights from a weights file, if it exists and is for the same grid and catchments.
+         *
+         * A weights file holds, in the native byte order, the magic bytes and version, the 64-bit key of the
+         * catchments, the grid (x edge, x width, y edge, y width as doubles, then x and y counts as 64-bit integers),
+         * the number of catchments, then for each catchment its length-prefixed id, its number of cells, and its cell
+         * indices and weights.
+         *
+         * @return Whether the weights were read.
+         */
+        bool read_weights(const std::string &path)
+        {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                return false;
+            }
+            char magic[8];
+            uint32_t version;
+            uint64_t key;
+            double grid[4];
+            uint64_t counts[3];
+            in.read(magic, sizeof(magic));
+            in.read(reinterpret_cast<char*>(&version), sizeof(version));
+            in.read(reinterpret_cast<char*>(&key), sizeof(key));
+            in.read(reinterpret_cast<char*>(grid), sizeof(grid));
+            in.read(reinterpret_cast<char*>(counts), sizeof(counts));
+            if (!in || std::memcmp(magic, weights_magic(), sizeof(magic)) != 0 || version != WEIGHTS_VERSION
+                || key != weights_key
+                || grid[0] != x_edge || grid[1] != x_width || grid[2] != y_edge || grid[3] != y_width
+                || counts[0] != x_count || counts[1] != y_count || counts[2] != catchment_ids.size()) {
+                return false;
+            }
+
+            std::vector<size_t> offsets(1, 0);
+            std::vector<size_t> cells;
+            std::vector<double> values;
+            std::string id;
+            for (const std::string &expected_id : catchment_ids) {
+                uint32_t id_length;
+                uint64_t cell_count;
+                in.read(reinterpret_cast<char*>(&id_length), sizeof(id_length));
+                if (!in || id_length != expected_id.size()) {
+                    return false;
+                }
+                id.resize(id_length);
+                in.read(&id[0], id_length);
+                in.read(reinterpret_cast<char*>(&cell_count), sizeof(cell_count));
+                if (!in || id != expected_id || cell_count > x_count * y_count) {
+                    return false;
+                }
+                for (uint64_t i = 0; i < cell_count; ++i) {
+                    uint64_t cell;
+                    double weight;
+                    in.read(reinterpret_cast<char*>(&cell), sizeof(cell));
+                    in.read(reinterpret_cast<char*>(&weight), sizeof(weight));
+                    if (!in || cell >= x_count * y_count) {
+                        return false;
+                    }
+                    cells.push_back(cell);
+                    values.push_back(weight);
+                }
+                offsets.push_back(cells.size());
+            }
+            weight_offsets = std::move(offsets);
+            weight_cells = std::move(cells);
+            weight_values = std::move(values);
+            return true;
+        }
+
+        /** Write the weights to a weights file, replacing any existing one once complete. */
+        void write_weights(const std::string &path)
+        {
+            std::string temp_path = path + ".tmp." + std::to_string(getpid());
+            {
+                std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+                const double grid[4] = {x_edge, x_width, y_edge, y_width};
+                const uint64_t counts[3] = {x_count, y_count, catchment_ids.size()};
+                const uint32_t version = WEIGHTS_VERSION;
+                out.write(weights_magic(), 8);
+                out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+                out.write(reinterpret_cast<const char*>(&weights_key), sizeof(weights_key));
+                out.write(reinterpret_cast<const char*>(grid), sizeof(grid));
+                out.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+                for (size_t c = 0; c < catchment_ids.size(); ++c) {
+                    const uint32_t id_length = catchment_ids[c].size();
+                    const uint64_t cell_count = weight_offsets[c + 1] - weight_offsets[c];
+                    out.write(reinterpret_cast<const char*>(&id_length), sizeof(id_length));
+                    out.write(catchment_ids[c].data(), id_length);
+                    out.write(reinterpret_cast<const char*>(&cell_count), sizeof(cell_count));
+                    for (size_t k = weight_offsets[c]; k < weight_offsets[c + 1]; ++k) {
+                        const uint64_t cell = weight_cells[k];
+                        out.write(reinterpret_cast<const char*>(&cell), sizeof(cell));
+                        out.write(reinterpret_cast<const char*>(&weight_values[k]), sizeof(double));
+                    }
+                }
+                if (!out) {
+                    log_stream << "Warning: could not write gridded forcing weights file " + path + "\n";
+                    std::remove(temp_path.c_str());
+                    return;
+                }
+            }
+            if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+                log_stream << "Warning: could not write gridded forcing weights file " + path + "\n";
+                std::remove(temp_path.c_str());
+            }
+        }
+
+        /** Check that every catchment covers some cell of the grid, so none is left without forcing values. */
+        void check_coverage() const
+        {
+            std::string uncovered;
+            size_t uncovered_count = 0;
+            for (size_t c = 0; c < catchment_ids.size(); ++c) {
+                if (weight_offsets[c + 1] == weight_offsets[c]) {
+                    if (uncovered_count++ < 10) {
+                        uncovered += (uncovered.empty() ? "" : ", ") + catchment_ids[c];
+                    }
+                }
+            }
+            if (uncovered_count > 0) {
+                throw std::runtime_error("Gridded forcing grid covers no cells of " + std::to_string(uncovered_count)
+                                         + " catchment(s): " + uncovered + (uncovered_count > 10 ? ", ..." : ""));
+            }
+        }
+
+        /**
+         * Find the smallest block of the grid holding every weighted cell, which is all that is read for each time step,
+         * and re-index the weighted cells within it.
+         */
+        void prepare_slab()
+        {
+            size_t row_first = y_count, row_last = 0, col_first = x_count, col_last = 0;
+            for (size_t cell : weight_cells) {
+                row_first = std::min(row_first, cell / x_count);
+                row_last = std::max(row_last, cell / x_count);
+                col_first = std::min(col_first, cell % x_count);
+                col_last = std::max(col_last, cell % x_count);
+            }
+            if (weight_cells.empty()) {
+                slab_start = {0, 0, 0};
+                slab_count = {1, 0, 0};
+                return;
+            }
+            slab_start = {0, row_first, col_first};
+            slab_count = {1, row_last - row_first + 1, col_last - col_first + 1};
+            slab_cells.resize(weight_cells.size());
+            for (size_t k = 0; k < weight_cells.size(); ++k) {
+                slab_cells[k] = (weight_cells[k] / x_count - row_first) * slab_count[2]
+                                + (weight_cells[k] % x_count - col_first);
+            }
+            slab.resize(slab_count[1] * slab_count[2]);
+        }
+
+        /**
+         * Get the values of a variable at a time step for every catchment, reading and weighting the grid if they are
+         * not cached.  The NetCDF access mutex must be held.
+         */
+        std::shared_ptr<std::vector<double>> get_means(size_t var_id, size_t ts)
+        {
+            uint64_t key = (uint64_t) var_id * time_vals.size() + ts;
+            auto cached = means_cache->get(key);
+            if (cached) {
+                return cached.get();
+            }
+
+            auto means = std::make_shared<std::vector<double>>(catchment_ids.size(), std::numeric_limits<double>::quiet_NaN());
+            if (!slab.empty()) {
+                slab_start[0] = ts;
+                variable_ncvars[var_id].getVar(slab_start, slab_count, slab.data());
+            }
+            // Cells missing a value are left out, and the weights of the rest scaled up to make up for them
+            const double fill_value = variable_fill_values[var_id];
+            const double *values = slab.data();
+            for (size_t c = 0; c < catchment_ids.size(); ++c) {
+                double sum = 0.0;
+                double weight = 0.0;
+                for (size_t k = weight_offsets[c]; k < weight_offsets[c + 1]; ++k) {
+                    const double value = values[slab_cells[k]];
+                    if (value != fill_value && !std::isnan(value)) {
+                        sum += weight_values[k] * value;
+                        weight += weight_values[k];
+                    }
+                }
+                if (weight > 0.0) {
+                    (*means)[c] = sum / weight;
+                }
+            }
+            means_cache->insert(key, means);
+            return means;
+        }
+
+        /**
+         * Get the value of a variable for a catchment for an arbitrary time period, in its native units.  The NetCDF
+         * access mutex must be held.
+         */
+        double get_raw_value(size_t cat, size_t var_id, time_t init_time, long duration_s, ReSampleMethod m)
+        {
+            size_t ts = get_ts_index_for_time(init_time);
+            const double period_stop = (double) init_time + duration_s;
+            double value = 0.0;
+            double covered_s = 0.0;
+            for (; ts < time_vals.size() && time_vals[ts] < period_stop; ++ts) {
+                const double overlap_s = std::min(period_stop, time_vals[ts] + time_stride)
+                                         - std::max((double) init_time, time_vals[ts]);
+                value += (*get_means(var_id, ts))[cat] * overlap_s;
+                covered_s += overlap_s;
+            }
+            // Sums take the part of each time step's value in the period, and means weight by time in the period
+            return m == MEAN ? value / covered_s : value / time_stride;
+        }
+
+        size_t get_catchment_position(const std::string &id) const
+        {
+            auto position = catchment_positions.find(id);
+            if (position == catchment_positions.end()) {
+                throw std::out_of_range("Gridded forcing has no catchment " + id);
+            }
+            return position->second;
+        }
+
+        size_t get_var_id(const std::string &name) const
+        {
+            auto id = var_ids.find(name);
+            if (id == var_ids.end()) {
+                throw std::runtime_error("Gridded forcing has no variable " + name);
+            }
+            return id->second;
+        }
+
+        utils::StreamHandler log_stream;
+        std::shared_ptr<netCDF::NcFile> nc_file;
+
+        double x_edge, x_width, y_edge, y_width;
+        size_t x_count, y_count;
+        std::string x_dim_name, y_dim_name, time_dim_name;
+
+        std::vector<double> time_vals;
+        double start_time;
+        double stop_time;
+        double time_stride;
+
+        std::vector<std::string> variable_names;
+        std::map<std::string, size_t> var_ids;
+        std::vector<netCDF::NcVar> variable_ncvars;
+        std::vector<std::string> variable_units;
+        std::vector<double> variable_fill_values;
+
+        std::vector<std::string> catchment_ids;
+        std::unordered_map<std::string, size_t> catchment_positions;
+        /** The key of @ref catchment_ids, which names and is checked against their weights file. */
+        uint64_t weights_key;
+
+        /** The weights as a sparse matrix in compressed rows: catchment ``c`` has entries from ``weight_offsets[c]``. */
+        std::vector<size_t> weight_offsets;
+        /** The row-major grid index of the cell of each weight. */
+        std::vector<size_t> weight_cells;
+        std::vector<double> weight_values;
+        /** The index within @ref slab of the cell of each weight. */
+        std::vector<size_t> slab_cells;
+        std::vector<size_t> slab_start;
+        std::vector<size_t> slab_count;
+        /** The block of the grid read for a time step. */
+        std::vector<double> slab;
+
+        /** Values of every catchment for one variable and time step, keyed by (variable id, time step) */
+        std::unique_ptr<boost::compute::detail::lru_cache<uint64_t, std::shared_ptr<std::vector<double>>>> means_cache;
+        std::deque<BoundValue> bound_values;
+    };
+}
+
+#endif // NGEN_GRIDDED_FORCING_PROVIDER_HPP
+#endif
@@ -7,6 +7,7 @@
 
 #include <string>
 #include <algorithm>
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
@@ -15,6 +16,8 @@
 #include <mutex>
 #include "assert.h"
 #include <iomanip>
+#include <iostream>
+#include <cstdint>
 #include <boost/compute/detail/lru_cache.hpp>
 
 #include <UnitsHelper.hpp>
@@ -44,25 +47,49 @@ namespace data_access
             TIME_NANOSECONDS
         };
 
+        /** The default number of time steps read from the file at once. */
+        static const size_t DEFAULT_CHUNK_TIME_STEPS = 24;
+        /** The default most memory, in bytes, for cached chunks of values. */
+        static const size_t DEFAULT_CACHE_BYTES = 256 * 1024 * 1024;
+
         /**
          * @brief Factory method that creates or returns an existing provider for the provided path.
          * @param input_path The path to a NetCDF file with lumped catchment forcing values.
          * @param log_s An output log stream for messages from the underlying library. If a provider object for
          * the given path already exists, this argument will be ignored.
+         * @param chunk_time_steps The number of time steps to read from the file at once, or 0 for the default. If a
+         * provider object for the given path already exists, this argument will be ignored.
+         * @param cache_bytes The most memory in bytes for cached chunks of values, or 0 for the default. If a provider
+         * object for the given path already exists, this argument will be ignored.
          */
-        static std::shared_ptr<NetCDFPerFeatureDataProvider> get_shared_provider(std::string input_path, utils::StreamHandler log_s){
+        static std::shared_ptr<NetCDFPerFeatureDataProvider> get_shared_provider(std::string input_path, utils::StreamHandler log_s,
+                                                                                 size_t chunk_time_steps = 0, size_t cache_bytes = 0){
             const std::lock_guard<std::mutex> lock(shared_providers_mutex);
             std::shared_ptr<NetCDFPerFeatureDataProvider> p;
             if(shared_providers.count(input_path) > 0){
                 p = shared_providers[input_path];
             } else {
-                p = std::make_shared<data_access::NetCDFPerFeatureDataProvider>(input_path, log_s);
+                p = std::make_shared<data_access::NetCDFPerFeatureDataProvider>(input_path, log_s, chunk_time_steps, cache_bytes);
                 shared_providers[input_path] = p;
             }
             return p;
         }
 
-        NetCDFPerFeatureDataProvider(std::string input_path, utils::StreamHandler log_s) : log_stream(log_s), value_cache(20)
+        /**
+         * @brief Open a NetCDF file of lumped catchment forcing values.
+         *
+         * Values are read a chunk at a time, each chunk holding a run of time steps of one variable for every
+         * catchment, and the most recently used chunks are cached.
+         *
+         * @param input_path The path to a NetCDF file with lumped catchment forcing values.
+         * @param log_s An output log stream for messages from the underlying library.
+         * @param chunk_time_steps The number of time steps to read from the file at once, or 0 for the default.
+         * @param cache_bytes The most memory in bytes for cached chunks of values, or 0 for the default. The default
+         * is raised, with a warning, if it cannot hold a chunk of every variable.
+         * @throws std::runtime_error If a non-default @p cache_bytes cannot hold a chunk of every variable.
+         */
+        NetCDFPerFeatureDataProvider(std::string input_path, utils::StreamHandler log_s, size_t chunk_time_steps = 0,
+                                     size_t cache_bytes = 0) : log_stream(log_s)
         {
             //size_t sizep = 1073741824, nelemsp = 202481;
             //float preemptionp = 0.75;
@@ -77,13 +104,20 @@ namespace data_access
             //get the listing of all variables
             auto var_set = nc_file->getVars();
 
-            // populate the ncvar and units caches...
+            // populate the variable ids, and the variables and their units by id...
+            size_t num_vars = 0;
             std::for_each(var_set.begin(), var_set.end(), [&](const auto& element)
             {
                 std::string var_name = element.first;
                 auto ncvar = nc_file->getVar(var_name);
+                // Only the (catchment, time) series are forcings, not the catchment ids or the time coordinate
+                if (var_name == "ids" || var_name == "Time" || ncvar.getDimCount() != 2) {
+                    return;
+                }
                 variable_names.push_back(var_name);
-                ncvar_cache.emplace(var_name,ncvar);
+                size_t var_id = num_vars++;
+                var_ids[var_name] = var_id;
+                var_id_ncvars.push_back(ncvar);
 
                 std::string native_units;
                 try
@@ -108,11 +142,10 @@ namespace data_access
                     native_units = native_units.empty() ? std::get<1>(wkf->second) : native_units;
                     std::string can_name = std::get<0>(wkf->second); // the CSDMS name
                     variable_names.push_back(can_name);
-                    ncvar_cache.emplace(can_name,ncvar);
-                    units_cache[can_name] = native_units;
+                    var_ids[can_name] = var_id;
                 }
 
-                units_cache[var_name] = native_units;
+                var_id_units.push_back(native_units);
             });
 
             // read the variable ids
@@ -286,6 +319,28 @@ namespace data_access
             start_time = time_vals[0];
             stop_time = time_vals.back() + time_stride;
 
+            // size the chunks and the cache, which should at least hold a chunk of every variable at once
+            num_time_steps = num_times;
+            cache_slice_t_size = std::min(chunk_time_steps > 0 ? chunk_time_steps : DEFAULT_CHUNK_TIME_STEPS, num_times);
+            num_time_chunks = (num_times + cache_slice_t_size - 1) / cache_slice_t_size;
+            cache_chunk_bytes = cache_slice_c_size * cache_slice_t_size * sizeof(double);
+            size_t min_cache_bytes = num_vars * cache_chunk_bytes;
+            size_t cache_chunks = (cache_bytes > 0 ? cache_bytes : DEFAULT_CACHE_BYTES) / cache_chunk_bytes;
+            if (cache_chunks < num_vars) {
+                // A configured limit is not silently exceeded; only the default is raised to what the file needs
+                if (cache_bytes > 0) {
+                    throw std::runtime_error("NetCDF forcing cache of " + std::to_string(cache_bytes) + " bytes for "
+                                             + input_path + " is too small for a chunk of every variable, which needs "
+                                             + std::to_string(min_cache_bytes) + " bytes");
+                }
+                std::string message = "WARNING: default NetCDF forcing cache is too small for a chunk of every variable of "
+                                      + input_path + ", so it will use " + std::to_string(min_cache_bytes) + " bytes\n";
+                std::cerr << message;
+                log_stream << message;
+                cache_chunks = num_vars;
+            }
+            value_cache = std::make_unique<boost::compute::detail::lru_cache<uint64_t, std::shared_ptr<std::vector<double>>>>(cache_chunks);
+
 
         }
 
@@ -302,6 +357,24 @@ namespace data_access
             return variable_names;
         }
 
+        std::string get_variable_units(const std::string &variable_name) override
+        {
+            auto var_id = var_ids.find(variable_name);
+            return var_id == var_ids.end() ? "" : var_id_units[var_id->second];
+        }
+
+        /** Return the size in bytes of a cached chunk of values of one variable for every catchment. */
+        size_t get_cache_chunk_bytes() const
+        {
+            return cache_chunk_bytes;
+        }
+
+        /** Return the most chunks of values that are cached at once. */
+        size_t get_cache_chunks() const
+        {
+            return value_cache->capacity();
+        }
+
         /** return a list of ids in the current file */
         const std::vector<std::string>& get_ids() const
         {
@@ -364,119 +437,71 @@ namespace data_access
          */
         double get_value(const CatchmentAggrDataSelector& selector, ReSampleMethod m) override
         {
-            auto init_time = selector.get_init_time();
-            auto stop_time = init_time + selector.get_duration_secs(); // scope hiding! BAD JUJU!
-            
-            size_t idx1 = get_ts_index_for_time(init_time);
-            size_t idx2;
-            try {
-                idx2 = get_ts_index_for_time(stop_time-1); // Don't include next timestep when duration % timestep = 0
-            }
-            catch(const std::out_of_range &e){
-                idx2 = get_ts_index_for_time(this->stop_time-1); //to the edge
-            }
-
-            auto stride = idx2 - idx1;
-
-            std::vector<std::size_t> start, count;
+            // The NetCDF library is not thread safe, and the value cache is shared by all users of this provider
+            const std::lock_guard<std::mutex> lock(netcdf_access_mutex);
 
             auto cat_pos = id_pos[selector.get_id()];
+            size_t var_id = get_var_id(selector.get_variable_name());
+            double rvalue = get_raw_value(cat_pos, var_id, selector.get_init_time(), selector.get_duration_secs(), m);
 
-
-
-            double t1 = time_vals[idx1];
-            double t2 = time_vals[idx2];
-
-            double rvalue = 0.0;
-            
-            auto ncvar = get_ncvar(selector.get_variable_name());
-
-            std::string native_units = get_ncvar_units(selector.get_variable_name());
-
-            auto read_len = idx2 - idx1 + 1;
-
-            std::vector<double> raw_values;
-            raw_values.resize(read_len);
-
-            //TODO: Currently assuming a whole variable cache slice across all catchments for a single timestep...but some stuff here to support otherwise.
-            size_t cache_slices_t_n = read_len / cache_slice_t_size; // Integer division!
-            // For reference: https://stackoverflow.com/a/72030286
-            for( size_t i = 0; i < cache_slices_t_n; i++ ) {
-                std::shared_ptr<std::vector<double>> cached;
-                int cache_t_idx = (idx1 - (idx1 % cache_slice_t_size) + i);
-                std::string key = ncvar.getName() + "|" + std::to_string(cache_t_idx);
-                if(value_cache.contains(key)){
-                    cached = value_cache.get(key).get();
-                } else {
-                    cached = std::make_shared<std::vector<double>>(cache_slice_c_size * cache_slice_t_size);
-                    start.clear();
-                    start.push_back(0); // only always 0 when cache_slice_c_size = numids!
-                    start.push_back(cache_t_idx * cache_slice_t_size);
-                    count.clear();
-                    count.push_back(cache_slice_c_size);
-                    count.push_back(cache_slice_t_size); // Must be 1 for now!...probably...
-                    ncvar.getVar(start,count,&(*cached)[0]);
-                    value_cache.insert(key, cached);
-                }
-                for( size_t j = 0; j < cache_slice_t_size; j++){
-                    raw_values[i+j] = cached->at((j*cache_slice_t_size) + cat_pos);
-                }
-            }
-
-            
-            rvalue = 0.0;
-
-            double a , b = 0.0;
-            
-            a = 1.0 - ( (t1 - init_time) / time_stride );
-            rvalue += (a * raw_values[0]);
-
-            for( size_t i = 1; i < raw_values.size() -1; ++i )
+            try 
             {
-                rvalue += raw_values[i];
+                return UnitsHelper::get_converted_value(var_id_units[var_id], rvalue, selector.get_output_units());
             }
-
-            if (  raw_values.size() > 1) // likewise the last data value may not be fully in the window
+            catch (const std::runtime_error& e)
             {
-                b = (stop_time - t2) / time_stride;
-                rvalue += (b * raw_values.back() );
+                #ifndef UDUNITS_QUIET
+                std::cerr<<"WARN: Unit conversion unsuccessful - Returning unconverted value! (\""<<e.what()<<"\")"<<std::endl;
+                #endif
+                return rvalue;
             }
 
-            // account for the resampling methods
-            switch(m)
-            {
-                case SUM:   // we allready have the sum so do nothing
-                    ;
-                break;
-
-                case MEAN: 
-                { 
-                    // This is getting a length weighted mean
-                    // the data values where allready scaled for where there was only partial use of a data value
-                    // so we just need to do a final scale to account for the differnce between time_stride and duration_s
-
-                    double scale_factor = (selector.get_duration_secs() > time_stride ) ? (time_stride / selector.get_duration_secs()) : (1.0 / (a + b));
-                    rvalue *= scale_factor;
-                }
-                break;
+            return rvalue;
+        }
 
-                default:
-                    ;
+        /**
+         * Bind a catchment, variable, units and resampling method to a handle, resolving them and the units conversion
+         * once.
+         *
+         * @param id The catchment to read values for.
+         * @param variable_name The variable to read values of.
+         * @param output_units The units to convert values to.
+         * @param m How data is to be resampled if there is a mismatch in data alignment or repeat rate
+         * @return The handle, for use with @ref get_bound_value.
+         * @throws std::out_of_range If the file has no such catchment.
+         * @throws std::runtime_error If the file has no such variable.
+         */
+        value_handle_t bind_value(const std::string &id, const std::string &variable_name,
+                                  const std::string &output_units, ReSampleMethod m) override
+        {
+            auto pos = id_pos.find(id);
+            if (pos == id_pos.end()) {
+                throw std::out_of_range("Forcing file has no catchment " + id + SOURCE_LOC);
             }
-
-            try 
+            BoundValue bound;
+            bound.cat_pos = pos->second;
+            bound.var_id = get_var_id(variable_name);
+            bound.method = m;
+            try
             {
-                return UnitsHelper::get_converted_value(native_units, rvalue, selector.get_output_units());
+                bound.converter = UnitsHelper::get_shared_converter(var_id_units[bound.var_id], output_units);
             }
             catch (const std::runtime_error& e)
             {
                 #ifndef UDUNITS_QUIET
-                std::cerr<<"WARN: Unit conversion unsuccessful - Returning unconverted value! (\""<<e.what()<<"\")"<<std::endl;
+                std::cerr<<"WARN: Unit conversion unsuccessful - Returning unconverted values! (\""<<e.what()<<"\")"<<std::endl;
                 #endif
-                return rvalue;
             }
+            bound_values.push_back(bound);
+            return bound_values.size() - 1;
+        }
 
-            return rvalue;
+        double get_bound_value(value_handle_t handle, time_t init_time, long duration_s) override
+        {
+            const std::lock_guard<std::mutex> lock(netcdf_access_mutex);
+            const BoundValue &bound = bound_values[handle];
+            return UnitsHelper::convert_value(bound.converter.get(),
+                                              get_raw_value(bound.cat_pos, bound.var_id, init_time, duration_s, bound.method));
         }
 
         virtual std::vector<double> get_values(const CatchmentAggrDataSelector& selector, data_access::ReSampleMethod m) override
@@ -484,11 +509,113 @@ namespace data_access
             return std::vector<double>(1, get_value(selector, m));
         }
 
+        BatchPlan prepare_batch(const std::vector<std::string> &catchment_ids,
+                                const std::vector<std::string> &variable_names,
+                                const std::vector<std::string> &output_units,
+                                const std::vector<ReSampleMethod> &methods) override
+        {
+            BatchPlan plan = GenericDataProvider::prepare_batch(catchment_ids, variable_names, output_units, methods);
+            for (const std::string &id : catchment_ids) {
+                auto pos = id_pos.find(id);
+                if (pos == id_pos.end()) {
+                    throw std::out_of_range("Forcing file has no catchment " + id + SOURCE_LOC);
+                }
+                plan.catchment_indices.push_back(pos->second);
+            }
+            for (const std::string &name : variable_names) {
+                auto id = var_ids.find(name);
+                if (id == var_ids.end()) {
+                    throw std::out_of_range("Forcing file has no variable " + name + SOURCE_LOC);
+                }
+                plan.variable_indices.push_back(id->second);
+            }
+            return plan;
+        }
+
+        /**
+         * Read the values of every catchment and variable of a plan for a time period, converting units if needed.
+         *
+         * Each variable is summed over the time period for all the plan's catchments from the same cached chunks, and
+         * then has its units converted in one pass, giving the same values as @ref get_value.
+         *
+         * @param plan A plan prepared by this provider.
+         * @param init_time The epoch time (in seconds) of the start of the time period.
+         * @param duration_s The length of the time period, in seconds.
+         * @param values A buffer of at least @ref BatchPlan::size values to write the values to.
+         * @throws std::out_of_range If data for the time period is not available.
+         */
+        void get_batch_values(const BatchPlan &plan, time_t init_time, long duration_s, double *values) override
+        {
+            check_batch_plan(plan);
+            const std::lock_guard<std::mutex> lock(netcdf_access_mutex);
+
+            size_t idx1 = get_ts_index_for_time(init_time);
+            size_t idx2;
+            try {
+                idx2 = get_ts_index_for_time(init_time + duration_s - 1);
+            }
+            catch(const std::out_of_range &e){
+                idx2 = get_ts_index_for_time(this->stop_time-1); //to the edge
+            }
+
+            // The first and last time steps may only partly be in the time period
+            double a = 1.0 - ( (time_vals[idx1] - init_time) / time_stride );
+            double b = idx2 > idx1 ? (init_time + duration_s - time_vals[idx2]) / time_stride : 0.0;
+
+            const size_t catchment_count = plan.catchment_indices.size();
+            for (size_t v = 0; v < plan.variable_indices.size(); ++v) {
+                const size_t var_id = plan.variable_indices[v];
+                double *var_values = values + v * catchment_count;
+                std::fill(var_values, var_values + catchment_count, 0.0);
+
+                size_t idx = idx1;
+                while (idx <= idx2) {
+                    size_t chunk_idx = idx / cache_slice_t_size;
+                    size_t chunk_start = chunk_idx * cache_slice_t_size;
+                    std::shared_ptr<std::vector<double>> chunk = get_chunk(var_id_ncvars[var_id], var_id, chunk_idx);
+                    size_t chunk_len = chunk->size() / cache_slice_c_size;
+                    size_t chunk_stop = std::min(idx2 + 1, chunk_start + chunk_len);
+                    for (size_t c = 0; c < catchment_count; ++c) {
+                        const double *cat_values = chunk->data() + plan.catchment_indices[c] * chunk_len;
+                        double sum = 0.0;
+                        for (size_t i = idx; i < chunk_stop; ++i) {
+                            double weight = i == idx1 ? a : (i == idx2 ? b : 1.0);
+                            sum += weight * cat_values[i - chunk_start];
+                        }
+                        var_values[c] += sum;
+                    }
+                    idx = chunk_stop;
+                }
+
+                if (plan.methods[v] == MEAN) {
+                    double scale_factor = (duration_s > time_stride ) ? (time_stride / duration_s) : (1.0 / (a + b));
+                    for (size_t c = 0; c < catchment_count; ++c) {
+                        var_values[c] *= scale_factor;
+                    }
+                }
+
+                try
+                {
+                    UnitsHelper::convert_values(var_id_units[var_id], var_values, plan.output_units[v], var_values, catchment_count);
+                }
+                catch (const std::runtime_error& e)
+                {
+                    #ifndef UDUNITS_QUIET
+                    std::cerr<<"WARN: Unit conversion unsuccessful - Returning unconverted value! (\""<<e.what()<<"\")"<<std::endl;
+                    #endif
+                }
+            }
+        }
+
 
         private:
 
+        // Gridded forcing is read through the same NetCDF library, so shares the lock on it
+        friend class GriddedForcingProvider;
+
         static std::mutex shared_providers_mutex;
         static std::map<std::string, std::shared_ptr<NetCDFPerFeatureDataProvider>> shared_providers;
+        static std::mutex netcdf_access_mutex;
 
         std::vector<std::string> variable_names;
         std::vector<std::string> loc_ids;
@@ -503,28 +630,136 @@ namespace data_access
 
         std::shared_ptr<NcFile> nc_file;
 
-        std::map<std::string,netCDF::NcVar> ncvar_cache = {};
-        std::map<std::string,std::string> units_cache = {};
-        boost::compute::detail::lru_cache<std::string, std::shared_ptr<std::vector<double>>> value_cache;
+        /** Integer ids of the variables, by each of their names, for keying cached chunks. */
+        std::map<std::string,size_t> var_ids = {};
+        /** The variables, by their integer ids. */
+        std::vector<netCDF::NcVar> var_id_ncvars = {};
+        /** The native units of the variables, by their integer ids. */
+        std::vector<std::string> var_id_units = {};
+        /** A catchment, variable, resampling method and units conversion bound to a handle. */
+        struct BoundValue
+        {
+            size_t cat_pos;
+            size_t var_id;
+            ReSampleMethod method;
+            std::shared_ptr<cv_converter> converter;
+        };
+        /** Values bound by @ref bind_value, by handle. */
+        std::deque<BoundValue> bound_values;
+        /** Chunks of values of one variable for every catchment, keyed by (variable id, chunk index) */
+        std::unique_ptr<boost::compute::detail::lru_cache<uint64_t, std::shared_ptr<std::vector<double>>>> value_cache;
         size_t cache_slice_t_size = 1;
         size_t cache_slice_c_size = 1;
+        size_t num_time_steps = 0;
+        size_t num_time_chunks = 0;
+        size_t cache_chunk_bytes = 0;
 
-        const netCDF::NcVar& get_ncvar(const std::string& name){
-            auto cache_hit = ncvar_cache.find(name);
-            if(cache_hit != ncvar_cache.end()){
-                return cache_hit->second;
+        /**
+         * Get the value of a variable for a catchment for an arbitrary time period, in its native units.
+         *
+         * The NetCDF access mutex must be held.
+         *
+         * @param cat_pos The position of the catchment in the file.
+         * @param var_id The id of the variable.
+         * @param init_time The epoch time (in seconds) of the start of the time period.
+         * @param duration_s The length of the time period, in seconds.
+         * @param m How data is to be resampled if there is a mismatch in data alignment or repeat rate
+         * @return The value for the described time period.
+         * @throws std::out_of_range If data for the time period is not available.
+         */
+        double get_raw_value(size_t cat_pos, size_t var_id, time_t init_time, long duration_s, ReSampleMethod m)
+        {
+            auto stop_time = init_time + duration_s; // scope hiding! BAD JUJU!
+            
+            size_t idx1 = get_ts_index_for_time(init_time);
+            size_t idx2;
+            try {
+                idx2 = get_ts_index_for_time(stop_time-1); // Don't include next timestep when duration % timestep = 0
+            }
+            catch(const std::out_of_range &e){
+                idx2 = get_ts_index_for_time(this->stop_time-1); //to the edge
             }
 
-            throw std::runtime_error("Got request for variable " + name + " but it was not found in the cache. This should not happen." + SOURCE_LOC);
+            double t1 = time_vals[idx1];
+            double t2 = time_vals[idx2];
+
+            // Weight the first and last values by how much of their time steps are in the window, and sum them
+            // straight out of each chunk covering the time steps
+            double a = 1.0 - ( (t1 - init_time) / time_stride );
+            double b = idx2 > idx1 ? (stop_time - t2) / time_stride : 0.0;
+            double rvalue = 0.0;
+            size_t idx = idx1;
+            while (idx <= idx2) {
+                size_t chunk_idx = idx / cache_slice_t_size;
+                size_t chunk_start = chunk_idx * cache_slice_t_size;
+                std::shared_ptr<std::vector<double>> chunk = get_chunk(var_id_ncvars[var_id], var_id, chunk_idx);
+                size_t chunk_len = chunk->size() / cache_slice_c_size;
+                const double *cat_values = chunk->data() + cat_pos * chunk_len;
+                for (; idx <= idx2 && idx < chunk_start + chunk_len; ++idx) {
+                    double weight = idx == idx1 ? a : (idx == idx2 ? b : 1.0);
+                    rvalue += weight * cat_values[idx - chunk_start];
+                }
+            }
+
+            // account for the resampling methods
+            switch(m)
+            {
+                case SUM:   // we allready have the sum so do nothing
+                    ;
+                break;
+
+                case MEAN: 
+                { 
+                    // This is getting a length weighted mean
+                    // the data values where allready scaled for where there was only partial use of a data value
+                    // so we just need to do a final scale to account for the differnce between time_stride and duration_s
+
+                    double scale_factor = (duration_s > time_stride ) ? (time_stride / duration_s) : (1.0 / (a + b));
+                    rvalue *= scale_factor;
+                }
+                break;
+
+                default:
+                    ;
+            }
+
+            return rvalue;
         }
 
-        const std::string& get_ncvar_units(const std::string& name){
-            auto cache_hit = units_cache.find(name);
-            if(cache_hit != units_cache.end()){
+        /**
+         * Get a chunk of values of a variable, reading it from the file if it is not cached.
+         *
+         * The chunk holds every catchment's values for a run of (usually @ref cache_slice_t_size) time steps, with the
+         * values of each catchment contiguous.
+         *
+         * @param ncvar The variable.
+         * @param var_id The id of the variable.
+         * @param chunk_idx The index of the chunk, counting in runs of @ref cache_slice_t_size time steps.
+         * @return The chunk.
+         */
+        std::shared_ptr<std::vector<double>> get_chunk(const netCDF::NcVar &ncvar, size_t var_id, size_t chunk_idx){
+            uint64_t key = (uint64_t) var_id * num_time_chunks + chunk_idx;
+            auto cached = value_cache->get(key);
+            if(cached){
+                return cached.get();
+            }
+            size_t chunk_start = chunk_idx * cache_slice_t_size;
+            size_t chunk_len = std::min(cache_slice_t_size, num_time_steps - chunk_start);
+            auto chunk = std::make_shared<std::vector<double>>(cache_slice_c_size * chunk_len);
+            std::vector<size_t> start = {0, chunk_start};
+            std::vector<size_t> count = {cache_slice_c_size, chunk_len};
+            ncvar.getVar(start, count, chunk->data());
+            value_cache->insert(key, chunk);
+            return chunk;
+        }
+
+        size_t get_var_id(const std::string& name){
+            auto cache_hit = var_ids.find(name);
+            if(cache_hit != var_ids.end()){
                 return cache_hit->second;
             }
 
-            throw std::runtime_error("Got units request for variable " + name + " but it was not found in the cache. This should not happen." + SOURCE_LOC);
+            throw std::runtime_error("Got request for variable " + name + " but it was not found in the cache. This should not happen." + SOURCE_LOC);
         }
 
     };
@@ -349,6 +349,18 @@ namespace data_access {
         }
 
     protected:
+        /**
+         * Get whether values of an output bound by @ref bind_value are to be read straight from the wrapped provider.
+         *
+         * This is only so for outputs without a default, as the choice between a default and the wrapped provider's
+         * value is made by @ref get_value each time.
+         *
+         * @param outputName The output in question.
+         * @return Whether values of the output are read straight from the wrapped provider, which must be set.
+         */
+        bool isBoundValueForwarded(const string &outputName) override {
+            return isWrappedProviderSet() && !isSuppliedWithDefault(outputName) && isSuppliedByWrappedProvider(outputName);
+        }
 
         /**
          * Record that there was an instance of a default value being used and manage the default usage "waits."
@@ -0,0 +1,505 @@
+#ifndef NGEN_PREFETCHING_DATA_PROVIDER_HPP
+#define NGEN_PREFETCHING_DATA_PROVIDER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "AsyncDataProvider.hpp"
+#include "GenericDataProvider.hpp"
+
+namespace data_access
+{
+    /**
+     * A provider that reads the values of another provider a window of time ahead, on a background thread.
+     *
+     * Time is divided into windows of a fixed number of the wrapped provider's time steps.  Each bound value (see
+     * @ref bind_value) keeps its own window, so callers running at different paces (e.g., catchments run as a
+     * wavefront) each have theirs read ahead.  When a caller's reads of a bound value move into a new window, the
+     * background thread starts reading that value for the window after it, a period of the length last asked for at
+     * a time.  So while a model computes with the values of one window, the values of the next one are read into a
+     * second buffer, which is handed over once complete.  Values read through @ref get_value are bound on first use,
+     * by catchment, variable, units and resampling method.
+     *
+     * Reads that were not read ahead (e.g., in a caller's first window, or at times that do not line up with the
+     * periods read ahead) are passed straight to the wrapped provider.  The time spent on these and on waiting for the
+     * background thread to finish a window is counted as stall time.
+     *
+     * The wrapped provider must allow being read from two threads at once.
+     */
+    class PrefetchingDataProvider : public GenericDataProvider, public AsyncDataProvider<double, CatchmentAggrDataSelector>
+    {
+        public:
+
+        /**
+         * @brief Factory method that creates or returns an existing prefetching provider wrapping the given provider.
+         *
+         * @param provider The provider to read values from.
+         * @param window_time_steps The number of the provider's time steps in each window read ahead. If a
+         * prefetching provider for the given provider already exists, this argument will be ignored.
+         * @return A prefetching provider wrapping the given provider.
+         */
+        static std::shared_ptr<PrefetchingDataProvider> get_shared_provider(std::shared_ptr<GenericDataProvider> provider,
+                                                                            size_t window_time_steps)
+        {
+            SharedProviders &shared = get_shared_providers_registry();
+            const std::lock_guard<std::mutex> lock(shared.mutex);
+            std::shared_ptr<PrefetchingDataProvider> p = shared.providers[provider.get()].lock();
+            if (p == nullptr) {
+                p = std::make_shared<PrefetchingDataProvider>(provider, window_time_steps);
+                shared.providers[provider.get()] = p;
+            }
+            return p;
+        }
+
+        /**
+         * @brief Get the prefetching providers created by @ref get_shared_provider that are still in use.
+         *
+         * @return The shared prefetching providers still in use, e.g. to report their statistics at the end of a run.
+         */
+        static std::vector<std::shared_ptr<PrefetchingDataProvider>> get_shared_providers()
+        {
+            SharedProviders &shared = get_shared_providers_registry();
+            const std::lock_guard<std::mutex> lock(shared.mutex);
+            std::vector<std::shared_ptr<PrefetchingDataProvider>> providers;
+            for (auto &entry : shared.providers) {
+                std::shared_ptr<PrefetchingDataProvider> p = entry.second.lock();
+                if (p != nullptr) {
+                    providers.push_back(p);
+                }
+            }
+            return providers;
+        }
+
+        /**
+         * Create a provider and start its background thread.
+         *
+         * @param provider The provider to read values from.
+         * @param window_time_steps The number of the provider's time steps in each window read ahead; at least 1.
+         */
+        PrefetchingDataProvider(std::shared_ptr<GenericDataProvider> provider, size_t window_time_steps) :
+            wrapped_provider(std::move(provider))
+        {
+            data_start_time = wrapped_provider->get_data_start_time();
+            data_stop_time = wrapped_provider->get_data_stop_time();
+            window_seconds = (window_time_steps > 0 ? window_time_steps : 1) * wrapped_provider->record_duration();
+            prefetch_thread = std::thread(&PrefetchingDataProvider::prefetch_loop, this);
+        }
+
+        /**
+         * Stop the background thread.
+         */
+        ~PrefetchingDataProvider() override
+        {
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex);
+                stopping = true;
+            }
+            work_ready.notify_all();
+            prefetch_thread.join();
+        }
+
+        PrefetchingDataProvider(const PrefetchingDataProvider&) = delete;
+        PrefetchingDataProvider& operator=(const PrefetchingDataProvider&) = delete;
+
+        const std::vector<std::string> &get_avaliable_variable_names() override {
+            return wrapped_provider->get_avaliable_variable_names();
+        }
+
+        long get_data_start_time() override {
+            return wrapped_provider->get_data_start_time();
+        }
+
+        long get_data_stop_time() override {
+            return wrapped_provider->get_data_stop_time();
+        }
+
+        long record_duration() override {
+            return wrapped_provider->record_duration();
+        }
+
+        size_t get_ts_index_for_time(const time_t &epoch_time) override {
+            return wrapped_provider->get_ts_index_for_time(epoch_time);
+        }
+
+        /**
+         * Get the value of a forcing property for an arbitrary time period, converting units if needed.
+         *
+         * The value is taken from what was read ahead if it is there, and otherwise read from the wrapped provider.
+         * Callers reading the same value repeatedly should bind it with @ref bind_value instead, which saves looking
+         * it up by name each time.
+         *
+         * @param selector Data required to establish what subset of the stored data should be accessed
+         * @param m How data is to be resampled if there is a mismatch in data alignment or repeat rate
+         * @return The value of the forcing property for the described time period, with units converted if needed.
+         * @throws std::out_of_range If data for the time period is not available.
+         */
+        double get_value(const CatchmentAggrDataSelector& selector, ReSampleMethod m=SUM) override
+        {
+            return get_binding_value(get_selector_binding(selector, m), selector.get_init_time(),
+                                     selector.get_duration_secs());
+        }
+
+        /**
+         * Get the values of a forcing property for an arbitrary time period, which are not read ahead.
+         */
+        std::vector<double> get_values(const CatchmentAggrDataSelector& selector, ReSampleMethod m=SUM) override
+        {
+            return wrapped_provider->get_values(selector, m);
+        }
+
+        bool is_property_sum_over_time_step(const std::string& name) override {
+            return wrapped_provider->is_property_sum_over_time_step(name);
+        }
+
+        std::string get_variable_units(const std::string &variable_name) override {
+            return wrapped_provider->get_variable_units(variable_name);
+        }
+
+        /**
+         * @brief Bind a value to a handle, for reading it quickly and having it read ahead for its caller.
+         *
+         * The value is bound twice with the wrapped provider, once for the caller to read what was not read ahead,
+         * and once for the background thread, so the two never read through the same handle at once.
+         */
+        value_handle_t bind_value(const std::string &id, const std::string &variable_name,
+                                  const std::string &output_units, ReSampleMethod m=SUM) override
+        {
+            std::unique_ptr<Binding> binding(new Binding());
+            binding->bound = true;
+            binding->caller_handle = wrapped_provider->bind_value(id, variable_name, output_units, m);
+            binding->prefetch_handle = wrapped_provider->bind_value(id, variable_name, output_units, m);
+            bound_values.push_back(std::move(binding));
+            return bound_values.size() - 1;
+        }
+
+        double get_bound_value(value_handle_t handle, time_t init_time, long duration_s) override
+        {
+            return get_binding_value(*bound_values.at(handle), init_time, duration_s);
+        }
+
+        bool value_ready(const CatchmentAggrDataSelector& selector, ReSampleMethod m=SUM) override
+        {
+            Binding *binding = find_selector_binding(selector, m);
+            if (binding == nullptr) {
+                return false;
+            }
+            std::lock_guard<std::mutex> lock(binding->mutex);
+            size_t slot;
+            return find_slot(*binding, selector.get_init_time(), selector.get_duration_secs(), slot)
+                   && binding->current.ready[slot];
+        }
+
+        /**
+         * Request that a value be read ahead, from the window after the next one it is read in.
+         */
+        void request_value(const CatchmentAggrDataSelector& selector, ReSampleMethod m=SUM) override
+        {
+            Binding &binding = get_selector_binding(selector, m);
+            std::lock_guard<std::mutex> lock(binding.mutex);
+            if (binding.duration_s == 0) {
+                binding.duration_s = selector.get_duration_secs();
+            }
+        }
+
+        /**
+         * @return The total time, in seconds, that callers have spent waiting on reads.
+         */
+        double get_stall_seconds()
+        {
+            std::chrono::steady_clock::duration stall_time = std::chrono::steady_clock::duration::zero();
+            for_each_binding([&](Binding &binding) { stall_time += binding.stall_time; });
+            return std::chrono::duration<double>(stall_time).count();
+        }
+
+        /**
+         * @return The number of values callers have read that were read ahead.
+         */
+        size_t get_hits()
+        {
+            size_t hits = 0;
+            for_each_binding([&](Binding &binding) { hits += binding.hits; });
+            return hits;
+        }
+
+        /**
+         * @return The number of values callers have read from the wrapped provider on demand.
+         */
+        size_t get_misses()
+        {
+            size_t misses = 0;
+            for_each_binding([&](Binding &binding) { misses += binding.misses; });
+            return misses;
+        }
+
+        private:
+
+        /** The prefetching providers shared by @ref get_shared_provider, by the provider each wraps. */
+        struct SharedProviders
+        {
+            std::mutex mutex;
+            std::map<GenericDataProvider*, std::weak_ptr<PrefetchingDataProvider>> providers;
+        };
+
+        static SharedProviders& get_shared_providers_registry()
+        {
+            static SharedProviders shared;
+            return shared;
+        }
+
+        /** The values of a binding for one window, a period of the binding's duration at a time. */
+        struct Buffer
+        {
+            long window = -1;
+            std::vector<double> values;
+            std::vector<char> ready;
+        };
+
+        /** A bound value, and what has been read ahead of it for its caller. */
+        struct Binding
+        {
+            /** Whether the value is read through handles of the wrapped provider, rather than @ref selector. */
+            bool bound = false;
+            value_handle_t caller_handle = 0;
+            value_handle_t prefetch_handle = 0;
+            CatchmentAggrDataSelector selector;
+            ReSampleMethod method = SUM;
+
+            // Guarded by mutex
+            std::mutex mutex;
+            std::condition_variable fill_done;
+            /** The length of the periods read ahead, which is the one last asked for, or 0 if none yet. */
+            long duration_s = 0;
+            /** The values for the window the caller is currently in. */
+            Buffer current;
+            /** The values for the window after it, which the background thread may still be reading. */
+            Buffer next;
+            bool filling = false;
+            bool cancel_fill = false;
+            size_t hits = 0;
+            size_t misses = 0;
+            std::chrono::steady_clock::duration stall_time = std::chrono::steady_clock::duration::zero();
+        };
+
+        typedef std::tuple<std::string, std::string, std::string, int> Selector_Key;
+
+        long get_window(time_t init_time) const
+        {
+            const time_t offset = init_time - data_start_time;
+            return offset >= 0 ? offset / window_seconds : -1 - (-offset - 1) / window_seconds;
+        }
+
+        /**
+         * Find the slot of the current buffer of a binding that a period would be read ahead into, if any.  The
+         * binding's mutex must be held.
+         */
+        bool find_slot(const Binding &binding, time_t init_time, long duration_s, size_t &slot) const
+        {
+            if (duration_s != binding.duration_s || duration_s <= 0 || get_window(init_time) != binding.current.window) {
+                return false;
+            }
+            const time_t offset = init_time - (data_start_time + binding.current.window * window_seconds);
+            if (offset % duration_s != 0 || (size_t) (offset / duration_s) >= binding.current.ready.size()) {
+                return false;
+            }
+            slot = offset / duration_s;
+            return true;
+        }
+
+        Binding *find_selector_binding(const CatchmentAggrDataSelector& selector, ReSampleMethod m)
+        {
+            std::lock_guard<std::mutex> lock(selector_bindings_mutex);
+            auto it = selector_bindings.find(Selector_Key(selector.get_id(), selector.get_variable_name(),
+                                                          selector.get_output_units(), (int) m));
+            return it == selector_bindings.end() ? nullptr : it->second.get();
+        }
+
+        /** Get the binding of the value read through a selector, binding it if it is the first time. */
+        Binding &get_selector_binding(const CatchmentAggrDataSelector& selector, ReSampleMethod m)
+        {
+            std::lock_guard<std::mutex> lock(selector_bindings_mutex);
+            std::unique_ptr<Binding> &binding = selector_bindings[Selector_Key(
+                    selector.get_id(), selector.get_variable_name(), selector.get_output_units(), (int) m)];
+            if (!binding) {
+                binding.reset(new Binding());
+                binding->selector = selector;
+                binding->method = m;
+            }
+            return *binding;
+        }
+
+        template <class Visitor> void for_each_binding(Visitor visit)
+        {
+            for (const std::unique_ptr<Binding> &binding : bound_values) {
+                std::lock_guard<std::mutex> lock(binding->mutex);
+                visit(*binding);
+            }
+            std::lock_guard<std::mutex> selector_lock(selector_bindings_mutex);
+            for (const auto &binding : selector_bindings) {
+                std::lock_guard<std::mutex> lock(binding.second->mutex);
+                visit(*binding.second);
+            }
+        }
+
+        /** Read a binding's value from the wrapped provider, through the handle of the caller or the background thread. */
+        double read_value(Binding &binding, bool prefetching, time_t init_time, long duration_s)
+        {
+            if (binding.bound) {
+                return wrapped_provider->get_bound_value(prefetching ? binding.prefetch_handle : binding.caller_handle,
+                                                         init_time, duration_s);
+            }
+            CatchmentAggrDataSelector selector = binding.selector;
+            selector.set_init_time(init_time);
+            selector.set_duration_secs(duration_s);
+            return wrapped_provider->get_value(selector, binding.method);
+        }
+
+        double get_binding_value(Binding &binding, time_t init_time, long duration_s)
+        {
+            {
+                std::unique_lock<std::mutex> lock(binding.mutex);
+                if (duration_s != binding.duration_s) {
+                    // What was read ahead is for periods of another length, so start over with this one
+                    binding.duration_s = duration_s;
+                    binding.current = Buffer();
+                }
+                const long window = get_window(init_time);
+                if (window > binding.current.window) {
+                    advance_to(binding, window, lock);
+                }
+                size_t slot;
+                if (find_slot(binding, init_time, duration_s, slot) && binding.current.ready[slot]) {
+                    ++binding.hits;
+                    return binding.current.values[slot];
+                }
+                ++binding.misses;
+            }
+
+            auto read_start = std::chrono::steady_clock::now();
+            double value = read_value(binding, false, init_time, duration_s);
+            auto read_time = std::chrono::steady_clock::now() - read_start;
+            std::lock_guard<std::mutex> lock(binding.mutex);
+            binding.stall_time += read_time;
+            return value;
+        }
+
+        /**
+         * Move a binding's current window forward, handing over what was read ahead for it if anything, and have the
+         * background thread start reading the window after it.  The binding's mutex must be held through the given
+         * lock.
+         */
+        void advance_to(Binding &binding, long window, std::unique_lock<std::mutex> &lock)
+        {
+            if (binding.next.window == window
+                && (time_t) binding.next.values.size() * binding.duration_s == window_seconds) {
+                if (binding.filling) {
+                    auto wait_start = std::chrono::steady_clock::now();
+                    binding.fill_done.wait(lock, [&] { return !binding.filling; });
+                    binding.stall_time += std::chrono::steady_clock::now() - wait_start;
+                }
+                std::swap(binding.current, binding.next);
+            }
+            else {
+                // Nothing read ahead for this window, e.g. at the start or after the caller skipped a window
+                binding.cancel_fill = binding.filling;
+                binding.fill_done.wait(lock, [&] { return !binding.filling; });
+                binding.cancel_fill = false;
+                binding.current.window = window;
+                binding.current.values.clear();
+                binding.current.ready.clear();
+            }
+
+            const time_t next_start = data_start_time + (window + 1) * window_seconds;
+            const size_t slots = binding.duration_s > 0 ? window_seconds / binding.duration_s : 0;
+            if (next_start < data_stop_time && slots > 0 && window_seconds % binding.duration_s == 0) {
+                binding.next.window = window + 1;
+                binding.next.values.assign(slots, 0.0);
+                binding.next.ready.assign(slots, 0);
+                binding.filling = true;
+                {
+                    std::lock_guard<std::mutex> queue_lock(queue_mutex);
+                    fill_queue.push_back(&binding);
+                }
+                work_ready.notify_one();
+            }
+            else {
+                binding.next.window = -1;
+            }
+        }
+
+        void prefetch_loop()
+        {
+            while (true) {
+                Binding *binding;
+                {
+                    std::unique_lock<std::mutex> queue_lock(queue_mutex);
+                    work_ready.wait(queue_lock, [this] { return stopping || !fill_queue.empty(); });
+                    if (stopping) {
+                        return;
+                    }
+                    binding = fill_queue.front();
+                    fill_queue.pop_front();
+                }
+                fill(*binding);
+            }
+        }
+
+        /** Read the next window of a binding into its next buffer.  Only used by the background thread. */
+        void fill(Binding &binding)
+        {
+            std::unique_lock<std::mutex> lock(binding.mutex);
+            const time_t window_start = data_start_time + binding.next.window * window_seconds;
+            const long duration_s = binding.duration_s;
+            for (size_t i = 0; i < binding.next.values.size() && !binding.cancel_fill; ++i) {
+                const time_t init_time = window_start + (time_t) i * duration_s;
+                if (init_time >= data_stop_time) {
+                    break;
+                }
+                lock.unlock();
+                double value = 0.0;
+                bool read = true;
+                try {
+                    value = read_value(binding, true, init_time, duration_s);
+                }
+                catch (...) {
+                    // Left for the caller to read on demand, which raises the error where it can be handled
+                    read = false;
+                }
+                lock.lock();
+                binding.next.values[i] = value;
+                binding.next.ready[i] = read ? 1 : 0;
+            }
+            binding.filling = false;
+            binding.fill_done.notify_all();
+        }
+
+        std::shared_ptr<GenericDataProvider> wrapped_provider;
+        time_t data_start_time;
+        time_t data_stop_time;
+        time_t window_seconds;
+
+        /** Values bound by @ref bind_value, by handle; only added to while setting up, so read without a lock. */
+        std::deque<std::unique_ptr<Binding>> bound_values;
+
+        std::mutex selector_bindings_mutex;
+        /** Values read through @ref get_value, bound on first use. */
+        std::map<Selector_Key, std::unique_ptr<Binding>> selector_bindings;
+
+        std::mutex queue_mutex;
+        std::condition_variable work_ready;
+        /** Bindings whose next window the background thread is to read, in the order asked for. */
+        std::deque<Binding*> fill_queue;
+        bool stopping = false;
+
+        std::thread prefetch_thread;
+    };
+}
+
+#endif // NGEN_PREFETCHING_DATA_PROVIDER_HPP
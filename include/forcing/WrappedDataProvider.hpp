@@ -55,6 +55,10 @@ namespace data_access {
             return wrapped_provider->get_avaliable_variable_names();
         }
 
+        std::string get_variable_units(const std::string &variable_name) override {
+            return wrapped_provider->get_variable_units(variable_name);
+        }
+
         /**
          * Get the inclusive beginning of the period of time over which this instance can provide data for this forcing.
          *
@@ -112,6 +116,17 @@ namespace data_access {
             return wrapped_provider->get_values(selector, m);
         }
 
+        value_handle_t bind_value(const std::string &id, const std::string &variable_name,
+                                  const std::string &output_units, ReSampleMethod m) override
+        {
+            return wrapped_provider->bind_value(id, variable_name, output_units, m);
+        }
+
+        double get_bound_value(value_handle_t handle, time_t init_time, long duration_s) override
+        {
+            return wrapped_provider->get_bound_value(handle, init_time, duration_s);
+        }
+
         /**
          * Get whether a property's per-time-step values are each an aggregate sum over the entire time step.
          *
@@ -2,6 +2,9 @@
 #define NGEN_ABSTRACTCLIBBMIADAPTER_HPP
 
 #include <dlfcn.h>
+#include <map>
+#include <memory>
+#include <mutex>
 #include "Bmi_Adapter.hpp"
 #include "ExternalIntegrationException.hpp"
 #include "State_Exception.hpp"
@@ -9,6 +12,46 @@
 namespace models {
     namespace bmi {
 
+        /**
+         * A dynamically loaded shared library, shared by the adapters of every model loaded from it.
+         *
+         * Loading a library, and looking up its symbols, is done once per process for every adapter using the same
+         * library, rather than once per adapter (e.g., per catchment).  The library is closed when the last adapter
+         * using it is destroyed.
+         */
+        struct DynamicLibrary
+        {
+            DynamicLibrary(void *handle, std::string path) : handle(handle), path(std::move(path)) { }
+
+            DynamicLibrary(const DynamicLibrary &) = delete;
+            DynamicLibrary &operator=(const DynamicLibrary &) = delete;
+
+            ~DynamicLibrary() {
+                dlclose(handle);
+            }
+
+            /** The handle from ``dlopen``. */
+            void *handle;
+            /** The path the library was loaded from. */
+            const std::string path;
+            /** The addresses of the symbols of the library looked up so far, by name. */
+            std::map<std::string, void *> symbols;
+            /** Guards @ref symbols. */
+            std::mutex symbols_mutex;
+
+            /** The mutex guarding @ref get_loaded_libraries, which must be held while using it. */
+            static std::mutex &get_loaded_libraries_mutex() {
+                static std::mutex loaded_libraries_mutex;
+                return loaded_libraries_mutex;
+            }
+
+            /** The libraries loaded by any adapter and still in use, by the path each was configured with. */
+            static std::map<std::string, std::weak_ptr<DynamicLibrary>> &get_loaded_libraries() {
+                static std::map<std::string, std::weak_ptr<DynamicLibrary>> loaded_libraries;
+                return loaded_libraries;
+            }
+        };
+
         template <class C>
         class AbstractCLibBmiAdapter : public Bmi_Adapter<C> {
 
@@ -38,11 +81,8 @@ namespace models {
                     Bmi_Adapter<C>(std::move(adapter)),
                     bmi_lib_file(std::move(adapter.bmi_lib_file)),
                     bmi_registration_function(adapter.bmi_registration_function),
-                    dyn_lib_handle(adapter.dyn_lib_handle)
-            {
-                // Have to make sure to do this after "moving" so the original does not close the dynamically loaded library handle
-                adapter.dyn_lib_handle = nullptr;
-            }
+                    dyn_lib(std::move(adapter.dyn_lib))
+            { }
 
             /**
              * Class destructor.
@@ -76,6 +116,9 @@ namespace models {
 
             /**
              * Dynamically load and obtain this instance's handle to the shared library.
+             *
+             * The library is only loaded by the first adapter to use it, and shared with any others using it at the
+             * same time.
              */
             inline void dynamic_library_load() {
                 if (bmi_registration_function.empty()) {
@@ -83,11 +126,20 @@ namespace models {
                             "Can't init " + this->model_name + "; empty name given for library's registration function.";
                     throw std::runtime_error(this->init_exception_msg);
                 }
-                if (dyn_lib_handle != nullptr) {
+                if (dyn_lib != nullptr) {
                     this->output.put("WARNING: ignoring attempt to reload dynamic shared library '" + bmi_lib_file +
                     "' for " + this->model_name);
                     return;
                 }
+
+                const std::lock_guard<std::mutex> lock(DynamicLibrary::get_loaded_libraries_mutex());
+                std::weak_ptr<DynamicLibrary> &loaded = DynamicLibrary::get_loaded_libraries()[bmi_lib_file];
+                dyn_lib = loaded.lock();
+                if (dyn_lib != nullptr) {
+                    bmi_lib_file = dyn_lib->path;
+                    return;
+                }
+
                 if (!utils::FileChecker::file_is_readable(bmi_lib_file)) {
                     //Try alternative extension...
                     size_t idx = bmi_lib_file.rfind(".");
@@ -120,7 +172,7 @@ namespace models {
                 // Call first to ensure any previous error is cleared before trying to load the symbol
                 dlerror();
                 // Load up the necessary library dynamically
-                dyn_lib_handle = dlopen(bmi_lib_file.c_str(), RTLD_NOW | RTLD_LOCAL);
+                void *dyn_lib_handle = dlopen(bmi_lib_file.c_str(), RTLD_NOW | RTLD_LOCAL);
                 // Now call again to see if there was an error (if there was, this will not be null)
                 char *err_message = dlerror();
                 if (dyn_lib_handle == nullptr && err_message != nullptr) {
@@ -130,6 +182,10 @@ namespace models {
                     }
                     throw ::external::ExternalIntegrationException(this->init_exception_msg);
                 }
+                if (dyn_lib_handle != nullptr) {
+                    dyn_lib = std::make_shared<DynamicLibrary>(dyn_lib_handle, bmi_lib_file);
+                    loaded = dyn_lib;
+                }
             }
 
             /**
@@ -145,7 +201,7 @@ namespace models {
              * ``is_null_valid`` parameter.  When ``true``, a null symbol will be returned by the function.
              *
              * Typically, a call to @see dynamic_library_load must happen (though not necessarily have completed) before
-             * a call to this function to ensure @see dyn_lib_handle is set.  If it is not set, an exception is thrown.
+             * a call to this function to ensure @see dyn_lib is set.  If it is not set, an exception is thrown.
              *
              * @param symbol_name The name of the symbol to load.
              * @param is_null_valid Whether a null address for the symbol is valid, as opposed to implying there was
@@ -155,12 +211,18 @@ namespace models {
              * @throws ``::external::ExternalIntegrationException`` If symbol could not be found for the shared library.
              */
             inline void *dynamic_load_symbol(const std::string &symbol_name, bool is_null_valid) {
-                if (dyn_lib_handle == nullptr) {
+                if (dyn_lib == nullptr) {
                     throw std::runtime_error("Cannot load symbol " + symbol_name + " without handle to shared library");
                 }
+                // Symbols already looked up by any adapter using the library are reused
+                const std::lock_guard<std::mutex> lock(dyn_lib->symbols_mutex);
+                auto symbol_it = dyn_lib->symbols.find(symbol_name);
+                if (symbol_it != dyn_lib->symbols.end() && (symbol_it->second != nullptr || is_null_valid)) {
+                    return symbol_it->second;
+                }
                 // Call first to ensure any previous error is cleared before trying to load the symbol
                 dlerror();
-                void *symbol = dlsym(dyn_lib_handle, symbol_name.c_str());
+                void *symbol = dlsym(dyn_lib->handle, symbol_name.c_str());
                 // Now call again to see if there was an error (if there was, this will not be null)
                 char *err_message = dlerror();
                 if (symbol == nullptr && (err_message != nullptr || !is_null_valid)) {
@@ -170,6 +232,7 @@ namespace models {
                     }
                     throw ::external::ExternalIntegrationException(this->init_exception_msg);
                 }
+                dyn_lib->symbols[symbol_name] = symbol;
                 return symbol;
             }
 
@@ -194,7 +257,7 @@ namespace models {
             }
 
             inline const void *get_dyn_lib_handle() {
-                return dyn_lib_handle;
+                return dyn_lib == nullptr ? nullptr : dyn_lib->handle;
             }
 
         private:
@@ -203,8 +266,8 @@ namespace models {
             std::string bmi_lib_file;
             /** Name of the function that registers BMI struct's function pointers to the right module functions. */
             const std::string bmi_registration_function;
-            /** Handle for dynamically loaded library file. */
-            void *dyn_lib_handle = nullptr;
+            /** The dynamically loaded library file, shared with other adapters using it. */
+            std::shared_ptr<DynamicLibrary> dyn_lib;
 
             /**
              * A non-virtual equivalent for the virtual @see Finalize.
@@ -216,10 +279,8 @@ namespace models {
              * non-virtual, and can therefore be called by a destructor.
              */
             void finalizeForLibAbstraction() {
-                //  close the dynamically loaded library
-                if (dyn_lib_handle != nullptr) {
-                    dlclose(dyn_lib_handle);
-                }
+                //  release the dynamically loaded library, which is closed once no other adapter is using it
+                dyn_lib.reset();
             }
         };
 
@@ -256,6 +256,17 @@ namespace models {
                 return model_initialized;
             }
 
+            /**
+             * Get whether ``GetValuePtr`` gives the model's own memory for a variable, so that writing through the
+             * pointer sets the variable.
+             *
+             * @return Whether variables can be set by writing through their value pointers, which is ``false`` unless
+             *         overridden.
+             */
+            virtual bool is_value_ptr_writable() {
+                return false;
+            }
+
         protected:
             /** Whether model ``Update`` calls are allowed and handled in some way by the backing model. */
             bool allow_model_exceed_end_time = false;
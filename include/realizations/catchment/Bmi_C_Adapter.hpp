@@ -279,6 +279,10 @@ namespace models {
 
             void GetGridNodesPerFace(const int grid, int *nodes_per_face) override;
 
+            bool is_value_ptr_writable() override {
+                return true;
+            }
+
             void *GetValuePtr(std::string name) override {
                 void *dest;
                 if (bmi_model->get_value_ptr(bmi_model.get(), name.c_str(), &dest) != BMI_SUCCESS) {
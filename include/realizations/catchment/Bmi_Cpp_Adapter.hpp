@@ -269,6 +269,10 @@ namespace models {
 
             void GetGridNodesPerFace(const int grid, int *nodes_per_face) override;
 
+            bool is_value_ptr_writable() override {
+                return true;
+            }
+
             void *GetValuePtr(std::string name) override {
                 return bmi_model->GetValuePtr(name);
             }
@@ -22,6 +22,9 @@ namespace realization {
 
         std::string get_output_line_for_timestep(int timestep, std::string delimiter) override;
 
+        void append_output_line_for_timestep(int timestep, utils::Output_Line_Buffer &line,
+                                             const std::string &delimiter) override;
+
         double get_response(time_step_t t_index, time_step_t t_delta) override;
 
         bool is_bmi_input_variable(const std::string &var_name) override;
@@ -30,6 +33,12 @@ namespace realization {
 
     protected:
 
+        /**
+         * The decimal places of output values, which stays at that of ``std::to_string`` (used for this type's output
+         * before values were formatted through @ref utils::Output_Line_Buffer) rather than the configured precision.
+         */
+        static const int CPP_OUTPUT_PRECISION = 6;
+
         std::shared_ptr<models::bmi::Bmi_Cpp_Adapter> construct_model(const geojson::PropertyMap& properties) override;
 
         time_t convert_model_time(const double &model_time) override {
@@ -56,10 +65,6 @@ namespace realization {
         friend class ::Bmi_Formulation_Test;
         friend class ::Bmi_Cpp_Formulation_Test;
 
-    private:
-
-        int next_time_step_index = 0;
-
     };
 
 }
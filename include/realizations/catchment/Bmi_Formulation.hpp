@@ -26,6 +26,9 @@
 #define BMI_REALIZATION_CFG_PARAM_OPT__ALLOW_EXCEED_END "allow_exceed_end_time"
 #define BMI_REALIZATION_CFG_PARAM_OPT__FIXED_TIME_STEP "fixed_time_step"
 #define BMI_REALIZATION_CFG_PARAM_OPT__LIB_FILE "library_file"
+#define BMI_REALIZATION_CFG_PARAM_OPT__INPUTS_BY_VALUE_PTR "set_inputs_by_value_ptr"
+#define BMI_REALIZATION_CFG_PARAM_OPT__STATE_VARS "state_variables"
+#define BMI_REALIZATION_CFG_PARAM_OPT__THREAD_SAFE "thread_safe"
 #define BMI_REALIZATION_CFG_PARAM_OPT__PYTHON_TYPE_NAME "python_type"
 #define BMI_REALIZATION_CFG_PARAM_OPT__PYTHON_MODULE_PATH "module_path"
 #define BMI_REALIZATION_CFG_PARAM_OPT__REGISTRATION_FUNC "registration_function"
@@ -220,15 +223,12 @@ namespace realization {
          */
         void set_output_precision(int precision) {
             output_precision = precision;
-            output_text_stream = std::make_shared<std::ostringstream>();
-            *output_text_stream << std::fixed;
-            *output_text_stream << std::setprecision(output_precision);
         }
 
     protected:
 
-        /** Object to help with converting numeric output values to text. */
-        std::shared_ptr<std::ostringstream> output_text_stream;
+        /** Reused buffer for converting numeric output values to text, in fixed notation at the output precision. */
+        utils::Output_Line_Buffer output_line;
 
         int get_output_precision() {
             return output_precision;
@@ -287,7 +287,10 @@ namespace realization {
                 BMI_REALIZATION_CFG_PARAM_OPT__OUT_HEADER_FIELDS,
                 BMI_REALIZATION_CFG_PARAM_OPT__ALLOW_EXCEED_END,
                 BMI_REALIZATION_CFG_PARAM_OPT__FIXED_TIME_STEP,
-                BMI_REALIZATION_CFG_PARAM_OPT__LIB_FILE
+                BMI_REALIZATION_CFG_PARAM_OPT__LIB_FILE,
+                BMI_REALIZATION_CFG_PARAM_OPT__INPUTS_BY_VALUE_PTR,
+                BMI_REALIZATION_CFG_PARAM_OPT__STATE_VARS,
+                BMI_REALIZATION_CFG_PARAM_OPT__THREAD_SAFE
         };
         std::vector<std::string> REQUIRED_PARAMETERS = {
                 BMI_REALIZATION_CFG_PARAM_REQ__INIT_CONFIG,
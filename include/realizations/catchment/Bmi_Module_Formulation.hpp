@@ -1,8 +1,10 @@
 #ifndef NGEN_BMI_MODULE_FORMULATION_H
 #define NGEN_BMI_MODULE_FORMULATION_H
 
+#include <deque>
 #include <utility>
 #include <memory>
+#include <unordered_map>
 #include "Bmi_Formulation.hpp"
 #include "EtCalcProperty.hpp"
 #include "EtCombinationMethod.hpp"
@@ -419,7 +421,7 @@ namespace realization {
                 //The return type of the vector here dependent on what
                 //needs to use it.  For other BMI moudles, that is runtime dependent
                 //on the type of the requesting module 
-                auto values = models::bmi::GetValue<double>(*model, bmi_var_name);
+                auto values = models::bmi::GetValue<double>(*model, bmi_var_name, get_var_bmi_type(bmi_var_name));
 
                 // Convert units
                 std::string native_units = get_bmi_model()->GetVarUnits(bmi_var_name);
@@ -502,6 +504,55 @@ namespace realization {
             return check_internal_providers<double>(output_name)[0];
         }
 
+        /**
+         * Bind an output to a handle, resolving its BMI variable, type and units conversion once.
+         *
+         * This lets other formulations (e.g., the other nested modules of a multi formulation) read the output each
+         * time step without it being looked up by name.  Only outputs of the model's BMI variables can be bound.
+         *
+         * @param id Unused, as the formulation has the outputs of a single catchment.
+         * @param variable_name The name, or mapped alias, of the output.
+         * @param output_units The units to convert values to.
+         * @param m Unused.
+         * @return The handle, for use with @ref get_bound_value.
+         * @throws std::runtime_error If the output is not one of the model's BMI output variables.
+         */
+        data_access::value_handle_t bind_value(const std::string &id, const std::string &variable_name,
+                                               const std::string &output_units, data_access::ReSampleMethod m) override
+        {
+            const std::vector<std::string> forcing_outputs = get_avaliable_variable_names();
+            if (std::find(forcing_outputs.begin(), forcing_outputs.end(), variable_name) == forcing_outputs.end()) {
+                throw runtime_error(get_formulation_type() + " received invalid output forcing name " + variable_name);
+            }
+            std::string bmi_var_name;
+            get_bmi_output_var_name(variable_name, bmi_var_name);
+            if (bmi_var_name.empty()) {
+                throw runtime_error(get_formulation_type() + " cannot bind output " + variable_name +
+                                    " that is not a BMI output variable");
+            }
+            OutputBinding bound;
+            bound.bmi_var_name = bmi_var_name;
+            // Resolve the type now, rather than on the first read
+            get_var_bmi_type(bmi_var_name);
+            try {
+                bound.converter = UnitsHelper::get_shared_converter(get_bmi_model()->GetVarUnits(bmi_var_name),
+                                                                    output_units);
+            }
+            catch (const std::runtime_error& e){
+                #ifndef UDUNITS_QUIET
+                std::cerr<<"WARN: Unit conversion unsuccessful - Returning unconverted value! (\""<<e.what()<<"\")"<<std::endl;
+                #endif
+            }
+            output_bindings.push_back(bound);
+            return output_bindings.size() - 1;
+        }
+
+        double get_bound_value(data_access::value_handle_t handle, time_t init_time, long duration_s) override
+        {
+            const OutputBinding &bound = output_bindings[handle];
+            return UnitsHelper::convert_value(bound.converter.get(), get_var_value_as_double(0, bound.bmi_var_name));
+        }
+
         bool is_bmi_input_variable(const std::string &var_name) override {
            return is_var_name_in_collection(get_bmi_input_variables(), var_name);
         }
@@ -545,8 +596,166 @@ namespace realization {
             return get_bmi_model()->GetOutputVarNames();
         }
 
+        /**
+         * Append the output line for the given time step, formatting the output variable values directly.
+         *
+         * As with the output line, only the current time step is valid.
+         *
+         * @param timestep The time step for which data is desired, which must be the last one processed.
+         * @param line The buffer to which the output values are appended.
+         * @param delimiter The value delimiter (currently, values are always comma separated).
+         */
+        void append_output_line_for_timestep(int timestep, utils::Output_Line_Buffer &line,
+                                             const std::string &delimiter) override {
+            if (timestep != (next_time_step_index - 1)) {
+                throw std::invalid_argument("Only current time step valid when getting output for BMI formulation");
+            }
+            append_output_values(line, get_output_precision());
+        }
+
+        /**
+         * Get the values of the output variables for the given time step, in the same order as the output line.
+         *
+         * As with the output line, only the current time step is valid.
+         *
+         * @param timestep The time step for which data is desired, which must be the last one processed.
+         * @return The values of the output variables.
+         */
+        std::vector<double> get_output_values_for_timestep(int timestep) override {
+            if (timestep != (next_time_step_index - 1)) {
+                throw std::invalid_argument("Only current time step valid when getting output for BMI formulation");
+            }
+            const std::vector<std::string> &output_var_names = get_output_variable_names();
+            std::vector<double> values;
+            values.reserve(output_var_names.size());
+            for (const std::string &name : output_var_names) {
+                values.push_back(get_var_value_as_double(name));
+            }
+            return values;
+        }
+
+        /**
+         * Get whether this formulation may safely execute concurrently with other formulations on other threads.
+         *
+         * Nothing in BMI says whether a model keeps process-wide state (e.g., static C variables or Fortran module
+         * variables), so this is only so when the configuration declares it, with the ``thread_safe`` parameter.
+         *
+         * @return Whether the backing model is configured as thread safe.
+         */
+        bool is_thread_safe() const override {
+            return bmi_thread_safe;
+        }
+
+        /**
+         * Get whether this formulation can save and restore its state.
+         *
+         * Standard BMI has no way to serialize a model, so this is only possible when the configuration names the model
+         * variables that together hold its full state, with the ``state_variables`` parameter.
+         *
+         * @return Whether state variables are configured for the backing model.
+         */
+        bool is_checkpointable() const override {
+            return !bmi_state_var_names.empty();
+        }
+
+        /**
+         * Write the state of this formulation and its backing model.
+         *
+         * The model is captured through its current time and the values of its configured state variables, retrieved
+         * with ``GetValue``.
+         *
+         * @param out The writer to which state is written.
+         * @throws std::runtime_error If no state variables are configured.
+         */
+        void save_state(utils::State_Writer &out) override {
+            if (!is_checkpointable()) {
+                throw std::runtime_error("Cannot save state of " + get_formulation_type() + " formulation for "
+                                         + get_id() + ": no '" BMI_REALIZATION_CFG_PARAM_OPT__STATE_VARS
+                                         "' are configured");
+            }
+            std::shared_ptr<M> model = get_bmi_model();
+            out.write<int64_t>(next_time_step_index);
+            out.write<double>(model->GetCurrentTime());
+            out.write<int64_t>(get_bmi_model_start_time_forcing_offset_s());
+
+            out.write<uint64_t>(bmi_state_var_names.size());
+            std::vector<char> value_bytes;
+            for (const std::string &name : bmi_state_var_names) {
+                value_bytes.resize(model->GetVarNbytes(name));
+                model->GetValue(name, value_bytes.data());
+                out.write_string(name);
+                out.write<uint64_t>(value_bytes.size());
+                out.write_bytes(value_bytes.data(), value_bytes.size());
+            }
+        }
+
+        /**
+         * Restore state written by @ref save_state into this formulation and its backing model.
+         *
+         * Since BMI also has no way to set a model's current time, the model is not advanced at all.  Instead, the
+         * offset from model time to forcing time is set so that the model's current time maps to the saved time, and
+         * only the saved state variables are set, with ``SetValue``.  The model then continues from its own clock, so
+         * its configured run only needs to be as long as the resumed part of the simulation.
+         *
+         * @param in The reader from which state is read.
+         * @param step_offset The difference between time step indices in this simulation and the one that was saved.
+         * @throws std::runtime_error If no state variables are configured, or the saved variables do not match them.
+         */
+        void load_state(utils::State_Reader &in, time_step_t step_offset) override {
+            if (!is_checkpointable()) {
+                throw std::runtime_error("Cannot restore state of " + get_formulation_type() + " formulation for "
+                                         + get_id() + ": no '" BMI_REALIZATION_CFG_PARAM_OPT__STATE_VARS
+                                         "' are configured");
+            }
+            std::shared_ptr<M> model = get_bmi_model();
+            next_time_step_index = in.read<int64_t>() + step_offset;
+            double saved_model_time = in.read<double>();
+            time_t saved_offset_s = in.read<int64_t>();
+
+            // Map the model's current time to the forcing time it was at when saved, rather than re-running the model
+            time_t saved_forcing_time = convert_model_time(saved_model_time) + saved_offset_s;
+            set_bmi_model_start_time_forcing_offset_s(saved_forcing_time - convert_model_time(model->GetCurrentTime()));
+
+            uint64_t var_count = in.read<uint64_t>();
+            if (var_count != bmi_state_var_names.size()) {
+                throw std::runtime_error("Cannot restore " + get_formulation_type() + " state for " + get_id()
+                                         + ": saved state variables do not match those configured");
+            }
+            std::vector<char> value_bytes;
+            for (const std::string &state_var_name : bmi_state_var_names) {
+                std::string name = in.read_string();
+                value_bytes.resize(in.read<uint64_t>());
+                in.read_bytes(value_bytes.data(), value_bytes.size());
+                if (name != state_var_name) {
+                    throw std::runtime_error("Cannot restore " + get_formulation_type() + " state for " + get_id()
+                                             + ": saved state variables do not match those configured");
+                }
+                if (model->GetVarNbytes(name) != value_bytes.size()) {
+                    throw std::runtime_error("Cannot restore " + get_formulation_type() + " variable " + name + " for "
+                                             + get_id() + ": saved size does not match the model's current size");
+                }
+                model->SetValue(name, value_bytes.data());
+            }
+        }
+
     protected:
 
+        /**
+         * Append the values of the output variables to a line, comma separated and in fixed notation.
+         *
+         * @param line The buffer to which the values are appended.
+         * @param precision The number of decimal places for each value.
+         */
+        void append_output_values(utils::Output_Line_Buffer &line, int precision) {
+            const std::vector<std::string> &output_var_names = get_output_variable_names();
+            for (size_t i = 0; i < output_var_names.size(); ++i) {
+                if (i > 0) {
+                    line.append(',');
+                }
+                line.append_fixed(get_var_value_as_double(output_var_names[i]), precision);
+            }
+        }
+
         /**
          * @brief Get correct BMI variable name, which may be the output or something mapped to this output.
          *
@@ -733,6 +942,19 @@ namespace realization {
                 set_bmi_model_time_step_fixed(
                         properties.at(BMI_REALIZATION_CFG_PARAM_OPT__FIXED_TIME_STEP).as_boolean());
             }
+            if (properties.find(BMI_REALIZATION_CFG_PARAM_OPT__INPUTS_BY_VALUE_PTR) != properties.end()) {
+                set_bmi_inputs_by_value_ptr(
+                        properties.at(BMI_REALIZATION_CFG_PARAM_OPT__INPUTS_BY_VALUE_PTR).as_boolean());
+            }
+            if (properties.find(BMI_REALIZATION_CFG_PARAM_OPT__THREAD_SAFE) != properties.end()) {
+                bmi_thread_safe = properties.at(BMI_REALIZATION_CFG_PARAM_OPT__THREAD_SAFE).as_boolean();
+            }
+            auto state_vars_it = properties.find(BMI_REALIZATION_CFG_PARAM_OPT__STATE_VARS);
+            if (state_vars_it != properties.end()) {
+                for (const geojson::JSONProperty &state_var : state_vars_it->second.as_list()) {
+                    bmi_state_var_names.push_back(state_var.as_string());
+                }
+            }
 
             auto std_names_it = properties.find(BMI_REALIZATION_CFG_PARAM_OPT__VAR_STD_NAMES);
             if (std_names_it != properties.end()) {
@@ -796,6 +1018,11 @@ namespace realization {
 
             // Finally, make sure this is set
             model_initialized = get_bmi_model()->is_model_initialized();
+
+            // Look up input variable details while still setting up, rather than on the first time step
+            if (model_initialized && !input_binding_deferred) {
+                build_input_variable_descriptors();
+            }
         }
 
         /**
@@ -958,6 +1185,10 @@ namespace realization {
             bmi_model_time_step_fixed = is_fix_time_step;
         }
 
+        void set_bmi_inputs_by_value_ptr(bool by_value_ptr) {
+            bmi_inputs_by_value_ptr = by_value_ptr;
+        }
+
         /**
          * Set whether the backing model uses/reads the forcing file directly for getting input data.
          *
@@ -1021,79 +1252,227 @@ namespace realization {
          */
         template <typename Iterator>
         std::shared_ptr<void> get_values_as_type(std::string type, Iterator begin, Iterator end)
+        {
+            models::bmi::BmiType bmi_type = models::bmi::get_bmi_type(type);
+            if (bmi_type == models::bmi::BmiType::UNKNOWN)
+                throw std::runtime_error("Unable to get values of iterable as type" + type + " from " + get_model_type_name() +
+                    " : no logic for converting values to variable's type.");
+            return get_values_as_type(bmi_type, begin, end);
+        }
+
+        /**
+         * @brief Gets values in iterator range, casted to an already resolved type, as typeless (void) pointer.
+         *
+         * @tparam Iterator
+         * @param type The type to cast values to, which must not be ``BmiType::UNKNOWN``.
+         * @param begin
+         * @param end
+         * @return std::shared_ptr<void>
+         */
+        template <typename Iterator>
+        std::shared_ptr<void> get_values_as_type(models::bmi::BmiType type, Iterator begin, Iterator end)
         {
             //Use std::vector range constructor to ensure contiguous storage of values
             //Return the pointer to the contiguous storage
-            if (type == "double" || type == "double precision")
-                return as_c_array<double>(begin, end);
-           
-            if (type == "float" || type == "real")
-                return as_c_array<float>(begin, end);
-
-            if (type == "short" || type == "short int" || type == "signed short" || type == "signed short int")
-                return as_c_array<short>(begin, end);
-
-            if (type == "unsigned short" || type == "unsigned short int")
-                return as_c_array<unsigned short>(begin, end);
-
-            if (type == "int" || type == "signed" || type == "signed int" || type == "integer")
-                return as_c_array<int>(begin, end);
-
-            if (type == "unsigned" || type == "unsigned int")
-                return as_c_array<unsigned int>(begin, end);
-
-            if (type == "long" || type == "long int" || type == "signed long" || type == "signed long int")
-                return as_c_array<long>(begin, end);
-
-            if (type == "unsigned long" || type == "unsigned long int")
-                return as_c_array<unsigned long>(begin, end);
-
-            if (type == "long long" || type == "long long int" || type == "signed long long" || type == "signed long long int")
-                return as_c_array<long long>(begin, end);
-
-            if (type == "unsigned long long" || type == "unsigned long long int")
-                return as_c_array<unsigned long long>(begin, end);
-
-            throw std::runtime_error("Unable to get values of iterable as type" + type + " from " + get_model_type_name() +
-                " : no logic for converting values to variable's type.");
+            return models::bmi::dispatch_bmi_type(type, [this, begin, end](auto tag) -> std::shared_ptr<void> {
+                return as_c_array<typename decltype(tag)::type>(begin, end);
+            });
         }
 
         // TODO: need to modify this to support arrays properly, since in general that's what BMI modules deal with
         template<typename T>
         std::shared_ptr<void> get_value_as_type(std::string type, T value)
         {
-            if (type == "double" || type == "double precision")
-                return std::make_shared<double>( static_cast<double>(value) );
+            models::bmi::BmiType bmi_type = models::bmi::get_bmi_type(type);
+            if (bmi_type == models::bmi::BmiType::UNKNOWN)
+                throw std::runtime_error("Unable to get value of variable as type" + type + " from " + get_model_type_name() +
+                    " : no logic for converting value to variable's type.");
+            return get_value_as_type(bmi_type, value);
+        }
 
-            if (type == "float" || type == "real")
-                return std::make_shared<float>( static_cast<float>(value) );
+        /**
+         * Get a value cast to an already resolved type, as a typeless (void) pointer.
+         *
+         * @param type The type to cast the value to, which must not be ``BmiType::UNKNOWN``.
+         * @param value The value.
+         */
+        template<typename T>
+        std::shared_ptr<void> get_value_as_type(models::bmi::BmiType type, T value)
+        {
+            return models::bmi::dispatch_bmi_type(type, [value](auto tag) -> std::shared_ptr<void> {
+                typedef typename decltype(tag)::type V;
+                return std::make_shared<V>( static_cast<V>(value) );
+            });
+        }
 
-            if (type == "short" || type == "short int" || type == "signed short" || type == "signed short int")
-                return std::make_shared<short>( static_cast<short>(value) );
+        /** Functions for writing values as a particular C++ type, for setting BMI input variables of that type. */
+        struct InputValueWriter
+        {
+            /** Copy values, converted to the type, to memory for values of the type. */
+            void (*copy)(const double *values, size_t count, void *dest);
+            /** Allocate memory for values of the type. */
+            std::shared_ptr<void> (*allocate)(size_t count);
+        };
 
-            if (type == "unsigned short" || type == "unsigned short int")
-                return std::make_shared<unsigned short>( static_cast<unsigned short>(value) );
+        template<typename T>
+        static void copy_values_as_type(const double *values, size_t count, void *dest)
+        {
+            T *typed_dest = static_cast<T*>(dest);
+            for (size_t i = 0; i < count; ++i) {
+                typed_dest[i] = static_cast<T>(values[i]);
+            }
+        }
 
-            if (type == "int" || type == "signed" || type == "signed int" || type == "integer")
-                return std::make_shared<int>( static_cast<int>(value) );
+        template<typename T>
+        static std::shared_ptr<void> allocate_values_as_type(size_t count)
+        {
+            return std::shared_ptr<void>(new T[count](), std::default_delete<T[]>());
+        }
 
-            if (type == "unsigned" || type == "unsigned int")
-                return std::make_shared<unsigned int>( static_cast<unsigned int>(value) );
+        template<typename T>
+        static InputValueWriter make_input_value_writer()
+        {
+            return {&copy_values_as_type<T>, &allocate_values_as_type<T>};
+        }
 
-            if (type == "long" || type == "long int" || type == "signed long" || type == "signed long int")
-                return std::make_shared<long>( static_cast<long>(value) );
+        /**
+         * Get the writer for values of a type.
+         *
+         * @param type The type.
+         * @return The writer, or one with null functions if the type is not supported.
+         */
+        static InputValueWriter get_input_value_writer(models::bmi::BmiType type)
+        {
+            if (type == models::bmi::BmiType::UNKNOWN)
+                return {nullptr, nullptr};
+            return models::bmi::dispatch_bmi_type(type, [](auto tag) -> InputValueWriter {
+                return make_input_value_writer<typename decltype(tag)::type>();
+            });
+        }
 
-            if (type == "unsigned long" || type == "unsigned long int")
-                return std::make_shared<unsigned long>( static_cast<unsigned long>(value) );
+        /**
+         * Get the type of a BMI variable of the model, resolving it only the first time it is needed.
+         *
+         * @param var_name The BMI name of the variable.
+         * @return The type, which may be ``BmiType::UNKNOWN`` if there is no support for the variable's type.
+         */
+        models::bmi::BmiType get_var_bmi_type(const std::string &var_name) {
+            auto it = var_bmi_types.find(var_name);
+            if (it != var_bmi_types.end()) {
+                return it->second;
+            }
+            models::bmi::BmiType type = resolve_var_bmi_type(var_name);
+            var_bmi_types.emplace(var_name, type);
+            return type;
+        }
 
-            if (type == "long long" || type == "long long int" || type == "signed long long" || type == "signed long long int")
-                return std::make_shared<long long>( static_cast<long long>(value) );
+        /**
+         * Resolve the type of a BMI variable of the model from the model's name for it, for @ref get_var_bmi_type.
+         *
+         * By default, the model's type name must be a C++ type name, or one of the Fortran names for them.
+         *
+         * @param var_name The BMI name of the variable.
+         * @return The type, which may be ``BmiType::UNKNOWN`` if there is no support for the variable's type.
+         */
+        virtual models::bmi::BmiType resolve_var_bmi_type(const std::string &var_name) {
+            return models::bmi::get_bmi_type(get_bmi_model()->GetVarType(var_name));
+        }
 
-            if (type == "unsigned long long" || type == "unsigned long long int")
-                return std::make_shared<unsigned long long>( static_cast<unsigned long long>(value) );
+        /**
+         * What is needed each time step to set a BMI input variable, all of which is fixed once the model is created.
+         */
+        struct InputVariableDescriptor
+        {
+            /** The BMI name of the variable. */
+            std::string name;
+            /** The C++ type analogous to the variable's BMI type. */
+            std::string type;
+            /** The variable's resolved type. */
+            models::bmi::BmiType bmi_type;
+            int item_size;
+            /** The number of values (i.e., items) in the variable. */
+            int count;
+            std::string units;
+            std::shared_ptr<data_access::GenericDataProvider> provider;
+            /** Whether @ref handle is bound, which is only done for single valued variables. */
+            bool bound;
+            data_access::value_handle_t handle;
+            /** The selector for reading values, when not bound, with its time period set each time step. */
+            CatchmentAggrDataSelector selector;
+            /** How to write values as the variable's type, if it is supported. */
+            InputValueWriter writer;
+            /** The model's own memory for the variable, when set by writing through it. */
+            void *value_ptr;
+            /** Memory for values of the variable's type to pass to ``SetValue``, kept between time steps. */
+            std::shared_ptr<void> staging;
+        };
 
-            throw std::runtime_error("Unable to get value of variable as type" + type + " from " + get_model_type_name() +
-                " : no logic for converting value to variable's type.");
+        /**
+         * Build the table of what is needed to set each BMI input variable, so setting them each time step does not
+         * query the model for it.
+         *
+         * Single valued variables are bound to a handle of their provider, which resolves their names and units
+         * conversion once.  If that fails, the variable is read by name each time step instead, so any error is raised
+         * there as it would be without the table.
+         *
+         * Providers keep what they bind until they are destroyed, so this should be called once the input providers
+         * are final, rather than again each time they change.
+         */
+        void build_input_variable_descriptors() {
+            input_variable_descriptors.clear();
+            for (const std::string &var_name : get_bmi_model()->GetInputVarNames()) {
+                InputVariableDescriptor descriptor;
+                descriptor.name = var_name;
+                std::string var_map_alias = get_config_mapped_variable_name(var_name);
+                if (input_forcing_providers.find(var_map_alias) != input_forcing_providers.end()) {
+                    descriptor.provider = input_forcing_providers[var_map_alias];
+                }
+                else if (var_map_alias != var_name && input_forcing_providers.find(var_name) != input_forcing_providers.end()) {
+                    descriptor.provider = input_forcing_providers[var_name];
+                }
+                else {
+                    descriptor.provider = forcing;
+                }
+                // TODO: probably need to actually allow this by default and warn, but have config option to activate
+                //  this type of behavior
+                descriptor.item_size = get_bmi_model()->GetVarItemsize(var_name);
+                int nbytes = get_bmi_model()->GetVarNbytes(var_name);
+                descriptor.count = descriptor.item_size == nbytes || descriptor.item_size == 0 ? 1 : nbytes / descriptor.item_size;
+                descriptor.type = get_bmi_model()->get_analogous_cxx_type(get_bmi_model()->GetVarType(var_name),
+                                                                          descriptor.item_size);
+                descriptor.units = get_bmi_model()->GetVarUnits(var_name);
+                descriptor.bmi_type = get_var_bmi_type(var_name);
+                descriptor.writer = get_input_value_writer(descriptor.bmi_type);
+                descriptor.value_ptr = nullptr;
+                if (descriptor.writer.copy != nullptr) {
+                    if (bmi_inputs_by_value_ptr && get_bmi_model()->is_value_ptr_writable()) {
+                        try {
+                            descriptor.value_ptr = get_bmi_model()->GetValuePtr(var_name);
+                        }
+                        catch (const std::exception &) {
+                            // Set through a staging buffer instead
+                        }
+                    }
+                    if (descriptor.value_ptr == nullptr) {
+                        descriptor.staging = descriptor.writer.allocate(descriptor.count);
+                    }
+                }
+                descriptor.selector = CatchmentAggrDataSelector(this->get_catchment_id(), var_map_alias, 0, 1,
+                                                                descriptor.units);
+                descriptor.bound = false;
+                if (descriptor.item_size == nbytes) {
+                    try {
+                        descriptor.handle = descriptor.provider->bind_value(this->get_catchment_id(), var_map_alias,
+                                                                            descriptor.units, data_access::SUM);
+                        descriptor.bound = true;
+                    }
+                    catch (const std::exception &) {
+                        // Read by name each time step, which raises the error when the value is actually needed
+                    }
+                }
+                input_variable_descriptors.push_back(std::move(descriptor));
+            }
+            input_variable_descriptors_built = true;
         }
 
         /**
@@ -1104,45 +1483,51 @@ namespace realization {
          *                be different than the model's internal time step.
          */
         void set_model_inputs_prior_to_update(const double &model_init_time, time_step_t t_delta) {
-            std::vector<std::string> in_var_names = get_bmi_model()->GetInputVarNames();
+            if (!input_variable_descriptors_built) {
+                build_input_variable_descriptors();
+            }
             time_t model_epoch_time = convert_model_time(model_init_time) + get_bmi_model_start_time_forcing_offset_s();
 
-            for (std::string & var_name : in_var_names) {
-                data_access::GenericDataProvider *provider;
-                std::string var_map_alias = get_config_mapped_variable_name(var_name);
-                if (input_forcing_providers.find(var_map_alias) != input_forcing_providers.end()) {
-                    provider = input_forcing_providers[var_map_alias].get();
-                }
-                else if (var_map_alias != var_name && input_forcing_providers.find(var_name) != input_forcing_providers.end()) {
-                    provider = input_forcing_providers[var_name].get();
+            for (InputVariableDescriptor &descriptor : input_variable_descriptors) {
+                double value;
+                std::vector<double> values;
+                const double *source = &value;
+                size_t source_count = 1;
+                if (descriptor.bound) {
+                    value = descriptor.provider->get_bound_value(descriptor.handle, model_epoch_time, t_delta);
                 }
                 else {
-                    provider = forcing.get();
+                    descriptor.selector.set_init_time(model_epoch_time);
+                    descriptor.selector.set_duration_secs(t_delta);
+                    if (descriptor.count > 1) {
+                        //more than a single value needed for var_name
+                        values = descriptor.provider->get_values(descriptor.selector);
+                        source = values.data();
+                        source_count = values.size();
+                    }
+                    else {
+                        //scalar value
+                        value = descriptor.provider->get_value(descriptor.selector);
+                    }
+                }
+
+                if (descriptor.writer.copy == nullptr) {
+                    // No writer for this type, so leave converting (or failing to) to the general functions
+                    std::shared_ptr<void> value_ptr = descriptor.count > 1
+                            ? get_values_as_type(descriptor.type, values.begin(), values.end())
+                            : get_value_as_type(descriptor.type, value);
+                    get_bmi_model()->SetValue(descriptor.name, value_ptr.get());
+                    continue;
                 }
-                // TODO: probably need to actually allow this by default and warn, but have config option to activate
-                //  this type of behavior
                 // TODO: account for arrays later
-                int varItemSize = get_bmi_model()->GetVarItemsize(var_name);
-                std::shared_ptr<void> value_ptr;
-                // Finally, use the value obtained to set the model input
-                std::string type = get_bmi_model()->get_analogous_cxx_type(get_bmi_model()->GetVarType(var_name),
-                                                                           varItemSize);
-                if (varItemSize != get_bmi_model()->GetVarNbytes(var_name)) {
-                    //more than a single value needed for var_name
-                    auto values = provider->get_values(CatchmentAggrDataSelector(this->get_catchment_id(),var_map_alias, model_epoch_time, t_delta,
-                                                   get_bmi_model()->GetVarUnits(var_name)));
-                    //need to marshal data types to the reciever as well
-                    //this could be done a little more elegantly if the provider interface were
-                    //"type aware", but for now, this will do (but requires yet another copy)
-                    value_ptr = get_values_as_type( type, values.begin(), values.end() );
-
-                } else {
-                    //scalar value
-                    double value = provider->get_value(CatchmentAggrDataSelector(this->get_catchment_id(),var_map_alias, model_epoch_time, t_delta,
-                                                   get_bmi_model()->GetVarUnits(var_name)));
-                    value_ptr = get_value_as_type(type, value);      
+                source_count = std::min(source_count, (size_t) descriptor.count);
+                if (descriptor.value_ptr != nullptr) {
+                    descriptor.writer.copy(source, source_count, descriptor.value_ptr);
+                }
+                else {
+                    descriptor.writer.copy(source, source_count, descriptor.staging.get());
+                    get_bmi_model()->SetValue(descriptor.name, descriptor.staging.get());
                 }
-                get_bmi_model()->SetValue(var_name, value_ptr.get());
             }
         }
 
@@ -1150,7 +1535,45 @@ namespace realization {
         time_step_t last_model_response_delta = 0;
         /** The epoch time of the model at the beginning of its last update. */
         time_t last_model_response_start_time = 0;
+        /**
+         * Index value (0-based) of the time step that will be processed by the next update of the model.
+         *
+         * A formulation time step for BMI types can be thought of as the execution of a call to any of the functions of
+         * the underlying BMI model that advance the model (either `update` or `update_until`). This member stores the
+         * ordinal index of the next time step to be executed.  Except in the initial formulation state, this will be
+         * one greater than the index of the last executed time step.
+         *
+         * E.g., on initialization, before any calls to @ref get_response, this value will be ``0``.  After a call to
+         * @ref get_response (assuming ``0`` as the passed ``t_index`` argument), time step ``0`` will be processed, and
+         * this member would be incremented by 1, thus making it ``1``.
+         *
+         * The member serves as an implicit marker of how many time steps have been processed so far.  Knowing this is
+         * required to maintain valid behavior in certain things, such as @ref get_response (we may want to process
+         * multiple time steps forward to a particular index other than the next, but it would not be valid to receive
+         * a ``t_index`` earlier than the last processed time step) and @ref get_output_line_for_timestep (because
+         * formulations do not save results from previous time steps, only the results from the last processed time step
+         * can be used to generate output).
+         */
+        int next_time_step_index = 0;
         std::map<std::string, std::shared_ptr<data_access::GenericDataProvider>> input_forcing_providers;
+        /** How to set each BMI input variable, in the order the model lists them, built once the model is created. */
+        std::vector<InputVariableDescriptor> input_variable_descriptors;
+        bool input_variable_descriptors_built = false;
+        /**
+         * Whether building @ref input_variable_descriptors is left to whatever sets up the input providers after the
+         * model is created (i.e., a multi formulation nesting this one), so inputs are only bound once.
+         */
+        bool input_binding_deferred = false;
+        /** An output BMI variable and units conversion bound to a handle by @ref bind_value. */
+        struct OutputBinding
+        {
+            std::string bmi_var_name;
+            std::shared_ptr<cv_converter> converter;
+        };
+        /** Outputs bound by @ref bind_value, by handle. */
+        std::deque<OutputBinding> output_bindings;
+        /** The resolved types of the model's BMI variables, by name, added to as they are first needed. */
+        std::unordered_map<std::string, models::bmi::BmiType> var_bmi_types;
 
         // Access for multi-BMI
         friend class Bmi_Multi_Formulation;
@@ -1174,6 +1597,15 @@ namespace realization {
         std::shared_ptr<M> bmi_model;
         /** Whether backing model has fixed time step size. */
         bool bmi_model_time_step_fixed = true;
+        /** Whether to set input variables by writing through their value pointers, if the model allows it. */
+        bool bmi_inputs_by_value_ptr = false;
+        /** Whether the model is configured as keeping no process-wide state, so it may run alongside others. */
+        bool bmi_thread_safe = false;
+        /**
+         * The BMI variables that together hold the full state of the model, and so are saved in checkpoints, or empty
+         * if the model cannot be checkpointed.
+         */
+        std::vector<std::string> bmi_state_var_names;
         /**
          * The offset, converted to seconds, from the model's start time to the start time of the initial forcing time
          * step.
@@ -1194,7 +1626,8 @@ namespace realization {
                 BMI_REALIZATION_CFG_PARAM_OPT__OUTPUT_PRECISION,
                 BMI_REALIZATION_CFG_PARAM_OPT__ALLOW_EXCEED_END,
                 BMI_REALIZATION_CFG_PARAM_OPT__FIXED_TIME_STEP,
-                BMI_REALIZATION_CFG_PARAM_OPT__LIB_FILE
+                BMI_REALIZATION_CFG_PARAM_OPT__LIB_FILE,
+                BMI_REALIZATION_CFG_PARAM_OPT__INPUTS_BY_VALUE_PTR
         };
         std::vector<std::string> REQUIRED_PARAMETERS = {
                 BMI_REALIZATION_CFG_PARAM_REQ__INIT_CONFIG,
@@ -1,6 +1,7 @@
 #ifndef NGEN_BMI_MULTI_FORMULATION_HPP
 #define NGEN_BMI_MULTI_FORMULATION_HPP
 
+#include <functional>
 #include <map>
 #include <vector>
 #include "Bmi_Formulation.hpp"
@@ -435,6 +436,9 @@ namespace realization {
 
         string get_output_line_for_timestep(int timestep, std::string delimiter) override;
 
+        void append_output_line_for_timestep(int timestep, utils::Output_Line_Buffer &line,
+                                             const std::string &delimiter) override;
+
         double get_response(time_step_t t_index, time_step_t t_delta) override;
 
         /**
@@ -523,6 +527,42 @@ namespace realization {
          */
         bool is_model_initialized() override;
 
+        /**
+         * Test whether all nested modules may safely execute concurrently with other formulations on other threads.
+         *
+         * @return Whether all nested modules may safely execute concurrently with other formulations.
+         */
+        bool is_thread_safe() const override;
+
+        /**
+         * Test whether any nested module executes code in the embedded Python interpreter.
+         *
+         * @return Whether any nested module uses the embedded Python interpreter.
+         */
+        bool uses_python() const override;
+
+        /**
+         * Test whether all nested modules can save and restore their state.
+         *
+         * @return Whether all nested modules support checkpointing their state.
+         */
+        bool is_checkpointable() const override;
+
+        /**
+         * Write the state of this formulation, followed by that of each nested module in order.
+         *
+         * @param out The writer to which state is written.
+         */
+        void save_state(utils::State_Writer &out) override;
+
+        /**
+         * Restore state written by @ref save_state, including that of each nested module.
+         *
+         * @param in The reader from which state is read.
+         * @param step_offset The difference between time step indices in this simulation and the one that was saved.
+         */
+        void load_state(utils::State_Reader &in, time_step_t step_offset) override;
+
         /**
          * Get whether a property's per-time-step values are each an aggregate sum over the entire time step.
          *
@@ -582,6 +622,14 @@ namespace realization {
 
     protected:
 
+        /**
+         * Append the values of this formulation's output variables to a line, comma separated, in fixed notation at the
+         * output precision.
+         *
+         * @param line The buffer to which the values are appended.
+         */
+        void append_output_values(utils::Output_Line_Buffer &line);
+
         /**
          * Creating a multi-BMI-module formulation from NGen config.
          *
@@ -665,6 +713,10 @@ namespace realization {
          * time step), then a deferred provider gets registered with the nested module and has a reference added to
          * the @ref deferredProviders member.  This function goes through all such the deferred providers, ensures there
          * is something available that can serve as the backing wrapped provider, and associates them.
+         *
+         * It then binds the inputs of the nested modules using deferred providers, which was put off until now, so that
+         * (like inputs from earlier modules) each time step they are read straight from the handles of the modules
+         * providing them.
          */
         inline void init_deferred_associations() {
             for (int d = 0; d < deferredProviders.size(); ++d) {
@@ -699,6 +751,10 @@ namespace realization {
                     throw realization::ConfigurationException(msg);
                 }
             }
+
+            for (auto &bind : deferred_module_input_binds) {
+                bind.second();
+            }
         }
 
         /**
@@ -720,6 +776,8 @@ namespace realization {
         std::shared_ptr<T> init_nested_module(int mod_index, std::string identifier, geojson::PropertyMap properties) {
             std::shared_ptr<data_access::GenericDataProvider> wfp = std::make_shared<data_access::WrappedDataProvider>(this);
             std::shared_ptr<T> mod = std::make_shared<T>(identifier, wfp, output);
+            // Inputs are bound below, once their providers are set up, so nothing is bound to providers then replaced
+            mod->input_binding_deferred = true;
 
             // Since this is a nested formulation, support usage of the '{{id}}' syntax for init config file paths.
             Catchment_Formulation::config_pattern_substitution(properties, BMI_REALIZATION_CFG_PARAM_REQ__INIT_CONFIG,
@@ -743,6 +801,10 @@ namespace realization {
                     mod->input_forcing_providers[framework_alias] = availableData[framework_alias];
                 }
             }
+            // Bind the module's inputs now, unless some come from deferred providers not yet associated
+            if (deferred_module_input_binds.count(mod_index) == 0) {
+                mod->build_input_variable_descriptors();
+            }
 
             // Also add the output variable aliases
             for (const std::string &var_name : mod->get_bmi_output_variables()) {
@@ -815,6 +877,9 @@ namespace realization {
             // Assign as provider within module
             // TODO: per TODO at top, probably can replace bmi_input_var_name here with framework_output_name
             mod->input_forcing_providers[bmi_input_var_name] = provider;
+            // Bind the module's inputs once the provider is associated, so they read straight through it
+            T *mod_ptr = mod.get();
+            deferred_module_input_binds[mod_index] = [mod_ptr]() { mod_ptr->build_input_variable_descriptors(); };
         }
 
         /** The set of available "forcings" (output variables, plus their mapped aliases) this instance can provide. */
@@ -840,6 +905,11 @@ namespace realization {
          * what required the deferred provider in the @ref deferredProviders collection at its index ``0``.
          */
         std::vector<int> deferredProviderModuleIndices;
+        /**
+         * Functions to bind the inputs of each nested module that uses a deferred provider, keyed by module index, for
+         * once the deferred providers are associated.
+         */
+        std::map<int, std::function<void()>> deferred_module_input_binds;
         /**
          * Whether the @ref Bmi_Formulation::output_variable_names value is just the analogous value from this
          * instance's final nested module.
@@ -103,6 +103,14 @@ namespace realization {
 
         double get_var_value_as_double(const int &index, const string &var_name) override;
 
+        /**
+         * Resolve the type of a BMI variable from both its Python type name and its item size.
+         *
+         * @param var_name The BMI name of the variable.
+         * @return The type, which may be ``BmiType::UNKNOWN`` if there is no support for the variable's type.
+         */
+        models::bmi::BmiType resolve_var_bmi_type(const string &var_name) override;
+
         /**
          * Test whether backing model has run BMI ``Initialize``.
          *
@@ -115,6 +123,23 @@ namespace realization {
          */
         bool is_model_initialized() override;
 
+        /**
+         * Get whether this formulation may safely execute concurrently with other formulations on other threads.
+         *
+         * Python BMI models run inside the single, process-wide embedded interpreter, so this is always ``false``,
+         * whatever the ``thread_safe`` parameter says.
+         *
+         * @return ``false``, since Python BMI models must only be executed on the main thread.
+         */
+        bool is_thread_safe() const override;
+
+        /**
+         * Get whether this formulation executes code in the embedded Python interpreter.
+         *
+         * @return ``true``, since Python BMI models run inside the embedded interpreter.
+         */
+        bool uses_python() const override;
+
         friend class Bmi_Multi_Formulation;
 
         // Unit test access
@@ -122,29 +147,6 @@ namespace realization {
         friend class ::Bmi_Py_Formulation_Test;
         friend class ::Bmi_Multi_Formulation_Test;
 
-    private:
-
-        /**
-         * Index value (0-based) of the time step that will be processed by the next update of the model.
-         *
-         * A formulation time step for BMI types can be thought of as the execution of a call to any of the functions of
-         * the underlying BMI model that advance the model (either `update` or `update_until`). This member stores the
-         * ordinal index of the next time step to be executed.  Except in the initial formulation state, this will be
-         * one greater than the index of the last executed time step.
-         *
-         * E.g., on initialization, before any calls to @ref get_response, this value will be ``0``.  After a call to
-         * @ref get_response (assuming ``0`` as the passed ``t_index`` argument), time step ``0`` will be processed, and
-         * this member would be incremented by 1, thus making it ``1``.
-         *
-         * The member serves as an implicit marker of how many time steps have been processed so far.  Knowing this is
-         * required to maintain valid behavior in certain things, such as @ref get_response (we may want to process
-         * multiple time steps forward to a particular index other than the next, but it would not be valid to receive
-         * a ``t_index`` earlier than the last processed time step) and @ref get_output_line_for_timestep (because
-         * formulations do not save results from previous time steps, only the results from the last processed time step
-         * can be used to generate output).
-         */
-        int next_time_step_index = 0;
-
     };
 
 }
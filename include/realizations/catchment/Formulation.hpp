@@ -6,10 +6,13 @@
 #include <map>
 #include <exception>
 #include <vector>
+#include <cstdlib>
 
 #include "Et_Accountable.hpp"
 #include "JSONProperty.hpp"
 #include "Pdm03.h"
+#include "State_Serialization.hpp"
+#include "Output_Line_Buffer.hpp"
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/algorithm/string.hpp>
@@ -64,6 +67,65 @@ namespace realization {
                 return this->id;
             }
 
+            /**
+             * Get whether this formulation may safely execute concurrently with other formulations on other threads.
+             *
+             * Formulations are assumed not to be, as models may keep process-wide state (e.g., static or module
+             * variables, or the embedded Python interpreter), so the driver only executes them on the main thread.
+             * Formulations known to keep all their state per instance should override this, or let it be configured.
+             *
+             * @return Whether this formulation may safely execute concurrently with others.
+             */
+            virtual bool is_thread_safe() const {
+                return false;
+            }
+
+            /**
+             * Get whether this formulation executes code in the embedded Python interpreter.
+             *
+             * The driver uses this to decide whether anything else (e.g., routing) may hold the interpreter while the
+             * formulation executes.
+             *
+             * @return Whether this formulation uses the embedded Python interpreter.
+             */
+            virtual bool uses_python() const {
+                return false;
+            }
+
+            /**
+             * Get whether this formulation can save and restore its state with @ref save_state and @ref load_state.
+             *
+             * @return Whether this formulation supports checkpointing its state.
+             */
+            virtual bool is_checkpointable() const {
+                return false;
+            }
+
+            /**
+             * Write everything needed to later resume this formulation from its current time step, e.g. for a
+             * checkpoint.
+             *
+             * @param out The writer to which state is written.
+             * @throws std::runtime_error If this formulation does not support checkpointing.
+             */
+            virtual void save_state(utils::State_Writer &out) {
+                throw std::runtime_error("A " + get_formulation_type() + " formulation does not support saving its state.");
+            }
+
+            /**
+             * Restore state previously written by @ref save_state.
+             *
+             * The state may have been saved in a different simulation than this one, in which case time step indices
+             * are shifted by ``step_offset``.
+             *
+             * @param in The reader from which state is read.
+             * @param step_offset The difference between time step indices in this simulation and the one that was saved.
+             * @throws std::runtime_error If this formulation does not support checkpointing.
+             */
+            virtual void load_state(utils::State_Reader &in, time_step_t step_offset) {
+                throw std::runtime_error("A " + get_formulation_type() + " formulation does not support loading its state.");
+            }
+
             /**
              * Get a header line appropriate for a file made up of entries from this type's implementation of
              * ``get_output_line_for_timestep``.
@@ -93,6 +155,46 @@ namespace realization {
              */
             virtual std::string get_output_line_for_timestep(int timestep,
                                                              std::string delimiter = DEFAULT_FORMULATION_OUTPUT_DELIMITER) = 0;
+
+            /**
+             * Append the output line for the given time step to a line buffer.
+             *
+             * This produces the same text as ``get_output_line_for_timestep``, but lets the caller build a whole output
+             * row in a reused buffer.  The default implementation appends the output line, so types should override it
+             * where they can format their values directly.
+             *
+             * @param timestep The time step for which data is desired.
+             * @param line The buffer to which the output values are appended.
+             * @param delimiter The value delimiter.
+             */
+            virtual void append_output_line_for_timestep(int timestep, utils::Output_Line_Buffer &line,
+                                                         const std::string &delimiter = DEFAULT_FORMULATION_OUTPUT_DELIMITER) {
+                line.append(get_output_line_for_timestep(timestep, delimiter));
+            }
+
+            /**
+             * Get the output values for the given time step, in the order of the fields of the header line.
+             *
+             * This is the numeric equivalent of ``get_output_line_for_timestep``, for output that is not written as text.
+             * The default implementation parses the values from the output line, so types should override it where they
+             * have the values at hand.
+             *
+             * @param timestep The time step for which data is desired.
+             * @return The output variable values for the given time step.
+             */
+            virtual std::vector<double> get_output_values_for_timestep(int timestep) {
+                std::vector<std::string> fields;
+                std::string line = get_output_line_for_timestep(timestep, DEFAULT_FORMULATION_OUTPUT_DELIMITER);
+                if (!line.empty()) {
+                    boost::split(fields, line, boost::is_any_of(DEFAULT_FORMULATION_OUTPUT_DELIMITER));
+                }
+                std::vector<double> values;
+                values.reserve(fields.size());
+                for (const std::string &field : fields) {
+                    values.push_back(std::strtod(field.c_str(), nullptr));
+                }
+                return values;
+            }
             
             virtual void create_formulation(boost::property_tree::ptree &config, geojson::PropertyMap *global = nullptr) = 0;
             virtual void create_formulation(geojson::PropertyMap properties) = 0;
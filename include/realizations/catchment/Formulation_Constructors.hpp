@@ -2,6 +2,7 @@
 #define NGEN_FORMULATION_CONSTRUCTORS_H
 
 #include "Formulation.hpp"
+#include <FeatureBuilder.hpp>
 #include <JSONProperty.hpp>
 #include <exception>
 
@@ -19,8 +20,11 @@
 #include "Bmi_Py_Formulation.hpp"
 #include <GenericDataProvider.hpp>
 #include "CsvPerFeatureForcingProvider.hpp"
+#include "BinaryForcingStoreProvider.hpp"
+#include "PrefetchingDataProvider.hpp"
 #ifdef NETCDF_ACTIVE
     #include "NetCDFPerFeatureDataProvider.hpp"
+    #include "GriddedForcingProvider.hpp"
 #endif
 
 #ifdef NGEN_LSTM_TORCH_LIB_ACTIVE
@@ -66,16 +70,28 @@ namespace realization {
         std::string formulation_type,
         std::string identifier,
         forcing_params &forcing_config,
-        utils::StreamHandler output_stream
+        utils::StreamHandler output_stream,
+        geojson::GeoJSON fabric = nullptr
     ) {
         constructor formulation_constructor = formulations.at(formulation_type);
         std::shared_ptr<data_access::GenericDataProvider> fp;
         if (forcing_config.provider == "CsvPerFeature" || forcing_config.provider == ""){
-            fp = std::make_shared<CsvPerFeatureForcingProvider>(forcing_config);
+            fp = CsvPerFeatureForcingProvider::get_shared_provider(forcing_config);
+        }
+        else if (forcing_config.provider == "BinaryStore"){
+            fp = data_access::BinaryForcingStoreProvider::get_shared_provider(forcing_config.path);
         }
 #ifdef NETCDF_ACTIVE
         else if (forcing_config.provider == "NetCDF"){
-            fp = data_access::NetCDFPerFeatureDataProvider::get_shared_provider(forcing_config.path, output_stream);
+            fp = data_access::NetCDFPerFeatureDataProvider::get_shared_provider(forcing_config.path, output_stream,
+                                                                                forcing_config.chunk_time_steps,
+                                                                                forcing_config.cache_bytes);
+        }
+        else if (forcing_config.provider == "Gridded"){
+            if (fabric == nullptr) {
+                throw std::runtime_error("Gridded forcing for " + identifier + " needs the hydrofabric's catchment polygons");
+            }
+            fp = data_access::GriddedForcingProvider::get_shared_provider(forcing_config, fabric, output_stream);
         }
 #endif
         else { // Some unknown string in the provider field?
@@ -84,6 +100,10 @@ namespace realization {
                     "\", formulation_type: \"" + formulation_type +
                     "\", provider: \"" + forcing_config.provider + "\"");
         }
+        // Per-catchment CSV forcing is already all in memory, so only providers of many catchments read ahead
+        if (forcing_config.prefetch_time_steps > 0 && forcing_config.provider != "CsvPerFeature" && forcing_config.provider != "") {
+            fp = data_access::PrefetchingDataProvider::get_shared_provider(fp, forcing_config.prefetch_time_steps);
+        }
         return formulation_constructor(identifier, fp, output_stream);
     };
 
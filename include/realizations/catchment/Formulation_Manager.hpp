@@ -7,6 +7,9 @@
 #include <functional>
 #include <dirent.h>
 #include <regex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
@@ -18,6 +21,9 @@
 #include "GIUH.hpp"
 #include "GiuhJsonReader.h"
 #include "routing/Routing_Params.h"
+#include "core/Execution_Params.hpp"
+#include "core/Checkpoint_Params.hpp"
+#include "core/Output_Params.hpp"
 
 namespace realization {
 
@@ -50,6 +56,8 @@ namespace realization {
                 //TODO seperate the parsing of configuration options like time
                 //and routing and other non feature specific tasks from this main function
                 //which has to iterate the entire hydrofabric.
+                this->fabric = fabric;
+                this->forcing_files_index_key.clear();
                 auto possible_global_config = tree.get_child_optional("global");
 
                 if (possible_global_config) {
@@ -138,6 +146,23 @@ namespace realization {
                     this->routing_config = std::make_shared<routing_params>(
                         routing_parameters.at("t_route_config_file_with_path").as_string()
                     );
+
+                    if (routing_parameters.has_key("window_timesteps")) {
+                        long window = routing_parameters.at("window_timesteps").as_natural_number();
+                        if (window < 0) {
+                            throw std::runtime_error("ERROR: Routing config 'window_timesteps' must not be negative.");
+                        }
+                        this->routing_config->window_timesteps = window;
+                    }
+
+                    if (routing_parameters.has_key("in_memory_flows")) {
+                        this->routing_config->in_memory_flows = routing_parameters.at("in_memory_flows").as_boolean();
+                    }
+
+                    //Windows of flows can only be handed over in memory
+                    if (this->routing_config->window_timesteps > 0 && !this->routing_config->in_memory_flows) {
+                        throw std::runtime_error("ERROR: Routing config 'window_timesteps' requires 'in_memory_flows'.");
+                    }
                     using_routing = true;
                 #else
                     using_routing = false;
@@ -146,6 +171,129 @@ namespace realization {
                 #endif //NGEN_ROUTING_ACTIVE
                  }
 
+                /**
+                 * Read driver execution configurations from configuration file
+                 */
+                auto possible_execution_configs = tree.get_child_optional("execution");
+
+                if (possible_execution_configs) {
+                    geojson::JSONProperty execution_parameters("execution", *possible_execution_configs);
+
+                    if (execution_parameters.has_key("threads")) {
+                        long threads = execution_parameters.at("threads").as_natural_number();
+                        if (threads < 0) {
+                            throw std::runtime_error("ERROR: Execution config 'threads' must not be negative.");
+                        }
+                        this->execution_config.threads = threads;
+                    }
+
+                    if (execution_parameters.has_key("mode")) {
+                        std::string mode = execution_parameters.at("mode").as_string();
+                        if (mode == "time_step") {
+                            this->execution_config.mode = ExecutionMode::TimeStep;
+                        }
+                        else if (mode == "time_blocked") {
+                            this->execution_config.mode = ExecutionMode::TimeBlocked;
+                        }
+                        else if (mode == "wavefront") {
+                            this->execution_config.mode = ExecutionMode::Wavefront;
+                        }
+                        else {
+                            throw std::runtime_error("ERROR: Unrecognized execution mode '" + mode + "'.");
+                        }
+                    }
+
+                    if (execution_parameters.has_key("block_size")) {
+                        long block_size = execution_parameters.at("block_size").as_natural_number();
+                        if (block_size < 1) {
+                            throw std::runtime_error("ERROR: Execution config 'block_size' must be at least 1.");
+                        }
+                        this->execution_config.block_size = block_size;
+                    }
+                }
+
+                /**
+                 * Read checkpoint configurations from configuration file
+                 */
+                auto possible_checkpoint_configs = tree.get_child_optional("checkpoint");
+
+                if (possible_checkpoint_configs) {
+                    geojson::JSONProperty checkpoint_parameters("checkpoint", *possible_checkpoint_configs);
+
+                    if (checkpoint_parameters.has_key("path")) {
+                        this->checkpoint_config.path = checkpoint_parameters.at("path").as_string();
+                    }
+
+                    if (checkpoint_parameters.has_key("interval")) {
+                        long interval = checkpoint_parameters.at("interval").as_natural_number();
+                        if (interval < 0) {
+                            throw std::runtime_error("ERROR: Checkpoint config 'interval' must not be negative.");
+                        }
+                        this->checkpoint_config.interval = interval;
+                    }
+
+                    if (checkpoint_parameters.has_key("write_at")) {
+                        for (const auto &index : checkpoint_parameters.at("write_at").as_list()) {
+                            this->checkpoint_config.write_at.insert(index.as_natural_number());
+                        }
+                    }
+
+                    if (checkpoint_parameters.has_key("restart_from")) {
+                        this->checkpoint_config.restart_from = checkpoint_parameters.at("restart_from").as_string();
+                    }
+
+                    if ((this->checkpoint_config.interval > 0 || !this->checkpoint_config.write_at.empty())
+                        && this->checkpoint_config.path.empty()) {
+                        throw std::runtime_error("ERROR: Checkpoint config requires a 'path' when writing checkpoints.");
+                    }
+                }
+
+                /**
+                 * Read output configurations from configuration file
+                 */
+                auto possible_output_configs = tree.get_child_optional("output");
+
+                if (possible_output_configs) {
+                    geojson::JSONProperty output_parameters("output", *possible_output_configs);
+
+                    if (output_parameters.has_key("format")) {
+                        std::string format = output_parameters.at("format").as_string();
+                        if (format == "csv") {
+                            this->output_config.format = OutputFormat::Csv;
+                        }
+                        else if (format == "netcdf") {
+                        #ifdef NETCDF_ACTIVE
+                            this->output_config.format = OutputFormat::NetCDF;
+                        #else
+                            throw std::runtime_error("ERROR: NetCDF output requested, but NetCDF support isn't enabled.");
+                        #endif
+                        }
+                        else {
+                            throw std::runtime_error("ERROR: Unrecognized output format '" + format + "'.");
+                        }
+                    }
+
+                    if (output_parameters.has_key("path")) {
+                        this->output_config.path = output_parameters.at("path").as_string();
+                    }
+
+                    if (output_parameters.has_key("compression_level")) {
+                        long level = output_parameters.at("compression_level").as_natural_number();
+                        if (level < 0 || level > 9) {
+                            throw std::runtime_error("ERROR: Output config 'compression_level' must be from 0 to 9.");
+                        }
+                        this->output_config.compression_level = level;
+                    }
+
+                    if (output_parameters.has_key("block_timesteps")) {
+                        long block = output_parameters.at("block_timesteps").as_natural_number();
+                        if (block < 1) {
+                            throw std::runtime_error("ERROR: Output config 'block_timesteps' must be at least 1.");
+                        }
+                        this->output_config.block_timesteps = block;
+                    }
+                }
+
                 /**
                  * Read catchment configurations from configuration file
                  */      
@@ -245,6 +393,46 @@ namespace realization {
                     return "";
             }
 
+            /**
+             * @return The number of output timesteps routed at a time as the simulation runs, or 0 if routing is done
+             *         once at the end
+             */
+            unsigned int get_routing_window_timesteps() {
+                if(this->routing_config != nullptr)
+                    return this->routing_config->window_timesteps;
+                else
+                    return 0;
+            }
+
+            /**
+             * @return Whether nexus flows are configured to be handed to routing in memory, rather than read back from
+             *         nexus output files
+             */
+            bool get_routing_in_memory_flows() {
+                return this->routing_config != nullptr && this->routing_config->in_memory_flows;
+            }
+
+            /**
+             * @return The driver execution configuration, which holds defaults if none was configured
+             */
+            const execution_params& get_execution_params() const {
+                return this->execution_config;
+            }
+
+            /**
+             * @return The checkpoint configuration, which neither writes nor restores checkpoints if none was configured
+             */
+            const checkpoint_params& get_checkpoint_params() const {
+                return this->checkpoint_config;
+            }
+
+            /**
+             * @return The output configuration, which is CSV output if none was configured
+             */
+            const output_params& get_output_params() const {
+                return this->output_config;
+            }
+
 
         protected:
             std::shared_ptr<Catchment_Formulation> construct_formulation_from_tree(
@@ -305,8 +493,9 @@ namespace realization {
                     simulation_time_config.start_time,
                     simulation_time_config.end_time
                 );
+                set_forcing_read_options(forcing_config, &forcing_parameters);
 
-                std::shared_ptr<Catchment_Formulation> constructed_formulation = construct_formulation(formulation_type_key, identifier, forcing_config, output_stream);
+                std::shared_ptr<Catchment_Formulation> constructed_formulation = construct_formulation(formulation_type_key, identifier, forcing_config, output_stream, fabric);
                 //, geometry);
                 constructed_formulation->create_formulation(formulation_config, &global_formulation_parameters);
                 return constructed_formulation;
@@ -317,7 +506,7 @@ namespace realization {
 
                 forcing_params forcing_config = this->get_global_forcing_params(identifier, simulation_time_config);
 
-                std::shared_ptr<Catchment_Formulation> missing_formulation = construct_formulation(formulation_type_key, identifier, forcing_config, output_stream);
+                std::shared_ptr<Catchment_Formulation> missing_formulation = construct_formulation(formulation_type_key, identifier, forcing_config, output_stream, fabric);
                 // Need to work with a copy, since it is altered in-place
                 geojson::PropertyMap global_properties_copy = global_formulation_parameters;
                 Catchment_Formulation::config_pattern_substitution(global_properties_copy,
@@ -334,12 +523,14 @@ namespace realization {
                     provider = global_forcing.at("provider").as_string();
                 }
                 if (this->global_forcing.count("file_pattern") == 0) {
-                    return forcing_params(
+                    forcing_params forcing_config(
                         path,
                         provider,
                         simulation_time_config.start_time,
                         simulation_time_config.end_time
                     );
+                    set_forcing_read_options(forcing_config);
+                    return forcing_config;
                 }
 
                 // Since we are given a pattern, we need to identify the directory and pull out anything that matches the pattern
@@ -348,8 +539,22 @@ namespace realization {
                 }
 
                 std::string filepattern = this->global_forcing.at("file_pattern").as_string();
+                index_forcing_files(path, filepattern);
+
+                auto indexed_file = this->forcing_files_by_id.find(identifier);
+                if (indexed_file != this->forcing_files_by_id.end()) {
+                    forcing_params forcing_config(
+                        path + indexed_file->second,
+                        provider,
+                        simulation_time_config.start_time,
+                        simulation_time_config.end_time
+                    );
+                    set_forcing_read_options(forcing_config);
+                    return forcing_config;
+                }
 
-                int id_index = filepattern.find("{{id}}");
+                // Not indexed, e.g. for ids outside the hydrofabric, so match the listed files one by one
+                size_t id_index = filepattern.find("{{id}}");
 
                 // If an index for '{{id}}' was found, we can count on that being where the id for this realization can be found.
                 //     For instance, if we have a pattern of '.*{{id}}_14_15.csv' and this is named 'cat-87',
@@ -361,6 +566,103 @@ namespace realization {
                 // Create a regular expression used to identify proper file names
                 std::regex pattern(filepattern);
 
+                for (const std::string &file_name : this->forcing_file_names) {
+                    // If the file name matches the pattern, we can consider this ready to be interpretted as valid
+                    //    forcing data (even if it isn't)
+                    if (std::regex_match(file_name, pattern)) {
+                        forcing_params forcing_config(
+                            path + file_name,
+                            provider,
+                            simulation_time_config.start_time,
+                            simulation_time_config.end_time
+                        );
+                        set_forcing_read_options(forcing_config);
+                        return forcing_config;
+                    }
+                }
+
+                throw std::runtime_error("Forcing data could not be found for '" + identifier + "'");
+            }
+
+            /**
+             * Index the forcing files in a directory by the catchment ids that a file pattern matches them with.
+             *
+             * The directory is listed only once, and the index built in one pass over it, so finding each catchment's
+             * forcing file is a hash lookup rather than a match of the pattern against every file.  The pattern is split
+             * at its ``{{id}}`` into a prefix and suffix pattern, and a file is indexed under each hydrofabric catchment
+             * id found in its name that the prefix pattern matches all of the name before and the suffix pattern all of
+             * the name after.  As when matching the files one by one, a catchment gets the first such file listed.
+             *
+             * Nothing is indexed if there is no hydrofabric yet, or if the pattern cannot be split into two valid
+             * patterns (e.g., if ``{{id}}`` is inside a group), in which case callers fall back to matching each file.
+             *
+             * @param path The forcing directory, ending in ``/``.
+             * @param filepattern The file pattern, with ``{{id}}`` where the catchment id goes.
+             * @throws std::runtime_error If the directory cannot be opened.
+             */
+            void index_forcing_files(const std::string &path, const std::string &filepattern) {
+                const std::string index_key = path + "\n" + filepattern;
+                if (this->forcing_files_index_key == index_key) {
+                    return;
+                }
+                this->forcing_files_by_id.clear();
+                list_forcing_directory(path);
+                this->forcing_files_index_key = index_key;
+
+                size_t id_index = filepattern.find("{{id}}");
+                if (this->fabric == nullptr || id_index == std::string::npos) {
+                    // Callers match the listed files one by one instead
+                    return;
+                }
+
+                std::regex prefix_pattern, suffix_pattern;
+                try {
+                    prefix_pattern = std::regex(filepattern.substr(0, id_index));
+                    suffix_pattern = std::regex(filepattern.substr(id_index + sizeof("{{id}}") - 1));
+                }
+                catch (const std::regex_error &) {
+                    return;
+                }
+
+                std::unordered_set<std::string> ids;
+                std::set<size_t> id_lengths;
+                for (const geojson::Feature &feature : *this->fabric) {
+                    ids.insert(feature->get_id());
+                    id_lengths.insert(feature->get_id().size());
+                }
+
+                std::string candidate;
+                for (const std::string &file_name : this->forcing_file_names) {
+                    for (size_t start = 0; start < file_name.size(); ++start) {
+                        for (size_t length : id_lengths) {
+                            if (length == 0 || start + length > file_name.size()) {
+                                continue;
+                            }
+                            candidate.assign(file_name, start, length);
+                            if (ids.count(candidate) == 0 || this->forcing_files_by_id.count(candidate) != 0) {
+                                continue;
+                            }
+                            if (std::regex_match(file_name.begin(), file_name.begin() + start, prefix_pattern)
+                                && std::regex_match(file_name.begin() + start + length, file_name.end(), suffix_pattern)) {
+                                this->forcing_files_by_id.emplace(candidate, file_name);
+                            }
+                        }
+                    }
+                }
+            }
+
+            /**
+             * List the regular files and symlinks in the forcing directory, in directory order, once.
+             *
+             * @param path The forcing directory, ending in ``/``.
+             * @throws std::runtime_error If the directory cannot be opened.
+             */
+            void list_forcing_directory(const std::string &path) {
+                if (this->forcing_files_listed_path == path) {
+                    return;
+                }
+                this->forcing_file_names.clear();
+
                 // A stream providing the functions necessary for evaluating a directory:
                 //    https://www.gnu.org/software/libc/manual/html_node/Opening-a-Directory.html#Opening-a-Directory
                 DIR *directory = nullptr;
@@ -408,33 +710,79 @@ namespace realization {
                     errMsg = "Received system error number " + std::to_string(errno);
                 }
 
-                // If the directory could be found and opened, we can go ahead and iterate
-                if (directory != nullptr) {
-                    while ((entry = readdir(directory))) {
-                        // If the entry is a regular file or symlink AND the name matches the pattern, 
-                        //    we can consider this ready to be interpretted as valid forcing data (even if it isn't)
-                        if ((entry->d_type == DT_REG or entry->d_type == DT_LNK) and std::regex_match(entry->d_name, pattern)) {
-                            return forcing_params(
-                                path + entry->d_name,
-                                provider,
-                                simulation_time_config.start_time,
-                                simulation_time_config.end_time
-                            );
-                        }
-                    }
-                }
-                else {
+                if (directory == nullptr) {
                     // The directory wasn't found or otherwise couldn't be opened; forcing data cannot be retrieved
                     throw std::runtime_error("Error opening forcing data dir '" + path + "' after " + std::to_string(attemptCount) + " attempts: " + errMsg);
                 }
 
+                while ((entry = readdir(directory))) {
+                    // Only regular files or symlinks can be forcing data
+                    if (entry->d_type == DT_REG or entry->d_type == DT_LNK) {
+                        this->forcing_file_names.emplace_back(entry->d_name);
+                    }
+                }
                 closedir(directory);
+                this->forcing_files_listed_path = path;
+            }
 
-                throw std::runtime_error("Forcing data could not be found for '" + identifier + "'");
+            /**
+             * Set the options of forcing providers for reading and caching chunks of time steps, and reading ahead.
+             *
+             * Each option is taken from the catchment's own forcing config if it has it, and otherwise from the global
+             * forcing config.  When running time-blocked, chunks default to the block size.
+             *
+             * @param forcing_config The forcing config to set the options of.
+             * @param forcing_parameters The catchment's own forcing config, if it has one.
+             */
+            void set_forcing_read_options(forcing_params &forcing_config,
+                                           const geojson::JSONProperty *forcing_parameters = nullptr) {
+                auto get_option = [&](const std::string &key, long &value) {
+                    if (forcing_parameters != nullptr && forcing_parameters->has_key(key)) {
+                        value = forcing_parameters->at(key).as_natural_number();
+                    }
+                    else if (this->global_forcing.count(key) != 0) {
+                        value = this->global_forcing.at(key).as_natural_number();
+                    }
+                    else {
+                        return;
+                    }
+                    if (value < 0) {
+                        throw std::runtime_error("ERROR: Forcing config '" + key + "' must not be negative.");
+                    }
+                };
+                long chunk_time_steps = 0, cache_size_mb = 0, prefetch_time_steps = 0;
+                get_option("chunk_time_steps", chunk_time_steps);
+                get_option("cache_size_mb", cache_size_mb);
+                get_option("prefetch_time_steps", prefetch_time_steps);
+                // Running time-blocked, read a block's worth of each variable at once unless told otherwise, so a
+                // block's forcings come from one read of every catchment's values instead of a read per time step
+                if (chunk_time_steps == 0 && this->execution_config.mode == ExecutionMode::TimeBlocked) {
+                    chunk_time_steps = this->execution_config.block_size;
+                }
+                forcing_config.chunk_time_steps = chunk_time_steps;
+                forcing_config.cache_bytes = (size_t) cache_size_mb * 1024 * 1024;
+                forcing_config.prefetch_time_steps = prefetch_time_steps;
+
+                if (forcing_parameters != nullptr && forcing_parameters->has_key("weights_path")) {
+                    forcing_config.weights_path = forcing_parameters->at("weights_path").as_string();
+                }
+                else if (this->global_forcing.count("weights_path") != 0) {
+                    forcing_config.weights_path = this->global_forcing.at("weights_path").as_string();
+                }
             }
 
             boost::property_tree::ptree tree;
 
+            /** The hydrofabric of the catchments, for forcing providers that need their geometry */
+            geojson::GeoJSON fabric;
+
+            /** The forcing directory last listed, and the names of the files in it */
+            std::string forcing_files_listed_path;
+            std::vector<std::string> forcing_file_names;
+            /** The directory and file pattern last indexed, and the name of the forcing file of each catchment */
+            std::string forcing_files_index_key;
+            std::unordered_map<std::string, std::string> forcing_files_by_id;
+
             boost::property_tree::ptree global_formulation_tree;
 
             geojson::PropertyMap global_formulation_parameters;
@@ -446,6 +794,12 @@ namespace realization {
             std::shared_ptr<routing_params> routing_config;
 
             bool using_routing = false;
+
+            execution_params execution_config;
+
+            checkpoint_params checkpoint_config;
+
+            output_params output_config;
     };
 }
 #endif // NGEN_FORMULATION_MANAGER_H
@@ -0,0 +1,181 @@
+#ifndef NGEN_NEXUS_FLOW_BUFFER_HPP
+#define NGEN_NEXUS_FLOW_BUFFER_HPP
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef NGEN_MPI_ACTIVE
+#include <mpi.h>
+#endif
+
+namespace routing_py_adapter {
+
+    /**
+     * @brief Contiguous storage of nexus flows for a range of time steps, to hand to routing in memory.
+     *
+     * Flows are held nexus-major (i.e., a row of time steps for each nexus), which is the layout of a
+     * ``(nexus, time)`` row-major array, so routing can view the buffer directly as a 2-D numpy array alongside the
+     * list of nexus ids that indexes its rows.
+     */
+    class Nexus_Flow_Buffer {
+
+    public:
+
+        /**
+         * @brief Create a buffer for the given nexuses over a range of time steps.
+         *
+         * @param nexus_ids The id of each nexus, by nexus index (i.e., row).
+         * @param first_step The index of the first time step held, which is held in column 0.
+         * @param step_count The number of time steps held.
+         */
+        Nexus_Flow_Buffer(std::vector<std::string> nexus_ids, int first_step, int step_count) :
+            nexus_ids(std::move(nexus_ids)), first_step(first_step), step_count(0)
+        {
+            reset(first_step, step_count);
+        }
+
+        /**
+         * @brief Start holding a new range of time steps, with all flows zero.
+         *
+         * Storage is kept where possible, so reusing a buffer for successive windows of the same length does not
+         * allocate.
+         *
+         * @param first_step The index of the first time step held.
+         * @param step_count The number of time steps held.
+         */
+        void reset(int first_step, int step_count)
+        {
+            if (step_count < 0) {
+                throw std::runtime_error("Nexus flow buffer cannot hold a negative number of time steps");
+            }
+            this->first_step = first_step;
+            this->step_count = step_count;
+            flows.assign(nexus_ids.size() * step_count, 0.0);
+        }
+
+        /**
+         * @brief Set the flow of a nexus at a time step.
+         *
+         * @param nexus The index of the nexus.
+         * @param step The time step, which must be in the range held.
+         * @param flow The flow, in m^3/s.
+         */
+        void set_flow(size_t nexus, int step, double flow)
+        {
+            flows[nexus * step_count + (step - first_step)] = flow;
+        }
+
+        /**
+         * @param nexus The index of the nexus.
+         * @param step The time step, which must be in the range held.
+         * @return The flow of the nexus at the time step.
+         */
+        double get_flow(size_t nexus, int step) const
+        {
+            return flows[nexus * step_count + (step - first_step)];
+        }
+
+        /**
+         * @return The id of each nexus, by row.
+         */
+        const std::vector<std::string>& get_nexus_ids() const
+        {
+            return nexus_ids;
+        }
+
+        /**
+         * @return Pointer to the flows, nexus-major.
+         */
+        const double* data() const
+        {
+            return flows.data();
+        }
+
+        /**
+         * @return The number of nexuses (rows).
+         */
+        size_t nexus_count() const
+        {
+            return nexus_ids.size();
+        }
+
+        /**
+         * @return The index of the first time step held.
+         */
+        int get_first_step() const
+        {
+            return first_step;
+        }
+
+        /**
+         * @return The number of time steps held (columns).
+         */
+        int get_step_count() const
+        {
+            return step_count;
+        }
+
+    #ifdef NGEN_MPI_ACTIVE
+        /**
+         * @brief Collect the buffers of all ranks onto one rank.
+         *
+         * Every rank must call this at the same time, with buffers over the same range of time steps.
+         *
+         * @param root The rank that receives the flows.
+         * @param mpi_rank The current rank.
+         * @param mpi_num_procs The number of ranks.
+         * @return On the root rank, a buffer holding the nexuses of every rank, in rank order; on other ranks, an
+         *         empty buffer over the same time steps.
+         */
+        Nexus_Flow_Buffer gather(int root, int mpi_rank, int mpi_num_procs) const
+        {
+            // Nexus ids go as one block of null-terminated strings per rank
+            std::string local_ids;
+            for (const std::string &id : nexus_ids) {
+                local_ids.append(id).push_back('\0');
+            }
+            int local_sizes[2] = {(int) nexus_ids.size(), (int) local_ids.size()};
+            std::vector<int> sizes(mpi_rank == root ? 2 * mpi_num_procs : 0);
+            MPI_Gather(local_sizes, 2, MPI_INT, sizes.data(), 2, MPI_INT, root, MPI_COMM_WORLD);
+
+            std::vector<int> id_lengths, id_offsets, flow_counts, flow_offsets;
+            int total_nexuses = 0, total_id_length = 0;
+            if (mpi_rank == root) {
+                for (int r = 0; r < mpi_num_procs; ++r) {
+                    id_offsets.push_back(total_id_length);
+                    id_lengths.push_back(sizes[2 * r + 1]);
+                    total_id_length += sizes[2 * r + 1];
+                    flow_offsets.push_back(total_nexuses * step_count);
+                    flow_counts.push_back(sizes[2 * r] * step_count);
+                    total_nexuses += sizes[2 * r];
+                }
+            }
+
+            std::vector<char> all_ids(total_id_length);
+            MPI_Gatherv(local_ids.data(), local_sizes[1], MPI_CHAR, all_ids.data(), id_lengths.data(),
+                        id_offsets.data(), MPI_CHAR, root, MPI_COMM_WORLD);
+            Nexus_Flow_Buffer gathered(std::vector<std::string>(), first_step, 0);
+            gathered.step_count = step_count;
+            gathered.flows.resize((size_t) total_nexuses * step_count);
+            MPI_Gatherv(flows.data(), (int) flows.size(), MPI_DOUBLE, gathered.flows.data(), flow_counts.data(),
+                        flow_offsets.data(), MPI_DOUBLE, root, MPI_COMM_WORLD);
+
+            for (size_t pos = 0; pos < all_ids.size(); ) {
+                gathered.nexus_ids.emplace_back(all_ids.data() + pos);
+                pos += gathered.nexus_ids.back().size() + 1;
+            }
+            return gathered;
+        }
+    #endif // NGEN_MPI_ACTIVE
+
+    private:
+
+        std::vector<std::string> nexus_ids;
+        int first_step;
+        int step_count;
+        std::vector<double> flows;
+    };
+}
+
+#endif //NGEN_NEXUS_FLOW_BUFFER_HPP
@@ -10,10 +10,22 @@ struct routing_params
 {
     std::string t_route_config_file_with_path;
 
+    /**
+     * The number of output timesteps of nexus flows handed to routing at a time, as the simulation runs, or 0 to route
+     * all of them once the simulation is finished.
+     */
+    unsigned int window_timesteps;
+
+    /**
+     * Whether nexus flows are handed to routing in memory, rather than routing reading them back from nexus output
+     * files.
+     */
+    bool in_memory_flows;
+
     /**
      * Default constructor, using empty strings for both member values
      */
-    routing_params() : t_route_config_file_with_path("") {}
+    routing_params() : t_route_config_file_with_path(""), window_timesteps(0), in_memory_flows(false) {}
 
     /*
      * @brief Constructor for routing_params
@@ -21,7 +33,7 @@ struct routing_params
      * @param t_route_config_file_with_path
      */
     routing_params(std::string t_route_config_file_with_path):
-        t_route_config_file_with_path(t_route_config_file_with_path)
+        t_route_config_file_with_path(t_route_config_file_with_path), window_timesteps(0), in_memory_flows(false)
         {
         }
 
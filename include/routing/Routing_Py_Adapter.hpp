@@ -6,11 +6,13 @@
 #include <exception>
 #include <memory>
 #include <string>
+#include <vector>
 #include "pybind11/pybind11.h"
 #include "pybind11/pytypes.h"
 #include "pybind11/numpy.h"
 #include <pybind11/stl.h>
 #include "python/InterpreterUtil.hpp"
+#include "Nexus_Flow_Buffer.hpp"
 
 namespace py = pybind11;
 
@@ -27,30 +29,33 @@ namespace routing_py_adapter {
         Routing_Py_Adapter(std::string t_route_config_file_with_path);
 
         /**
-         * Function to run @p number_of_timesteps of routing, extracting 
-         * lateral inflows from @p flow_vector
-         * 
-         * FIXME This is current unimplemented and will require some addtional
-         * work to properly map flows to the correct t-route network segments.
-         * This may not even be the correct concept to implement this type of
-         * "integrated" routing.  But the basic idea is that after a catchment 
-         * update occurs, it contributes some amount of lateral flow to the channel
-         * as represented by @p flow_vector and this flow should be routed down stream
-         * for @p number_of_timesteps .  Note though, that all lateral inflows are required
-         * for a single routing pass of the network, so this would probably end up being a
-         * flow map that we pass to a custom t-route function that extracts the lateral inflow
-         * vector for each identity and constructs the correct lateral inflow setup to make
-         * a full routing pass.
-         * 
-         * See NOTE in @ref route(int, int) route() about python module availablity.
+         * Function to run a full set of routing computations using nexus flows held in memory, rather than read back
+         * from nexus output files.
          *
-         * @param number_of_timesteps
-         * @param delta_time
-         * @param flow_vector
+         * The flows are passed to the ngen_main subroutine, along with the usual arguments, as the keyword arguments
+         * ``nexus_ids`` (a list of the nexus id of each row) and ``nexus_flows`` (a 2-D ``(nexus, time)`` numpy array of
+         * flows in m^3/s).  The array is a view of @p flows, not a copy, so it is only valid for the duration of the
+         * call.
+         *
+         * Flows may also be routed a window of time steps at a time, over successive calls.  The keyword arguments
+         * ``first_timestep`` (the index of the buffer's first step) and ``last_window`` (whether no more calls follow)
+         * let routing carry its state from one window to the next.
+         *
+         * Only versions of ngen_main that take these keyword arguments support this; see
+         * @ref accepts_in_memory_flows.  See NOTE in @ref route(int, int) route() about python module availablity.
+         *
+         * @param flows The flow of every nexus to route.
+         * @param last_window Whether these are the last flows to route.
          */
-        void route(int number_of_timesteps, int delta_time,
-              const std::vector<double> &flow_vector);
+        void route(const Nexus_Flow_Buffer &flows, bool last_window = true);
 
+        /**
+         * Whether the loaded ngen_main subroutine takes the keyword arguments through which nexus flows are handed to
+         * it in memory, per its signature.
+         *
+         * @return Whether @ref route(const Nexus_Flow_Buffer&, bool) can be used.
+         */
+        bool accepts_in_memory_flows();
 
         /**
          * Function to run a full set of routing computations using the nexus output files
@@ -75,36 +80,6 @@ namespace routing_py_adapter {
         void route(int number_of_timesteps, int delta_time);
 
 
-        template <typename T>
-        void convert_vector_to_numpy_array(const std::vector<T> &flow_vector)
-        {
-            /**
-            * NOTE: Currently not using this function because current plan is to have routing read Nexus
-            * values from Nexus output files instead of passing in-memory values to t-route. If
-            * the ability to pass in-memory values to t-route is needed, then the following TODOs are
-            * needed.
-            * TODO: Retrieve and convert map of Nexus IDs with Nexus flow vectors to Python dictionary
-            *       of NumPy arrays
-            * TODO: Retrieve single time index vector for all Nexus flow values and convert to NumPy array
-            */
-
-            //Allocate py::array (to pass the result of the C++ function to Python)
-            auto result = py::array_t<T>(flow_vector.size());
-            auto result_buffer = result.request();
-            T *result_ptr = (T *) result_buffer.ptr;
-
-            //Copy std::vector -> py::array
-            std::memcpy(result_ptr, flow_vector.data(), flow_vector.size()*sizeof(T));
-
-            //Create object for receive_flow_values subroutine
-            py::object receive_flow_values = t_route_module.attr("receive_flow_values");
-
-            //Call receive_flow_values subroutine
-            receive_flow_values(result);
-
-        }
-
-
     private:
 
         /** A binding to the Python numpy package/module. */
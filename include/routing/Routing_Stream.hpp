@@ -0,0 +1,95 @@
+#ifndef NGEN_ROUTING_STREAM_HPP
+#define NGEN_ROUTING_STREAM_HPP
+
+#ifdef ACTIVATE_PYTHON
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "pybind11/pybind11.h"
+#include "Routing_Py_Adapter.hpp"
+#include "Nexus_Flow_Buffer.hpp"
+
+namespace py = pybind11;
+
+namespace routing_py_adapter {
+
+    /**
+     * @brief Routes nexus flows a window of time steps at a time, as the simulation produces them.
+     *
+     * Windows are routed in the order submitted.  When concurrent, they are routed on a background thread, so routing one
+     * window overlaps with the simulation of the next.  The Python interpreter lock is released from the first window
+     * submitted until @ref finish, so nothing else on the constructing thread may use Python in the meantime.
+     * Otherwise, each window is routed as it is submitted.
+     *
+     * At most one window waits while another is routed, so submitting blocks if routing falls behind, bounding the
+     * flows held in memory to about two windows.
+     */
+    class Routing_Stream {
+
+    public:
+
+        /**
+         * @brief Start a stream routing through the given adapter.
+         *
+         * @param router The adapter through which windows are routed, which must outlive the stream.
+         * @param concurrent Whether to route on a background thread.
+         */
+        Routing_Stream(Routing_Py_Adapter &router, bool concurrent);
+
+        /**
+         * @brief Stop routing, abandoning any windows waiting behind the next one and not reporting errors.
+         */
+        ~Routing_Stream();
+
+        /**
+         * @brief Route a window of nexus flows.
+         *
+         * If routing an earlier window failed, that error is thrown here.
+         *
+         * @param flows The flows to route, which are copied, so the buffer may be reused for the next window.
+         * @param last_window Whether these are the last flows to route.
+         */
+        void submit(const Nexus_Flow_Buffer &flows, bool last_window);
+
+        /**
+         * @brief Wait for every window submitted to be routed, then end the stream.
+         *
+         * This must be called on the thread that constructed the stream.  If routing any window failed, that error is
+         * thrown here.
+         */
+        void finish();
+
+    private:
+
+        struct Window {
+            Nexus_Flow_Buffer flows;
+            bool last_window;
+        };
+
+        void run();
+
+        void stop();
+
+        Routing_Py_Adapter &router;
+        bool concurrent;
+
+        /** Holds the interpreter lock released from the first window submitted until the stream stops. */
+        std::unique_ptr<py::gil_scoped_release> gil_release;
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable changed;
+        /** Windows submitted and not yet routed, the first of which is being routed. */
+        std::deque<Window> pending;
+        bool stopping;
+        std::exception_ptr error;
+    };
+}
+
+#endif //ACTIVATE_PYTHON
+
+#endif //NGEN_ROUTING_STREAM_HPP
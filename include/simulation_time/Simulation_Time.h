@@ -86,6 +86,15 @@ class Simulation_Time
         return output_interval_seconds;
     }
 
+    /**
+     * @brief Accessor to the epoch time at the beginning of an output time
+     * @return start_date_time_epoch + current_output_time_index * output_interval_seconds
+     */
+    time_t get_epoch_time(int current_output_time_index)
+    {
+        return start_date_time_epoch + (time_t)current_output_time_index * output_interval_seconds;
+    }
+
     /**
      * @brief Accessor to the current timestamp string
      * @return current_timestamp
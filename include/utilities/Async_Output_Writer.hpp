@@ -0,0 +1,465 @@
+#ifndef NGEN_ASYNC_OUTPUT_WRITER_HPP
+#define NGEN_ASYNC_OUTPUT_WRITER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace utils
+{
+    /**
+     * Writes text output for many files from a single background thread.
+     *
+     * Callers append data for a file, identified by the handle returned from @ref open, which only copies it into a
+     * per-file in-memory buffer under that file's own lock.  The writer thread repeatedly takes everything buffered so
+     * far and writes it out a file at a time, so many small writes (e.g., a line per catchment per time step) turn into
+     * a few large ones, and callers never wait on the filesystem or on each other unless the total amount of buffered
+     * data reaches its limit.
+     *
+     * Only a small, fixed number of files are kept open at once.  Files already open are written first in each batch,
+     * and when another file needs to be opened, the open file least recently written is closed; a closed file is
+     * reopened for appending if written again later.  Each file is truncated the first time it is opened.
+     *
+     * Errors writing files are held until the next call to @ref flush, which rethrows the first one.
+     */
+    class Async_Output_Writer
+    {
+        public:
+
+            /** The default maximum number of files held open at once. */
+            static const size_t DEFAULT_MAX_OPEN_FILES = 64;
+
+            /** The default maximum number of bytes that may be buffered before writers have to wait. */
+            static const size_t DEFAULT_MAX_PENDING_BYTES = 64 * 1024 * 1024;
+
+            /**
+             * Create a writer and start its background thread.
+             *
+             * @param max_open_files The maximum number of files held open at once; at least 1.
+             * @param max_pending_bytes The maximum number of bytes buffered before calls to @ref write wait.
+             */
+            explicit Async_Output_Writer(size_t max_open_files = DEFAULT_MAX_OPEN_FILES,
+                                         size_t max_pending_bytes = DEFAULT_MAX_PENDING_BYTES) :
+                max_open_files(std::max<size_t>(max_open_files, 1)),
+                max_pending_bytes(max_pending_bytes), pending_bytes(0), flush_requested(false), stopping(false)
+            {
+                writer_thread = std::thread(&Async_Output_Writer::writer_loop, this);
+            }
+
+            /**
+             * Write out everything still buffered and stop the background thread.
+             */
+            ~Async_Output_Writer()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(writer_mutex);
+                    stopping = true;
+                }
+                work_ready.notify_all();
+                writer_thread.join();
+                if (first_error) {
+                    try {
+                        std::rethrow_exception(first_error);
+                    }
+                    catch (const std::exception &e) {
+                        std::cerr << "Error writing output: " << e.what() << std::endl;
+                    }
+                }
+            }
+
+            Async_Output_Writer(const Async_Output_Writer&) = delete;
+            Async_Output_Writer& operator=(const Async_Output_Writer&) = delete;
+
+            /**
+             * Get the writer shared by all output of this process.
+             *
+             * @return The shared writer.
+             */
+            static std::shared_ptr<Async_Output_Writer> get_shared()
+            {
+                static std::shared_ptr<Async_Output_Writer> shared = std::make_shared<Async_Output_Writer>();
+                return shared;
+            }
+
+            /**
+             * Register a file to write output to.
+             *
+             * The file is created, or truncated if it exists, by the writer thread, even if nothing is ever written to it.
+             *
+             * @param path The path of the file.
+             * @return The handle to use to write to the file.
+             */
+            size_t open(const std::string &path)
+            {
+                size_t file;
+                {
+                    std::unique_lock<std::shared_timed_mutex> files_lock(files_mutex);
+                    // Start dirty, so the writer thread creates the file
+                    files.emplace_back(new File(path));
+                    files.back()->dirty = true;
+                    file = files.size() - 1;
+                }
+                std::lock_guard<std::mutex> lock(writer_mutex);
+                dirty_files.push_back(file);
+                work_ready.notify_one();
+                return file;
+            }
+
+            /**
+             * Append data to a file.
+             *
+             * The data is copied, so it need not outlive the call.  This only waits if the writer has fallen too far
+             * behind, i.e., if the total amount of buffered data would exceed the limit.
+             *
+             * @param file The handle of the file, as returned by @ref open.
+             * @param data Pointer to the data to write.
+             * @param count The number of bytes to write.
+             */
+            void write(size_t file, const char *data, size_t count)
+            {
+                size_t pending = pending_bytes.load();
+                if (pending != 0 && pending + count > max_pending_bytes) {
+                    std::unique_lock<std::mutex> lock(writer_mutex);
+                    space_available.wait(lock, [&]() {
+                        size_t pending = pending_bytes.load();
+                        return pending == 0 || pending + count <= max_pending_bytes;
+                    });
+                }
+
+                std::shared_lock<std::shared_timed_mutex> files_lock(files_mutex);
+                if (file >= files.size()) {
+                    throw std::runtime_error("Invalid output file handle " + std::to_string(file));
+                }
+                File &f = *files[file];
+                std::lock_guard<std::mutex> file_lock(f.mutex);
+                f.pending.append(data, count);
+                pending_bytes += count;
+                if (!f.dirty) {
+                    f.dirty = true;
+                    std::lock_guard<std::mutex> lock(writer_mutex);
+                    bool was_idle = dirty_files.empty();
+                    dirty_files.push_back(file);
+                    if (was_idle) {
+                        work_ready.notify_one();
+                    }
+                }
+            }
+
+            /**
+             * Append a string to a file.
+             *
+             * @param file The handle of the file, as returned by @ref open.
+             * @param data The string to write.
+             */
+            void write(size_t file, const std::string &data)
+            {
+                write(file, data.data(), data.size());
+            }
+
+            /**
+             * Wait until everything written so far has been written out to the files.
+             *
+             * @throws std::runtime_error If there was an error writing a file since the last flush.
+             */
+            void flush()
+            {
+                std::unique_lock<std::mutex> lock(writer_mutex);
+                flush_requested = true;
+                work_ready.notify_one();
+                drained.wait(lock, [&]() { return !flush_requested; });
+                if (first_error) {
+                    std::exception_ptr error = first_error;
+                    first_error = nullptr;
+                    std::rethrow_exception(error);
+                }
+            }
+
+        private:
+
+            struct File
+            {
+                explicit File(std::string path) : path(std::move(path)), dirty(false) {}
+
+                std::string path;
+                // Guarded by mutex
+                std::mutex mutex;
+                std::string pending;
+                bool dirty;
+            };
+
+            struct Open_File
+            {
+                std::unique_ptr<std::ofstream> stream;
+                // The value of writes when last written, to find the open file least recently written
+                size_t last_written;
+            };
+
+            struct Batch_Entry
+            {
+                size_t file;
+                std::string path;
+                std::string data;
+            };
+
+            void writer_loop()
+            {
+                std::vector<size_t> taken;
+                std::vector<Batch_Entry> batch;
+                std::unique_lock<std::mutex> lock(writer_mutex);
+                while (true) {
+                    work_ready.wait(lock, [&]() { return !dirty_files.empty() || flush_requested || stopping; });
+                    if (dirty_files.empty()) {
+                        if (!flush_requested) {
+                            break;
+                        }
+                        lock.unlock();
+                        std::exception_ptr error = flush_open_files();
+                        lock.lock();
+                        record_error(error);
+                        flush_requested = false;
+                        drained.notify_all();
+                        continue;
+                    }
+                    taken.clear();
+                    taken.swap(dirty_files);
+                    lock.unlock();
+
+                    // Take everything buffered so far, leaving the buffers free for callers to keep writing
+                    size_t taken_bytes = 0;
+                    {
+                        std::shared_lock<std::shared_timed_mutex> files_lock(files_mutex);
+                        // Files already open go first, so they are written before any need to be closed
+                        std::stable_partition(taken.begin(), taken.end(), [&](size_t file) {
+                            return open_files.count(file) > 0;
+                        });
+                        batch.resize(taken.size());
+                        for (size_t i = 0; i < taken.size(); ++i) {
+                            File &file = *files[taken[i]];
+                            std::lock_guard<std::mutex> file_lock(file.mutex);
+                            batch[i].file = taken[i];
+                            batch[i].path = file.path;
+                            batch[i].data.clear();
+                            batch[i].data.swap(file.pending);
+                            taken_bytes += batch[i].data.size();
+                            file.dirty = false;
+                        }
+                    }
+                    pending_bytes -= taken_bytes;
+                    {
+                        std::lock_guard<std::mutex> space_lock(writer_mutex);
+                        space_available.notify_all();
+                    }
+
+                    std::exception_ptr error;
+                    for (Batch_Entry &entry : batch) {
+                        try {
+                            write_entry(entry);
+                        }
+                        catch (...) {
+                            if (!error) {
+                                error = std::current_exception();
+                            }
+                        }
+                    }
+
+                    lock.lock();
+                    record_error(error);
+                }
+                // Everything has been written, so close all the files
+                lock.unlock();
+                std::exception_ptr error;
+                for (auto &open_file : open_files) {
+                    if (!close_file(*open_file.second.stream) && !error) {
+                        error = std::make_exception_ptr(std::runtime_error(
+                            "Could not write output file " + get_path(open_file.first)));
+                    }
+                }
+                open_files.clear();
+                lock.lock();
+                record_error(error);
+            }
+
+            /** Keep the first error until it is reported.  Only call with writer_mutex held. */
+            void record_error(std::exception_ptr error)
+            {
+                if (error && !first_error) {
+                    first_error = error;
+                }
+            }
+
+            /**
+             * Flush every open file, so what has been written to it is in the file.  Only used by the writer thread.
+             *
+             * @return The first error flushing a file, if any.
+             */
+            std::exception_ptr flush_open_files()
+            {
+                std::exception_ptr error;
+                for (auto &open_file : open_files) {
+                    if (!open_file.second.stream->flush()) {
+                        if (!error) {
+                            error = std::make_exception_ptr(std::runtime_error(
+                                "Could not write output file " + get_path(open_file.first)));
+                        }
+                        open_file.second.stream->clear();
+                    }
+                }
+                return error;
+            }
+
+            /**
+             * Close a file.  Only used by the writer thread.
+             *
+             * @return Whether what was left to write to the file could be.
+             */
+            static bool close_file(std::ofstream &stream)
+            {
+                stream.close();
+                return !stream.fail();
+            }
+
+            std::string get_path(size_t file)
+            {
+                std::shared_lock<std::shared_timed_mutex> files_lock(files_mutex);
+                return files[file]->path;
+            }
+
+            /**
+             * Write a batch entry to its file, opening the file if needed.  Only used by the writer thread.
+             */
+            void write_entry(const Batch_Entry &entry)
+            {
+                std::string close_error;
+                auto it = open_files.find(entry.file);
+                if (it == open_files.end()) {
+                    if (open_files.size() >= max_open_files) {
+                        auto closing = std::min_element(open_files.begin(), open_files.end(),
+                                                        [](const decltype(open_files)::value_type &a,
+                                                           const decltype(open_files)::value_type &b) {
+                                                            return a.second.last_written < b.second.last_written;
+                                                        });
+                        if (!close_file(*closing->second.stream)) {
+                            close_error = "Could not write output file " + get_path(closing->first);
+                        }
+                        open_files.erase(closing);
+                    }
+                    if (created_files.size() <= entry.file) {
+                        created_files.resize(entry.file + 1, false);
+                    }
+                    std::unique_ptr<std::ofstream> stream(new std::ofstream());
+                    stream->open(entry.path, created_files[entry.file] ? std::ios::app : std::ios::trunc);
+                    if (!stream->is_open()) {
+                        throw std::runtime_error("Could not open output file " + entry.path);
+                    }
+                    created_files[entry.file] = true;
+                    it = open_files.emplace(entry.file, Open_File{std::move(stream), 0}).first;
+                }
+                it->second.last_written = ++writes;
+                std::ofstream &stream = *it->second.stream;
+                stream.write(entry.data.data(), entry.data.size());
+                if (!stream) {
+                    throw std::runtime_error("Could not write output file " + entry.path);
+                }
+                if (!close_error.empty()) {
+                    throw std::runtime_error(close_error);
+                }
+            }
+
+            const size_t max_open_files;
+            const size_t max_pending_bytes;
+            std::atomic<size_t> pending_bytes;
+
+            // Guards the list of files; taken shared to use one, and exclusively to add one
+            std::shared_timed_mutex files_mutex;
+            std::vector<std::unique_ptr<File>> files;
+
+            // Guarded by writer_mutex
+            std::mutex writer_mutex;
+            std::condition_variable work_ready;
+            std::condition_variable space_available;
+            std::condition_variable drained;
+            std::vector<size_t> dirty_files;
+            bool flush_requested;
+            bool stopping;
+            std::exception_ptr first_error;
+
+            // Only used by the writer thread
+            std::unordered_map<size_t, Open_File> open_files;
+            std::vector<bool> created_files;
+            size_t writes = 0;
+
+            std::thread writer_thread;
+    };
+
+    /**
+     * An unbuffered stream buffer that passes each write (e.g., a whole output line) straight to a file of an
+     * @ref Async_Output_Writer, which does the buffering, so nothing is left behind in the stream to be synced.
+     */
+    class Async_Output_Streambuf : public std::streambuf
+    {
+        public:
+
+            Async_Output_Streambuf(std::shared_ptr<Async_Output_Writer> writer, size_t file) :
+                writer(std::move(writer)), file(file)
+            {
+            }
+
+        protected:
+
+            std::streamsize xsputn(const char *s, std::streamsize n) override
+            {
+                writer->write(file, s, n);
+                return n;
+            }
+
+            int_type overflow(int_type c) override
+            {
+                if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                    char ch = traits_type::to_char_type(c);
+                    writer->write(file, &ch, 1);
+                }
+                return traits_type::not_eof(c);
+            }
+
+        private:
+
+            std::shared_ptr<Async_Output_Writer> writer;
+            size_t file;
+    };
+
+    /**
+     * An output stream over a file of an @ref Async_Output_Writer.
+     *
+     * Flushing this stream (e.g., with ``std::endl``) does not wait on the file; use @ref Async_Output_Writer::flush.
+     */
+    class Async_Output_Stream : public std::ostream
+    {
+        public:
+
+            Async_Output_Stream(std::shared_ptr<Async_Output_Writer> writer, const std::string &path) :
+                std::ostream(nullptr), buffer(writer, writer->open(path))
+            {
+                rdbuf(&buffer);
+            }
+
+        private:
+
+            Async_Output_Streambuf buffer;
+    };
+}
+
+#endif //NGEN_ASYNC_OUTPUT_WRITER_HPP
@@ -2,6 +2,7 @@
 #define NGEN_FILE_STREAM_HANDLER_HPP
 
 #include "StreamHandler.hpp"
+#include "Async_Output_Writer.hpp"
 
 namespace utils
 {
@@ -17,6 +18,17 @@ namespace utils
             virtual ~FileStreamHandler(){}
     };
 
+    /** A StreamHandler for a file written in the background by the process's shared Async_Output_Writer. */
+    class AsyncFileStreamHandler : public StreamHandler
+    {
+      public:
+            AsyncFileStreamHandler(const char* path) : StreamHandler()
+            {
+                output_stream = std::make_shared<Async_Output_Stream>(Async_Output_Writer::get_shared(), path);
+            }
+            virtual ~AsyncFileStreamHandler(){}
+    };
+
 }
 
 
@@ -0,0 +1,375 @@
+#ifndef NGEN_MAPPED_CSV_READER_HPP
+#define NGEN_MAPPED_CSV_READER_HPP
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief A reader of CSV files that parses rows in place from a memory mapping of the file.
+ *
+ * Rather than building a string for every cell, as @ref CSVReader does, each row is split into fields that point
+ * directly into the mapped file, and numbers and timestamps are converted straight from those characters.  Lines are
+ * split on the delimiter without any quoting rules, as with @ref CSVReader, and blank lines are skipped.  Line endings
+ * may be ``\n`` or ``\r\n``.
+ */
+class Mapped_CSV_Reader
+{
+public:
+
+    /**
+     * @brief A field of a row, as a range of characters in the mapped file.
+     */
+    struct Field
+    {
+        const char *begin;
+        const char *end;
+
+        /**
+         * @return The field as a string.
+         */
+        std::string str() const
+        {
+            return std::string(begin, end);
+        }
+
+        /**
+         * @return The field without any leading or trailing whitespace.
+         */
+        Field trimmed() const
+        {
+            const char *b = begin, *e = end;
+            while (b < e && is_space(*b)) { ++b; }
+            while (e > b && is_space(*(e - 1))) { --e; }
+            return Field{b, e};
+        }
+
+        bool empty() const
+        {
+            return begin == end;
+        }
+    };
+
+    /**
+     * @brief Map a file for reading.
+     *
+     * @param file_name The path of the file.
+     * @param delimiter The character separating fields.
+     * @throws std::runtime_error If the file cannot be opened or mapped.
+     */
+    explicit Mapped_CSV_Reader(const std::string &file_name, char delimiter = ',') :
+        file_name(file_name), delimiter(delimiter), mapping(nullptr), size(0)
+    {
+        int fd = open(file_name.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Error: Input file " + file_name + " does not exist.");
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("Error: Could not read size of input file " + file_name + ".");
+        }
+        size = (size_t) info.st_size;
+        // Mapping an empty file fails, but there is nothing to read anyway
+        if (size > 0) {
+            void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Error: Could not map input file " + file_name + ": " + std::strerror(errno));
+            }
+            madvise(mapped, size, MADV_SEQUENTIAL);
+            mapping = static_cast<const char*>(mapped);
+        }
+        close(fd);
+        position = mapping;
+    }
+
+    ~Mapped_CSV_Reader()
+    {
+        if (mapping != nullptr) {
+            munmap(const_cast<char*>(mapping), size);
+        }
+    }
+
+    Mapped_CSV_Reader(const Mapped_CSV_Reader&) = delete;
+    Mapped_CSV_Reader& operator=(const Mapped_CSV_Reader&) = delete;
+
+    /**
+     * @brief Split the next non-blank line of the file into fields.
+     *
+     * @param fields Set to the fields of the row, which remain valid for the life of the reader.
+     * @return Whether there was another row.
+     */
+    bool next_row(std::vector<Field> &fields)
+    {
+        const char *file_end = mapping + size;
+        while (position < file_end) {
+            const char *line_end = static_cast<const char*>(std::memchr(position, '\n', file_end - position));
+            if (line_end == nullptr) {
+                line_end = file_end;
+            }
+            const char *line_begin = position;
+            position = line_end < file_end ? line_end + 1 : file_end;
+            ++line_number;
+
+            const char *content_end = line_end;
+            if (content_end > line_begin && *(content_end - 1) == '\r') {
+                --content_end;
+            }
+            if (content_end == line_begin) {
+                continue;
+            }
+
+            fields.clear();
+            const char *field_begin = line_begin;
+            for (const char *c = line_begin; c < content_end; ++c) {
+                if (*c == delimiter) {
+                    fields.push_back(Field{field_begin, c});
+                    field_begin = c + 1;
+                }
+            }
+            fields.push_back(Field{field_begin, content_end});
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @return The number of lines that rows returned so far extend to (i.e., the 1-based line number of the last row).
+     */
+    size_t get_line_number() const
+    {
+        return line_number;
+    }
+
+    /**
+     * @return The number of bytes of the file not yet read.
+     */
+    size_t remaining_bytes() const
+    {
+        return (mapping + size) - position;
+    }
+
+    const std::string &get_file_name() const
+    {
+        return file_name;
+    }
+
+    /**
+     * @brief Convert a field to a double.
+     *
+     * Surrounding whitespace is ignored.  Plain decimal values with up to 19 significant digits and small exponents
+     * (i.e., nearly all values in forcing files) are converted directly, with the result exactly as ``strtod`` would
+     * give; anything else is handed to ``strtod``.
+     *
+     * @param field The field to convert.
+     * @param value Set to the converted value.
+     * @return Whether the whole field is a valid number.
+     */
+    static bool parse_double(Field field, double &value)
+    {
+        field = field.trimmed();
+        const char *c = field.begin, *end = field.end;
+        if (c == end) {
+            return false;
+        }
+        bool negative = false;
+        if (*c == '-' || *c == '+') {
+            negative = *c == '-';
+            ++c;
+        }
+        uint64_t mantissa = 0;
+        int digits = 0, exponent = 0;
+        bool any_digits = false;
+        for (; c < end && is_digit(*c); ++c) {
+            any_digits = true;
+            if (digits < 19) {
+                if (mantissa != 0 || *c != '0') {
+                    mantissa = mantissa * 10 + (*c - '0');
+                    ++digits;
+                }
+            }
+            else {
+                ++exponent;
+            }
+        }
+        if (c < end && *c == '.') {
+            ++c;
+            for (; c < end && is_digit(*c); ++c) {
+                any_digits = true;
+                if (digits < 19) {
+                    if (mantissa != 0 || *c != '0') {
+                        mantissa = mantissa * 10 + (*c - '0');
+                        ++digits;
+                    }
+                    --exponent;
+                }
+            }
+        }
+        if (any_digits && c < end && (*c == 'e' || *c == 'E')) {
+            const char *e = c + 1;
+            bool negative_exp = false;
+            if (e < end && (*e == '-' || *e == '+')) {
+                negative_exp = *e == '-';
+                ++e;
+            }
+            int exp_value = 0;
+            bool exp_digits = false;
+            for (; e < end && is_digit(*e); ++e) {
+                exp_digits = true;
+                if (exp_value < 100000) {
+                    exp_value = exp_value * 10 + (*e - '0');
+                }
+            }
+            if (exp_digits) {
+                exponent += negative_exp ? -exp_value : exp_value;
+                c = e;
+            }
+        }
+        // Had any significant digits been dropped, the mantissa would be at least 10^18, so it is exact here
+        if (any_digits && c == end && mantissa <= (uint64_t(1) << 53)
+            && exponent >= -22 && exponent <= 22) {
+            // Both the mantissa and the power of ten are exact doubles, so one multiplication or division rounds
+            // correctly
+            double result = (double) mantissa;
+            if (exponent < 0) {
+                result /= power_of_ten(-exponent);
+            }
+            else {
+                result *= power_of_ten(exponent);
+            }
+            value = negative ? -result : result;
+            return true;
+        }
+        return parse_double_slow(field, value);
+    }
+
+    /**
+     * @brief Convert a field in the form ``YYYY-MM-DD HH:MM:SS``, as UTC, to an epoch time.
+     *
+     * Surrounding whitespace is ignored.  Timestamps with exactly that layout are converted directly; anything else
+     * is handed to ``strptime`` with that format.
+     *
+     * @param field The field to convert.
+     * @param epoch_time Set to the converted time.
+     * @return Whether the field is a valid timestamp.
+     */
+    static bool parse_timestamp(Field field, time_t &epoch_time)
+    {
+        field = field.trimmed();
+        const char *c = field.begin;
+        if (field.end - c == 19 && c[4] == '-' && c[7] == '-' && c[10] == ' ' && c[13] == ':' && c[16] == ':'
+            && all_digits(c, 4) && all_digits(c + 5, 2) && all_digits(c + 8, 2) && all_digits(c + 11, 2)
+            && all_digits(c + 14, 2) && all_digits(c + 17, 2)) {
+            int year = to_int(c, 4), month = to_int(c + 5, 2), day = to_int(c + 8, 2);
+            int hour = to_int(c + 11, 2), minute = to_int(c + 14, 2), second = to_int(c + 17, 2);
+            if (month >= 1 && month <= 12 && day >= 1 && day <= 31 && hour <= 23 && minute <= 59 && second <= 60) {
+                epoch_time = (time_t) days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+                return true;
+            }
+        }
+        std::string text = field.str();
+        struct tm parsed = tm();
+        const char *parsed_end = strptime(text.c_str(), "%Y-%m-%d %H:%M:%S", &parsed);
+        if (parsed_end == nullptr) {
+            return false;
+        }
+        epoch_time = timegm(&parsed);
+        return true;
+    }
+
+private:
+
+    static bool is_space(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+
+    static bool is_digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    static bool all_digits(const char *c, int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            if (!is_digit(c[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static int to_int(const char *c, int count)
+    {
+        int value = 0;
+        for (int i = 0; i < count; ++i) {
+            value = value * 10 + (c[i] - '0');
+        }
+        return value;
+    }
+
+    /**
+     * Days since 1970-01-01 of a date in the proleptic Gregorian calendar.
+     */
+    static int64_t days_from_civil(int64_t year, int month, int day)
+    {
+        year -= month <= 2;
+        const int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const int64_t year_of_era = year - era * 400;
+        const int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + day_of_era - 719468;
+    }
+
+    static bool parse_double_slow(Field field, double &value)
+    {
+        char buffer[64];
+        std::string long_text;
+        const size_t length = field.end - field.begin;
+        const char *text;
+        if (length < sizeof(buffer)) {
+            std::memcpy(buffer, field.begin, length);
+            buffer[length] = '\0';
+            text = buffer;
+        }
+        else {
+            long_text = field.str();
+            text = long_text.c_str();
+        }
+        char *parsed_end;
+        value = std::strtod(text, &parsed_end);
+        return length > 0 && parsed_end == text + length;
+    }
+
+    /**
+     * The powers of ten that are exact as doubles, from 0 to 22.
+     */
+    static double power_of_ten(int exponent)
+    {
+        static const double powers[23] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+                                          1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        return powers[exponent];
+    }
+
+    std::string file_name;
+    char delimiter;
+    const char *mapping;
+    size_t size;
+    const char *position = nullptr;
+    size_t line_number = 0;
+};
+
+#endif //NGEN_MAPPED_CSV_READER_HPP
@@ -0,0 +1,185 @@
+#ifndef NGEN_OUTPUT_LINE_BUFFER_HPP
+#define NGEN_OUTPUT_LINE_BUFFER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace utils
+{
+    /**
+     * A reusable character buffer for building lines of text output, such as a row of formulation output values.
+     *
+     * Numeric values are formatted exactly as a ``std::ostream`` set to ``std::fixed`` with the same precision would
+     * format them (which is also how ``std::to_string`` formats a ``double`` at a precision of 6), but without the stream
+     * machinery: integral values are converted directly, and anything else goes through ``snprintf`` straight into the
+     * buffer.  Clearing the buffer keeps its storage, so once it has grown to the length of a line, building further lines
+     * does not allocate.
+     */
+    class Output_Line_Buffer
+    {
+        public:
+
+            Output_Line_Buffer() : buffer(256), length(0) {}
+
+            /**
+             * Empty the buffer, keeping its storage for reuse.
+             */
+            void clear()
+            {
+                length = 0;
+            }
+
+            /**
+             * Discard everything after the given length, e.g., to undo appending a partial line.
+             *
+             * @param new_length The length to cut the contents back to, which must not exceed the current length.
+             */
+            void truncate(size_t new_length)
+            {
+                if (new_length < length) {
+                    length = new_length;
+                }
+            }
+
+            /**
+             * Append raw characters.
+             *
+             * @param data Pointer to the characters to append.
+             * @param count The number of characters to append.
+             */
+            void append(const char *data, size_t count)
+            {
+                reserve(count);
+                std::memcpy(buffer.data() + length, data, count);
+                length += count;
+            }
+
+            /**
+             * Append a string.
+             *
+             * @param value The string to append.
+             */
+            void append(const std::string &value)
+            {
+                append(value.data(), value.size());
+            }
+
+            /**
+             * Append a single character.
+             *
+             * @param value The character to append.
+             */
+            void append(char value)
+            {
+                reserve(1);
+                buffer[length++] = value;
+            }
+
+            /**
+             * Append an integer in decimal.
+             *
+             * @param value The integer to append.
+             */
+            void append_integer(long long value)
+            {
+                // Work with the magnitude as unsigned, so the most negative value does not overflow
+                unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+                char digits[24];
+                char *end = digits + sizeof(digits);
+                char *start = end;
+                do {
+                    *--start = (char)('0' + magnitude % 10);
+                    magnitude /= 10;
+                } while (magnitude != 0);
+                if (value < 0) {
+                    *--start = '-';
+                }
+                append(start, end - start);
+            }
+
+            /**
+             * Append a floating point value in fixed notation.
+             *
+             * @param value The value to append.
+             * @param precision The number of decimal places.
+             */
+            void append_fixed(double value, int precision)
+            {
+                // Integral values (most often 0) are common in model output, and are exact to convert without snprintf
+                if (std::fabs(value) < 1e15 && std::trunc(value) == value) {
+                    if (std::signbit(value)) {
+                        append('-');
+                    }
+                    append_integer((long long)std::fabs(value));
+                    if (precision > 0) {
+                        reserve(precision + 1);
+                        buffer[length++] = '.';
+                        std::memset(buffer.data() + length, '0', precision);
+                        length += precision;
+                    }
+                    return;
+                }
+                size_t available = buffer.size() - length;
+                int written = std::snprintf(buffer.data() + length, available, "%.*f", precision, value);
+                if (written < 0) {
+                    return;
+                }
+                if ((size_t)written >= available) {
+                    // snprintf also needs room for its terminating null
+                    reserve(written + 1);
+                    std::snprintf(buffer.data() + length, written + 1, "%.*f", precision, value);
+                }
+                length += written;
+            }
+
+            /**
+             * @return Pointer to the contents, which are not null-terminated.
+             */
+            const char* data() const
+            {
+                return buffer.data();
+            }
+
+            /**
+             * @return The number of characters in the buffer.
+             */
+            size_t size() const
+            {
+                return length;
+            }
+
+            /**
+             * @return Whether the buffer is empty.
+             */
+            bool empty() const
+            {
+                return length == 0;
+            }
+
+            /**
+             * @return A copy of the contents as a string.
+             */
+            std::string str() const
+            {
+                return std::string(buffer.data(), length);
+            }
+
+        private:
+
+            void reserve(size_t count)
+            {
+                if (length + count > buffer.size()) {
+                    buffer.resize(std::max(buffer.size() * 2, length + count));
+                }
+            }
+
+            std::vector<char> buffer;
+            size_t length;
+    };
+}
+
+#endif //NGEN_OUTPUT_LINE_BUFFER_HPP
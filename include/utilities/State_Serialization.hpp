@@ -0,0 +1,173 @@
+#ifndef NGEN_STATE_SERIALIZATION_HPP
+#define NGEN_STATE_SERIALIZATION_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace utils
+{
+    /**
+     * Append-only binary buffer used to capture the state of simulation objects, e.g., for checkpoints.
+     *
+     * Values are written in native byte order and without padding; anything read back with a @ref State_Reader must
+     * be read in the same order and with the same types it was written.
+     */
+    class State_Writer
+    {
+        public:
+
+            /**
+             * Append a trivially copyable value.
+             *
+             * @tparam T The type of value, which should be a fixed-size type (e.g., ``int64_t`` rather than ``long``)
+             *           for anything that needs to be read back on another platform.
+             * @param value The value to append.
+             */
+            template <class T>
+            void write(const T &value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "State_Writer can only write trivially copyable types");
+                write_bytes(&value, sizeof(T));
+            }
+
+            /**
+             * Append a string, prefixed with its length.
+             *
+             * @param value The string to append.
+             */
+            void write_string(const std::string &value)
+            {
+                write<uint64_t>(value.size());
+                write_bytes(value.data(), value.size());
+            }
+
+            /**
+             * Append raw bytes, without any length prefix.
+             *
+             * @param data Pointer to the bytes to append.
+             * @param count The number of bytes to append.
+             */
+            void write_bytes(const void *data, size_t count)
+            {
+                const char *bytes = static_cast<const char*>(data);
+                buffer.insert(buffer.end(), bytes, bytes + count);
+            }
+
+            /**
+             * @return The bytes written so far.
+             */
+            const std::vector<char>& data() const
+            {
+                return buffer;
+            }
+
+            /**
+             * @return The number of bytes written so far.
+             */
+            size_t size() const
+            {
+                return buffer.size();
+            }
+
+            /**
+             * Move the written bytes out of this instance, leaving it empty.
+             *
+             * @return The bytes written so far.
+             */
+            std::vector<char> release()
+            {
+                std::vector<char> released;
+                released.swap(buffer);
+                return released;
+            }
+
+        private:
+
+            std::vector<char> buffer;
+    };
+
+    /**
+     * Sequential reader over bytes written by a @ref State_Writer.
+     *
+     * The reader does not own the bytes it reads, which must outlive it.  Attempting to read beyond the end of the
+     * bytes throws a @ref std::runtime_error rather than reading out of bounds.
+     */
+    class State_Reader
+    {
+        public:
+
+            State_Reader(const char *data, size_t size) : data(data), size(size), position(0) {}
+
+            explicit State_Reader(const std::vector<char> &bytes) : State_Reader(bytes.data(), bytes.size()) {}
+
+            /**
+             * Read the next trivially copyable value.
+             *
+             * @tparam T The type of value, which must match the type that was written.
+             * @return The value read.
+             */
+            template <class T>
+            T read()
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "State_Reader can only read trivially copyable types");
+                T value;
+                read_bytes(&value, sizeof(T));
+                return value;
+            }
+
+            /**
+             * Read the next length-prefixed string.
+             *
+             * @return The string read.
+             */
+            std::string read_string()
+            {
+                uint64_t length = read<uint64_t>();
+                require(length);
+                std::string value(data + position, length);
+                position += length;
+                return value;
+            }
+
+            /**
+             * Read the given number of raw bytes.
+             *
+             * @param dest Where to copy the bytes read.
+             * @param count The number of bytes to read.
+             */
+            void read_bytes(void *dest, size_t count)
+            {
+                require(count);
+                std::memcpy(dest, data + position, count);
+                position += count;
+            }
+
+            /**
+             * @return The number of bytes that have not yet been read.
+             */
+            size_t remaining() const
+            {
+                return size - position;
+            }
+
+        private:
+
+            void require(uint64_t count) const
+            {
+                if (count > remaining()) {
+                    throw std::runtime_error("State data ended unexpectedly (needed " + std::to_string(count)
+                                             + " more bytes, but only " + std::to_string(remaining()) + " remain)");
+                }
+            }
+
+            const char *data;
+            size_t size;
+            size_t position;
+    };
+}
+
+#endif //NGEN_STATE_SERIALIZATION_HPP
@@ -84,6 +84,16 @@ namespace utils
                 }
             }
 
+            /** Write a block of characters onto the stored stream, without any formatting. */
+
+            void write(const char* data, std::streamsize count)
+            {
+                if ( output_stream != nullptr)
+                {
+                    output_stream->write(data, count);
+                }
+            }
+
             /** stream write operator that allows a StreamHandler to be used as a stream object */
 
             template<class DataType> std::ostream& operator<<(const DataType& val)
@@ -0,0 +1,190 @@
+#ifndef NGEN_THREAD_POOL_HPP
+#define NGEN_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+    /**
+     * A small, fixed-size pool of worker threads for running index-based parallel loops.
+     *
+     * The pool is sized to include the thread that calls @ref parallel_for, so a pool of size 1 spawns no workers and
+     * simply runs everything serially on the calling thread.  Work is handed out one index at a time from a shared
+     * atomic counter, which keeps the load balanced when individual items (e.g., catchments) vary in cost.
+     *
+     * The pool is not reentrant: @ref parallel_for must only be called from one thread at a time, and never from within
+     * a task running on the pool.
+     */
+    class ThreadPool
+    {
+        public:
+
+            /**
+             * Create a pool with the given total number of threads, including the calling thread.
+             *
+             * @param num_threads The total number of threads to use; if 0, the hardware concurrency is used.
+             */
+            explicit ThreadPool(size_t num_threads) : task(nullptr), task_count(0), next_index(0), generation(0),
+                                                      busy_workers(0), shutdown(false)
+            {
+                if (num_threads == 0) {
+                    num_threads = hardware_threads();
+                }
+                for (size_t i = 1; i < num_threads; ++i) {
+                    workers.emplace_back(&ThreadPool::worker_loop, this);
+                }
+            }
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            ~ThreadPool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(pool_mutex);
+                    shutdown = true;
+                }
+                work_available.notify_all();
+                for (auto &worker : workers) {
+                    worker.join();
+                }
+            }
+
+            /**
+             * Get the number of hardware threads, falling back to 1 when this cannot be determined.
+             *
+             * @return The number of hardware threads.
+             */
+            static size_t hardware_threads()
+            {
+                unsigned int n = std::thread::hardware_concurrency();
+                return n == 0 ? 1 : n;
+            }
+
+            /**
+             * @return The total number of threads participating in work, including the calling thread.
+             */
+            size_t size() const
+            {
+                return workers.size() + 1;
+            }
+
+            /**
+             * Execute ``func`` for every index in ``[0, count)`` using all threads of the pool, blocking until done.
+             *
+             * If ``caller_func`` is given, it is executed first on the calling thread (and only there) while the worker
+             * threads begin on the indexed work; the calling thread then joins in on any indices that remain.  This
+             * allows work that must stay on the main thread, such as anything calling into the embedded Python
+             * interpreter, to overlap with the parallel work.
+             *
+             * If any invocation throws, the remaining work still runs to completion and the first exception caught is
+             * rethrown on the calling thread.
+             *
+             * @param count The number of indices to process.
+             * @param func The function to execute for each index.
+             * @param caller_func Optional function to execute on the calling thread only.
+             */
+            void parallel_for(size_t count, const std::function<void(size_t)> &func,
+                              const std::function<void()> &caller_func = std::function<void()>())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(pool_mutex);
+                    task = &func;
+                    task_count = count;
+                    next_index.store(0);
+                    first_error = nullptr;
+                    busy_workers = workers.size();
+                    ++generation;
+                }
+                work_available.notify_all();
+
+                if (caller_func) {
+                    try {
+                        caller_func();
+                    }
+                    catch (...) {
+                        record_error(std::current_exception());
+                    }
+                }
+                run_tasks();
+
+                std::exception_ptr error;
+                {
+                    std::unique_lock<std::mutex> lock(pool_mutex);
+                    work_done.wait(lock, [this] { return busy_workers == 0; });
+                    task = nullptr;
+                    error = first_error;
+                    first_error = nullptr;
+                }
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+
+        private:
+
+            void worker_loop()
+            {
+                unsigned long seen_generation = 0;
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(pool_mutex);
+                        work_available.wait(lock, [&] { return shutdown || generation != seen_generation; });
+                        if (shutdown) {
+                            return;
+                        }
+                        seen_generation = generation;
+                    }
+                    run_tasks();
+                    {
+                        std::lock_guard<std::mutex> lock(pool_mutex);
+                        if (--busy_workers == 0) {
+                            work_done.notify_one();
+                        }
+                    }
+                }
+            }
+
+            void run_tasks()
+            {
+                size_t i;
+                while ((i = next_index.fetch_add(1)) < task_count) {
+                    try {
+                        (*task)(i);
+                    }
+                    catch (...) {
+                        record_error(std::current_exception());
+                    }
+                }
+            }
+
+            void record_error(std::exception_ptr e)
+            {
+                std::lock_guard<std::mutex> lock(pool_mutex);
+                if (!first_error) {
+                    first_error = e;
+                }
+            }
+
+            std::vector<std::thread> workers;
+            std::mutex pool_mutex;
+            std::condition_variable work_available;
+            std::condition_variable work_done;
+
+            const std::function<void(size_t)> *task;
+            size_t task_count;
+            std::atomic<size_t> next_index;
+            unsigned long generation;
+            size_t busy_workers;
+            bool shutdown;
+            std::exception_ptr first_error;
+    };
+}
+
+#endif //NGEN_THREAD_POOL_HPP
@@ -1,6 +1,8 @@
 #ifndef NGEN_BMI_UTILITIES_HPP
 #define NGEN_BMI_UTILITIES_HPP
 
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <boost/type_index.hpp>
@@ -28,24 +30,131 @@ namespace models {
             }
         }
 
+        /**
+         * @brief The C++ types that BMI variable values may be read and written as.
+         *
+         * Resolve a variable's type to one of these once, with @ref get_bmi_type, rather than comparing type names each
+         * time a value is read or written.
+         */
+        enum class BmiType {
+            DOUBLE,
+            FLOAT,
+            LONG_DOUBLE,
+            SHORT,
+            UNSIGNED_SHORT,
+            INT,
+            UNSIGNED_INT,
+            LONG,
+            UNSIGNED_LONG,
+            LONG_LONG,
+            UNSIGNED_LONG_LONG,
+            UNKNOWN
+        };
+
+        /**
+         * @brief Get the @ref BmiType for a type name.
+         *
+         * Accepts the names of the C++ types (in any of their equivalent spellings), as well as the Fortran names
+         * ``double precision``, ``real`` and ``integer``.
+         *
+         * @param type The type name, such as returned by a model's ``GetVarType`` or ``get_analogous_cxx_type``.
+         * @return The type, or ``BmiType::UNKNOWN`` if there is no support for the named type.
+         */
+        inline BmiType get_bmi_type(const std::string &type) {
+            if (type == "double" || type == "double precision")
+                return BmiType::DOUBLE;
+            if (type == "float" || type == "real")
+                return BmiType::FLOAT;
+            if (type == "long double")
+                return BmiType::LONG_DOUBLE;
+            if (type == "short" || type == "short int" || type == "signed short" || type == "signed short int")
+                return BmiType::SHORT;
+            if (type == "unsigned short" || type == "unsigned short int")
+                return BmiType::UNSIGNED_SHORT;
+            if (type == "int" || type == "signed" || type == "signed int" || type == "integer")
+                return BmiType::INT;
+            if (type == "unsigned" || type == "unsigned int")
+                return BmiType::UNSIGNED_INT;
+            if (type == "long" || type == "long int" || type == "signed long" || type == "signed long int")
+                return BmiType::LONG;
+            if (type == "unsigned long" || type == "unsigned long int")
+                return BmiType::UNSIGNED_LONG;
+            if (type == "long long" || type == "long long int" || type == "signed long long" || type == "signed long long int")
+                return BmiType::LONG_LONG;
+            if (type == "unsigned long long" || type == "unsigned long long int")
+                return BmiType::UNSIGNED_LONG_LONG;
+            return BmiType::UNKNOWN;
+        }
+
+        /** An empty value standing for the C++ type @tparam T, passed to the functions given to @ref dispatch_bmi_type. */
+        template<typename T>
+        struct bmi_type_tag {
+            typedef T type;
+        };
+
+        /**
+         * @brief Call a function for the C++ type of a @ref BmiType.
+         *
+         * The function is called with a @ref bmi_type_tag of the C++ type, so a generic lambda can get the type with
+         * ``typename decltype(tag)::type``, and must return the same type for every C++ type.
+         *
+         * @tparam F The type of the function.
+         * @param type The type to call the function for.
+         * @param f The function.
+         * @return What the function returns.
+         * @throws std::invalid_argument If the type is ``BmiType::UNKNOWN``.
+         */
+        template<typename F>
+        auto dispatch_bmi_type(BmiType type, F &&f) -> decltype(f(bmi_type_tag<double>())) {
+            switch (type) {
+                case BmiType::DOUBLE:
+                    return f(bmi_type_tag<double>());
+                case BmiType::FLOAT:
+                    return f(bmi_type_tag<float>());
+                case BmiType::LONG_DOUBLE:
+                    return f(bmi_type_tag<long double>());
+                case BmiType::SHORT:
+                    return f(bmi_type_tag<short>());
+                case BmiType::UNSIGNED_SHORT:
+                    return f(bmi_type_tag<unsigned short>());
+                case BmiType::INT:
+                    return f(bmi_type_tag<int>());
+                case BmiType::UNSIGNED_INT:
+                    return f(bmi_type_tag<unsigned int>());
+                case BmiType::LONG:
+                    return f(bmi_type_tag<long>());
+                case BmiType::UNSIGNED_LONG:
+                    return f(bmi_type_tag<unsigned long>());
+                case BmiType::LONG_LONG:
+                    return f(bmi_type_tag<long long>());
+                case BmiType::UNSIGNED_LONG_LONG:
+                    return f(bmi_type_tag<unsigned long long>());
+                default:
+                    throw std::invalid_argument("Cannot dispatch on an unknown BMI type.");
+            }
+        }
+
         /**
          * @brief Copy values from a BMI model adapter and box them into a vector.
-         * 
+         *
          * @tparam T Type to cast data from the BMI model to
          * @tparam A Bmi model type
          * @param model Bmi model adapter that interfaces to @tparam A bmi
          * @param name Bmi variable name to query the model for
+         * @param type The already resolved type of the variable in the model
          * @return std::vector<T> Copy of data from the BMI model for variable @param name
          */
         template <typename T, typename A>
-        std::vector<T> GetValue(Bmi_Adapter<A>& model, const std::string& name) {
-            //TODO make model const ref
+        std::vector<T> GetValue(Bmi_Adapter<A>& model, const std::string& name, BmiType type) {
+            if (type == BmiType::UNKNOWN) {
+                throw std::runtime_error("Unable to get value of variable " + name +
+                                " as " + boost::typeindex::type_id<T>().pretty_name() + ": no logic for converting variable type " +
+                                model.GetVarType(name));
+            }
             int total_mem = model.GetVarNbytes(name);
             int item_size = model.GetVarItemsize(name);
             int num_items = total_mem/item_size;
-            //Determine what type we need to cast from
-            std::string type = model.get_analogous_cxx_type(model.GetVarType(name), item_size);
-            
+
             //C++ form of malloc
             void* data = ::operator new(total_mem);
             // Use smart pointer to ensure cleanup on throw/out of scope...
@@ -55,7 +164,6 @@ namespace models {
             //Note, may be able to optimize this furthur using GetValuePtr
             //which would avoid copying in the BMI model and copying again here
             model.GetValue(name, data);
-            std::vector<T> result;
 
             /*
             * Allows the std::vector constructor to type cast the values as it copies them.
@@ -65,45 +173,35 @@ namespace models {
             * on the recieving side correctly.  This may be tricky for certain langague adapters (Fortran?)
             * Untill this becomes burdensome on memory/time, I suggest copying and converting each value
             */
+            return dispatch_bmi_type(type, [data, num_items](auto tag) -> std::vector<T> {
+                typedef typename decltype(tag)::type FROM;
+                return helper::make_vector<T>( (FROM*) data, num_items);
+            });
+        }
 
-            if (type == "long double"){
-                result = helper::make_vector<T>( (long double*) data, num_items);
-            }
-            else if (type == "double"){
-                result = helper::make_vector<T>( (double*) data, num_items);
-            }
-            else if (type == "float"){
-                result = helper::make_vector<T>( (float*) data, num_items);
-            }
-            else if (type == "short" || type == "short int" || type == "signed short" || type == "signed short int"){
-                result = helper::make_vector<T>( (short*) data, num_items);
-            }
-            else if (type == "unsigned short" || type == "unsigned short int"){
-                result = helper::make_vector<T>( (unsigned short*) data, num_items);
-            }
-            else if (type == "int" || type == "signed" || type == "signed int"){
-                result = helper::make_vector<T>( (int*) data, num_items);
-            }
-            else if (type == "unsigned" || type == "unsigned int"){
-                result = helper::make_vector<T>( (unsigned int*) data, num_items);
-            }
-            else if (type == "long" || type == "long int" || type == "signed long" || type == "signed long int"){
-                result = helper::make_vector<T>( (long*) data, num_items);
-            }
-            else if (type == "unsigned long" || type == "unsigned long int"){
-                result = helper::make_vector<T>( (unsigned long*) data, num_items);
-            }
-            else if (type == "long long" || type == "long long int" || type == "signed long long" || type == "signed long long int"){
-                result = helper::make_vector<T>( (long long*) data, num_items);
-            }
-            else if (type == "unsigned long long" || type == "unsigned long long int"){
-                result = helper::make_vector<T>( (unsigned long long*) data, num_items);
-            }
-            else{
+        /**
+         * @brief Copy values from a BMI model adapter and box them into a vector.
+         *
+         * This resolves the type of the variable on each call, so where values of the same variable are read many
+         * times, resolve it once with @ref get_bmi_type and use the overload taking a @ref BmiType.
+         *
+         * @tparam T Type to cast data from the BMI model to
+         * @tparam A Bmi model type
+         * @param model Bmi model adapter that interfaces to @tparam A bmi
+         * @param name Bmi variable name to query the model for
+         * @return std::vector<T> Copy of data from the BMI model for variable @param name
+         */
+        template <typename T, typename A>
+        std::vector<T> GetValue(Bmi_Adapter<A>& model, const std::string& name) {
+            //TODO make model const ref
+            //Determine what type we need to cast from
+            std::string type = model.get_analogous_cxx_type(model.GetVarType(name), model.GetVarItemsize(name));
+            BmiType bmi_type = get_bmi_type(type);
+            if (bmi_type == BmiType::UNKNOWN) {
                 throw std::runtime_error("Unable to get value of variable " + name +
                                 " as " + boost::typeindex::type_id<T>().pretty_name() + ": no logic for converting variable type " + type);
             }
-            return result;
+            return GetValue<T>(model, name, bmi_type);
         }
     }
 }
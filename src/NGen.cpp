@@ -1,16 +1,26 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <sstream>
 #include <unordered_map>
 
 #include "realizations/catchment/Formulation_Manager.hpp"
 #include <Catchment_Formulation.hpp>
 #include <HY_Features.hpp>
+#include <Execution_Plan.hpp>
+#include <Wavefront_Scheduler.hpp>
+#include <Checkpoint_Manager.hpp>
+#ifdef NETCDF_ACTIVE
+#include <NetCDF_Output.hpp>
+#endif
 
 #include "NGenConfig.h"
 #include "tshirt_params.h"
 
 #include <FileChecker.h>
+#include <ThreadPool.hpp>
+#include <Async_Output_Writer.hpp>
+#include <Output_Line_Buffer.hpp>
 #include <boost/algorithm/string.hpp>
 
 #ifdef WRITE_PID_FILE_FOR_GDB_SERVER
@@ -23,6 +33,8 @@
     
 #ifdef NGEN_ROUTING_ACTIVE
 #include "routing/Routing_Py_Adapter.hpp"
+#include "routing/Nexus_Flow_Buffer.hpp"
+#include "routing/Routing_Stream.hpp"
 #endif // NGEN_ROUTING_ACTIVE
 
 std::string catchmentDataFile = "";
@@ -46,10 +58,8 @@ int mpi_rank;
 int mpi_num_procs;
 #endif
 
-std::unordered_map<std::string, std::ofstream> nexus_outfiles;
-
-//Note: Use below if developing in-memory transfer of nexus flows to routing
-//std::unordered_map<std::string, std::vector<double>> nexus_flows;
+//Nexus output file handles of the output writer, indexed by the nexus output slots of the execution plan
+std::vector<size_t> nexus_outfiles;
 
 pdm03_struct get_et_params() {
   // create the struct used for ET
@@ -245,6 +255,22 @@ int main(int argc, char *argv[]) {
     #ifdef NGEN_MPI_ACTIVE
     }
     #endif //NGEN_MPI_ACTIVE
+    //By default, routing reads nexus flows back from the nexus output files once the simulation is finished.  When
+    //configured, and when ngen_main takes them, flows are instead handed to routing in memory.
+    bool in_memory_routing = false;
+    if(router && manager->get_routing_in_memory_flows()) {
+      in_memory_routing = router->accepts_in_memory_flows();
+      if(!in_memory_routing) {
+        std::cerr<<"WARNING: routing is configured for in-memory nexus flows, but ngen_main does not take them;"
+                 <<" routing from nexus output files instead."<<std::endl;
+      }
+    }
+    #ifdef NGEN_MPI_ACTIVE
+    //Only rank 0 loads routing, so every rank follows its decision
+    int in_memory_routing_flag = in_memory_routing ? 1 : 0;
+    MPI_Bcast(&in_memory_routing_flag, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    in_memory_routing = in_memory_routing_flag != 0;
+    #endif //NGEN_MPI_ACTIVE
     #endif //NGEN_ROUTING_ACTIVE
 
     std::string link_key = "toid";
@@ -262,120 +288,389 @@ int main(int argc, char *argv[]) {
     //catchment_collection.reset();
     nexus_collection.reset();
 
+    //Resolve everything the time loop needs once, so each time step only works over plain arrays
+    hy_features::Execution_Plan plan(features, catchment_collection);
+
     //Still hacking nexus output for the moment
-    for(const auto& id : features.nexuses()) {
-        #ifdef NGEN_MPI_ACTIVE
-        if (!features.is_remote_sender_nexus(id)) {
-          nexus_outfiles[id].open("./"+id+"_output.csv", std::ios::trunc);
-        }
-        #else
-        nexus_outfiles[id].open("./"+id+"_output.csv", std::ios::trunc);
-        #endif
+    //Output files are written by a background thread, shared with catchment output, so the time loop never waits on them
+    std::shared_ptr<utils::Async_Output_Writer> output_writer = utils::Async_Output_Writer::get_shared();
+    std::ostringstream nexus_rows;
+    const bool netcdf_output = manager->get_output_params().is_netcdf();
+    bool nexus_csv_output = !netcdf_output;
+  #ifdef NGEN_ROUTING_ACTIVE
+    //Routing from files reads the nexus output files, whatever the output format
+    if(manager->get_using_routing() && !in_memory_routing) {
+      nexus_csv_output = true;
+    }
+  #endif
+    if(nexus_csv_output) {
+      nexus_outfiles.resize(plan.nexus_count());
+      for(size_t n = 0; n < plan.nexus_count(); ++n) {
+          nexus_outfiles[n] = output_writer->open("./"+plan.nexus_ids[n]+"_output.csv");
+      }
     }
 
     std::cout<<"Running Models"<<std::endl;
 
     std::shared_ptr<pdm03_struct> pdm_et_data = std::make_shared<pdm03_struct>(get_et_params());
 
-    //Now loop some time, iterate catchments, do stuff for total number of output times
-    for(int output_time_index = 0; output_time_index < manager->Simulation_Time_Object->get_total_output_times(); output_time_index++) {
-      //std::cout<<"Output Time Index: "<<output_time_index<<std::endl;
-      if(output_time_index%100 == 0) std::cout<<"Running timestep "<<output_time_index<<std::endl;
-      std::string current_timestamp = manager->Simulation_Time_Object->get_timestamp(output_time_index);
-      for(const auto& id : features.catchments()) {
-        //std::cout<<"Running cat "<<id<<std::endl;
-        auto r = features.catchment_at(id);
-        //TODO redesign to avoid this cast
-        auto r_c = dynamic_pointer_cast<realization::Catchment_Formulation>(r);
-        r_c->set_et_params(pdm_et_data);
-        double response = r_c->get_response(output_time_index, 3600.0);
-        std::string output = std::to_string(output_time_index)+","+current_timestamp+","+
-                             r_c->get_output_line_for_timestep(output_time_index)+"\n";
-        r_c->write_output(output);
-        //TODO put this somewhere else.  For now, just trying to ensure we get m^3/s into nexus output
-        try{
-          response *= (catchment_collection->get_feature(id)->get_property("areasqkm").as_real_number() * 1000000);
-        }catch(std::invalid_argument &e)
-        {
-          response *= (catchment_collection->get_feature(id)->get_property("area_sqkm").as_real_number() * 1000000);
-        }
-        //TODO put this somewhere else as well, for now, an implicit assumption is that a modules get_response returns
-        //m/timestep
-        //since we are operating on a 1 hour (3600s) dt, we need to scale the output appropriately
-        //so no response is m^2/hr...m^2/hr * 1hr/3600s = m^3/hr
-        response /= 3600.0;
-        //update the nexus with this flow
-        for(auto& nexus : features.destination_nexuses(id)) {
-          //TODO in a DENDRIDIC network, only one destination nexus per catchment
-          //If there is more than one, some form of catchment partitioning will be required.
-          //for now, only contribute to the first one in the list
-          nexus->add_upstream_flow(response, id, output_time_index);
-	        break;
-        }
-      } //done catchments
-      //At this point, could make an internal routing pass, extracting flows from nexuses and routing
-      //across the flowpath to the next nexus.
-      //Once everything is updated for this timestep, dump the nexus output
-      for(const auto& id : features.nexuses()) {
+    //Catchments only interact through nexuses, so within a time step their formulations can run concurrently.
+    //Formulations that are not thread safe (e.g., Python BMI) are kept in order on the main thread, and all nexus
+    //contributions are applied serially afterward in a fixed order, so results do not depend on the thread count.
+    const execution_params& exec_params = manager->get_execution_params();
+    const bool wavefront = exec_params.mode == ExecutionMode::Wavefront;
+    //The wavefront scheduler manages its own threads
+    utils::ThreadPool catchment_pool(wavefront ? 1 : exec_params.threads);
+    const size_t num_threads = exec_params.threads == 0 ? utils::ThreadPool::hardware_threads() : exec_params.threads;
+    std::vector<bool> main_thread_only(plan.catchment_count(), false);
+    std::vector<size_t> main_thread_catchments;
+    std::vector<size_t> pool_catchments;
+    for(size_t i = 0; i < plan.catchment_count(); ++i) {
+      plan.catchment_formulations[i]->set_et_params(pdm_et_data);
+      if(num_threads > 1 && !plan.catchment_formulations[i]->is_thread_safe()) {
+        main_thread_only[i] = true;
+        main_thread_catchments.push_back(i);
+      }
+      else {
+        pool_catchments.push_back(i);
+      }
+    }
+    if(num_threads > 1) {
+      std::cout<<"Running catchments on "<<num_threads<<" threads ("<<main_thread_catchments.size()
+               <<" restricted to the main thread)"<<std::endl;
+    }
+
+    const int total_output_times = manager->Simulation_Time_Object->get_total_output_times();
+
+    //Checkpoints are per process, so the rank picks out which file to write or restore from
+    int checkpoint_rank = 0;
   #ifdef NGEN_MPI_ACTIVE
-        if (!features.is_remote_sender_nexus(id)) { //Ensures only one side of the dual sided remote nexus actually doing this...
+    checkpoint_rank = mpi_rank;
   #endif
-          //Get the correct "requesting" id for downstream_flow
-	        const auto& nexus = features.nexus_at(id);
-          const auto& cat_ids = nexus->get_receiving_catchments();
-          std::string cat_id;
-          if( cat_ids.size() > 0 ) {
-            //Assumes dendridic, e.g. only a single downstream...it will consume 100%  of the available flow
-            cat_id = cat_ids[0];
+    hy_features::Checkpoint_Manager checkpoints(manager->get_checkpoint_params(), checkpoint_rank);
+    checkpoints.validate(plan);
+    int first_output_time = 0;
+    if(manager->get_checkpoint_params().is_restoring()) {
+      first_output_time = checkpoints.restore(plan, total_output_times,
+                                              manager->Simulation_Time_Object->get_epoch_time(0),
+                                              manager->Simulation_Time_Object->get_output_interval_seconds());
+      std::cout<<"Restored state from checkpoint; resuming at timestep "<<first_output_time<<std::endl;
+    }
+
+  #ifdef NGEN_ROUTING_ACTIVE
+    //Nexus flows handed to routing in memory are routed a window of time steps at a time as the simulation runs, or
+    //all at once at the end by default
+    std::unique_ptr<routing_py_adapter::Nexus_Flow_Buffer> routing_flows;
+    std::unique_ptr<routing_py_adapter::Routing_Stream> routing_stream;
+    int routing_window = 0;
+    if(in_memory_routing) {
+      routing_window = manager->get_routing_window_timesteps();
+      if(routing_window == 0) {
+        routing_window = std::max(1, total_output_times - first_output_time);
+      }
+      routing_flows.reset(new routing_py_adapter::Nexus_Flow_Buffer(
+          plan.nexus_ids, first_output_time, std::min(routing_window, total_output_times - first_output_time)));
+      if(router) {
+        //Routing can only overlap the simulation if no formulation needs the Python interpreter while it runs
+        const bool concurrent_routing = manager->get_routing_window_timesteps() > 0 &&
+            std::none_of(plan.catchment_formulations.begin(), plan.catchment_formulations.end(),
+                         [](const std::shared_ptr<realization::Catchment_Formulation>& f) { return f->uses_python(); });
+        if(manager->get_routing_window_timesteps() > 0) {
+          std::cout<<"Routing every "<<routing_window<<" timesteps"
+                   <<(concurrent_routing ? ", concurrently with the simulation" : "")<<std::endl;
+        }
+        routing_stream.reset(new routing_py_adapter::Routing_Stream(*router, concurrent_routing));
+      }
+    }
+    //Once a time step completes the routing window, hand its nexus flows off and start the next window
+    auto end_routing_step = [&](int output_time_index) {
+      const int next_output_time = output_time_index + 1;
+      if(!routing_flows
+         || next_output_time - routing_flows->get_first_step() < routing_flows->get_step_count()) {
+        return;
+      }
+      const bool last_window = next_output_time == total_output_times;
+    #ifdef NGEN_MPI_ACTIVE
+      //Routing runs on rank 0, so collect the nexus flows of every rank there
+      routing_py_adapter::Nexus_Flow_Buffer all_flows = routing_flows->gather(0, mpi_rank, mpi_num_procs);
+      if(routing_stream) {
+        routing_stream->submit(all_flows, last_window);
+      }
+    #else
+      if(routing_stream) {
+        routing_stream->submit(*routing_flows, last_window);
+      }
+    #endif
+      routing_flows->reset(next_output_time, std::min(routing_window, total_output_times - next_output_time));
+    };
+  #endif
+
+    //All catchment and nexus time series go to one NetCDF file per process, a block of time steps at a time
+  #ifdef NETCDF_ACTIVE
+    std::unique_ptr<hy_features::NetCDF_Output> netcdf_writer;
+    if(netcdf_output) {
+      const output_params& out_params = manager->get_output_params();
+      std::string netcdf_path = out_params.path;
+    #ifdef NGEN_MPI_ACTIVE
+      netcdf_path += "." + std::to_string(mpi_rank);
+    #endif
+      netcdf_path += ".nc";
+      std::vector<std::vector<std::string>> catchment_fields(plan.catchment_count());
+      for(size_t i = 0; i < plan.catchment_count(); ++i) {
+        std::string header = plan.catchment_formulations[i]->get_output_header_line(",");
+        boost::split(catchment_fields[i], header, boost::is_any_of(","));
+      }
+      //Output is written a configured block at a time whatever the execution mode, with room to buffer the time steps
+      //catchments may run ahead of the last completed one: a window for the wavefront, else a time block
+      const int netcdf_ahead = exec_params.mode == ExecutionMode::Wavefront ? exec_params.block_size
+                                                                            : exec_params.get_time_block_size();
+      netcdf_writer.reset(new hy_features::NetCDF_Output(
+          netcdf_path, plan.catchment_ids, catchment_fields, plan.nexus_ids, first_output_time,
+          manager->Simulation_Time_Object->get_epoch_time(first_output_time),
+          manager->Simulation_Time_Object->get_output_interval_seconds(), out_params.block_timesteps, netcdf_ahead,
+          out_params.compression_level));
+      std::cout<<"Writing output to "<<netcdf_path<<std::endl;
+    }
+  #endif
+
+    //A reused line buffer per catchment for its CSV output rows, so formatting a row does not allocate
+    std::vector<utils::Output_Line_Buffer> catchment_lines(plan.catchment_count());
+
+    //Run one catchment for one output time, returning its contribution to its destination nexus
+    auto run_catchment_step = [&](size_t i, int output_time_index, const std::string& current_timestamp) {
+      //std::cout<<"Running cat "<<plan.catchment_ids[i]<<std::endl;
+      realization::Catchment_Formulation* r_c = plan.catchment_formulations[i].get();
+      double response = r_c->get_response(output_time_index, 3600.0);
+    #ifdef NETCDF_ACTIVE
+      if(netcdf_writer) {
+        netcdf_writer->set_catchment_values(i, output_time_index, r_c->get_output_values_for_timestep(output_time_index));
+      }
+      else
+    #endif
+      {
+        utils::Output_Line_Buffer& line = catchment_lines[i];
+        line.clear();
+        line.append_integer(output_time_index);
+        line.append(',');
+        line.append(current_timestamp);
+        line.append(',');
+        r_c->append_output_line_for_timestep(output_time_index, line);
+        line.append('\n');
+        r_c->write_output(line.data(), line.size());
+      }
+      //TODO put this somewhere else.  For now, just trying to ensure we get m^3/s into nexus output
+      response *= plan.catchment_areas_m2[i];
+      //TODO put this somewhere else as well, for now, an implicit assumption is that a modules get_response returns
+      //m/timestep
+      //since we are operating on a 1 hour (3600s) dt, we need to scale the output appropriately
+      //so no response is m^2/hr...m^2/hr * 1hr/3600s = m^3/hr
+      response /= 3600.0;
+      return response;
+    };
+
+    if(wavefront) {
+      //Each catchment runs a time step as soon as the catchments upstream of it are done with it, up to a window of
+      //time steps ahead of the oldest one not yet complete.  Once all catchments are done with a time step, its nexus
+      //contributions are applied and output written on this thread, in order, while later time steps keep running.
+      const int window = exec_params.block_size;
+      std::cout<<"Running catchments as a wavefront over a window of "<<window<<" timesteps"<<std::endl;
+      std::vector<double> catchment_responses(plan.catchment_count() * window);
+      std::vector<std::string> window_timestamps(window);
+      for(int output_time_index = first_output_time;
+          output_time_index < std::min(first_output_time + window, total_output_times); output_time_index++) {
+        window_timestamps[output_time_index % window] = manager->Simulation_Time_Object->get_timestamp(output_time_index);
+      }
+      hy_features::Wavefront_Scheduler scheduler(plan.catchment_upstream, plan.catchment_levels, main_thread_only,
+                                                 num_threads, window);
+      scheduler.run(
+        total_output_times,
+        [&](size_t i, int output_time_index) {
+          const int slot = output_time_index % window;
+          catchment_responses[i * window + slot] = run_catchment_step(i, output_time_index, window_timestamps[slot]);
+        },
+        [&](int output_time_index) {
+          if(output_time_index%100 == 0) std::cout<<"Running timestep "<<output_time_index<<std::endl;
+          const int slot = output_time_index % window;
+          for(size_t i = 0; i < plan.catchment_count(); ++i) {
+            //update the nexus with this flow
+            if(plan.catchment_destinations[i] != nullptr) {
+              plan.catchment_destinations[i]->add_upstream_flow(catchment_responses[i * window + slot],
+                                                                plan.catchment_ids[i], output_time_index);
+            }
           }
-          else {
-            //This is a terminal node, SHOULDN'T be remote, so ID shouldn't matter too much
-            cat_id = "terminal";
+          //No catchment starts a checkpoint time step until the one before it is complete, so state can be saved here
+          const bool checkpoint = checkpoints.is_checkpoint_time(output_time_index + 1);
+          for(size_t n = 0; n < plan.nexus_count(); ++n) {
+            double contribution_at_t = plan.nexuses[n]->get_downstream_flow(plan.nexus_requesting_ids[n],
+                                                                            output_time_index, 100.0);
+          #ifdef NETCDF_ACTIVE
+            if(netcdf_writer) {
+              netcdf_writer->set_nexus_flow(n, output_time_index, contribution_at_t);
+            }
+          #endif
+          #ifdef NGEN_ROUTING_ACTIVE
+            if(routing_flows) {
+              routing_flows->set_flow(n, output_time_index, contribution_at_t);
+            }
+          #endif
+            if(nexus_csv_output) {
+              nexus_rows.str("");
+              nexus_rows << output_time_index << ", " << window_timestamps[slot] << ", " << contribution_at_t << "\n";
+              output_writer->write(nexus_outfiles[n], nexus_rows.str());
+            }
           }
-          double contribution_at_t = features.nexus_at(id)->get_downstream_flow(cat_id, output_time_index, 100.0);
-          if(nexus_outfiles[id].is_open()) {
-            nexus_outfiles[id] << output_time_index << ", " << current_timestamp << ", " << contribution_at_t << std::endl;
+        #ifdef NGEN_ROUTING_ACTIVE
+          end_routing_step(output_time_index);
+        #endif
+        #ifdef NETCDF_ACTIVE
+          //Catchments may already be setting values up to a window ahead, which the NetCDF buffer leaves room for
+          if(netcdf_writer) {
+            netcdf_writer->write_blocks(output_time_index + 1,
+                                        output_time_index + 1 == total_output_times || checkpoint);
           }
-  #ifdef NGEN_MPI_ACTIVE
+        #endif
+          if(checkpoint) {
+            checkpoints.write(plan, output_time_index + 1,
+                              manager->Simulation_Time_Object->get_epoch_time(output_time_index + 1));
+          }
+          //This slot is free now, so ready it for the time step that will reuse it
+          if(output_time_index + window < total_output_times) {
+            window_timestamps[slot] = manager->Simulation_Time_Object->get_timestamp(output_time_index + window);
+          }
+        },
+        first_output_time,
+        [&](int output_time_index) { return checkpoints.is_checkpoint_time(output_time_index); }
+      );
+    }
+    else {
+      //Catchments are advanced through a block of output times at a time, which is a single time step unless running in
+      //time-blocked mode.  Since catchments are only coupled by nexus summation, each catchment can be run through the
+      //whole block before the next one; contributions are buffered per catchment and applied to the nexuses afterward,
+      //for each time step in the same order as when stepping, and nexus output is then buffered and written per block.
+      const int block_size = exec_params.get_time_block_size();
+      if(block_size > 1) {
+        std::cout<<"Running catchments in time blocks of "<<block_size<<" timesteps"<<std::endl;
+      }
+      std::vector<double> catchment_responses(plan.catchment_count() * block_size);
+      std::vector<double> nexus_block_flows(plan.nexus_count() * block_size);
+      std::vector<std::string> block_timestamps(block_size);
+
+      //Now loop some time, iterate catchments, do stuff for total number of output times
+      //Blocks are cut short at checkpoint times, so state is only saved between time steps
+      for(int block_start = first_output_time, block_end; block_start < total_output_times; block_start = block_end) {
+        block_end = std::min(block_start + block_size, checkpoints.next_checkpoint_time(block_start, total_output_times));
+        for(int output_time_index = block_start; output_time_index < block_end; output_time_index++) {
+          //std::cout<<"Output Time Index: "<<output_time_index<<std::endl;
+          if(output_time_index%100 == 0) std::cout<<"Running timestep "<<output_time_index<<std::endl;
+          block_timestamps[output_time_index - block_start] = manager->Simulation_Time_Object->get_timestamp(output_time_index);
+        }
+        auto run_catchment = [&](size_t i) {
+          for(int output_time_index = block_start; output_time_index < block_end; output_time_index++) {
+            catchment_responses[i * block_size + (output_time_index - block_start)] =
+                run_catchment_step(i, output_time_index, block_timestamps[output_time_index - block_start]);
+          }
+        };
+        catchment_pool.parallel_for(
+          pool_catchments.size(),
+          [&](size_t p) { run_catchment(pool_catchments[p]); },
+          [&]() {
+            for(size_t i : main_thread_catchments) {
+              run_catchment(i);
+            }
+          }
+        );
+        for(int output_time_index = block_start; output_time_index < block_end; output_time_index++) {
+          for(size_t i = 0; i < plan.catchment_count(); ++i) {
+            //update the nexus with this flow
+            if(plan.catchment_destinations[i] != nullptr) {
+              plan.catchment_destinations[i]->add_upstream_flow(
+                  catchment_responses[i * block_size + (output_time_index - block_start)], plan.catchment_ids[i],
+                  output_time_index);
+            }
+          } //done catchments
+          //At this point, could make an internal routing pass, extracting flows from nexuses and routing
+          //across the flowpath to the next nexus.
+          //Once everything is updated for this timestep, collect the nexus output
+          for(size_t n = 0; n < plan.nexus_count(); ++n) {
+            nexus_block_flows[n * block_size + (output_time_index - block_start)] =
+                plan.nexuses[n]->get_downstream_flow(plan.nexus_requesting_ids[n], output_time_index, 100.0);
+          #ifdef NETCDF_ACTIVE
+            if(netcdf_writer) {
+              netcdf_writer->set_nexus_flow(n, output_time_index,
+                                            nexus_block_flows[n * block_size + (output_time_index - block_start)]);
+            }
+          #endif
+          #ifdef NGEN_ROUTING_ACTIVE
+            if(routing_flows) {
+              routing_flows->set_flow(n, output_time_index,
+                                      nexus_block_flows[n * block_size + (output_time_index - block_start)]);
+            }
+          #endif
+            //std::cout<<"\tNexus "<<id<<" has "<<contribution_at_t<<" m^3/s"<<std::endl;
+          } //done nexuses
+        #ifdef NGEN_ROUTING_ACTIVE
+          end_routing_step(output_time_index);
+        #endif
+        } //done time
+        //Dump the nexus output for the block
+        for(size_t n = 0; nexus_csv_output && n < plan.nexus_count(); ++n) {
+          nexus_rows.str("");
+          for(int output_time_index = block_start; output_time_index < block_end; output_time_index++) {
+            nexus_rows << output_time_index << ", " << block_timestamps[output_time_index - block_start] << ", "
+                       << nexus_block_flows[n * block_size + (output_time_index - block_start)] << "\n";
+          }
+          output_writer->write(nexus_outfiles[n], nexus_rows.str());
+        }
+      #ifdef NETCDF_ACTIVE
+        if(netcdf_writer) {
+          netcdf_writer->write_blocks(block_end, block_end == total_output_times
+                                                 || checkpoints.is_checkpoint_time(block_end));
         }
+      #endif
+        if(checkpoints.is_checkpoint_time(block_end)) {
+          checkpoints.write(plan, block_end, manager->Simulation_Time_Object->get_epoch_time(block_end));
+        }
+      } //done blocks
+    }
+    //Make sure the last checkpoint is on disk, and surface any error writing it
+    checkpoints.wait();
+    //Likewise for output files
+    output_writer->flush();
+  #ifdef NETCDF_ACTIVE
+    if(netcdf_writer) {
+      netcdf_writer->close();
+    }
   #endif
-        //std::cout<<"\tNexus "<<id<<" has "<<contribution_at_t<<" m^3/s"<<std::endl;
-
-        //Note: Use below if developing in-memory transfer of nexus flows to routing
-        //If using below, then another single time vector would be needed to hold the timestamp
-        //nexus_flows[id].push_back(contribution_at_t); 
-      } //done nexuses
-    } //done time
     std::cout<<"Finished "<<manager->Simulation_Time_Object->get_total_output_times()<<" timesteps."<<std::endl;
+    //Report how well forcing reads kept ahead of the models
+    for(const auto& prefetcher : data_access::PrefetchingDataProvider::get_shared_providers()) {
+      std::cout<<"Forcing prefetch: "<<prefetcher->get_hits()<<" values read ahead, "<<prefetcher->get_misses()
+               <<" read on demand, "<<prefetcher->get_stall_seconds()<<" seconds waiting on reads"<<std::endl;
+    }
 
 
   #ifdef NGEN_ROUTING_ACTIVE
+    if(routing_stream) {
+      //Wait for the last window to be routed, and surface any error routing
+      routing_stream->finish();
+    }
+    else if(manager->get_using_routing() && !in_memory_routing) {
+    #ifdef NGEN_MPI_ACTIVE
+      //Every rank must have written its nexus output files before they are routed
+      MPI_Barrier(MPI_COMM_WORLD);
+    #endif //NGEN_MPI_ACTIVE
+      if(router) {
+        //Note: Currently, delta_time is set in the t-route yaml configuration file, and the
+        //number_of_timesteps is determined from the total number of nexus outputs in t-route.
+        int number_of_timesteps = manager->Simulation_Time_Object->get_total_output_times();
+        int delta_time = manager->Simulation_Time_Object->get_output_interval_seconds();
+        router->route(number_of_timesteps, delta_time);
+      }
+    }
+  #endif // NGEN_ROUTING_ACTIVE
 
   #ifdef NGEN_MPI_ACTIVE
-    //Syncronization here. MPI barrier. If rank == 0, do routing
-    MPI_Barrier(MPI_COMM_WORLD);
     MPI_Finalize();
-    if( mpi_rank == 0 )
-    { // Run t-route from single process
   #endif //NGEN_MPI_ACTIVE
-        if(manager->get_using_routing()) {
-          //Note: Currently, delta_time is set in the t-route yaml configuration file, and the
-          //number_of_timesteps is determined from the total number of nexus outputs in t-route.
-          //It is recommended to still pass these values to the routing_py_adapter object in
-          //case a future implmentation needs these two values from the ngen framework.
-          int number_of_timesteps = manager->Simulation_Time_Object->get_total_output_times();
-
-          int delta_time = manager->Simulation_Time_Object->get_output_interval_seconds();
-          
-          router->route(number_of_timesteps, delta_time); 
-        }
- #ifdef NGEN_MPI_ACTIVE
-    }
- #endif //NGEN_MPI_ACTIVE
- #else
- #ifdef NGEN_MPI_ACTIVE
-    MPI_Finalize();
- #endif //NGEN_MPI_ACTIVE
- #endif // NGEN_ROUTING_ACTIVE
     return 0;
 }
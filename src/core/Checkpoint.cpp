@@ -0,0 +1,132 @@
+#include "Checkpoint.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "State_Serialization.hpp"
+
+using namespace hy_features;
+
+namespace {
+
+    const char CHECKPOINT_MAGIC[8] = {'N', 'G', 'E', 'N', 'C', 'K', 'P', 'T'};
+    const uint32_t BYTE_ORDER_MARKER = 0x01020304;
+
+    uint64_t fnv1a(const char *data, size_t size)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= (unsigned char)data[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    void write_records(utils::State_Writer &out, const std::vector<Checkpoint::state_record> &records)
+    {
+        out.write<uint64_t>(records.size());
+        for (const auto &record : records) {
+            out.write_string(record.first);
+            out.write<uint64_t>(record.second.size());
+            out.write_bytes(record.second.data(), record.second.size());
+        }
+    }
+
+    void read_records(utils::State_Reader &in, std::vector<Checkpoint::state_record> &records)
+    {
+        uint64_t count = in.read<uint64_t>();
+        records.clear();
+        records.reserve(count);
+        for (uint64_t i = 0; i < count; ++i) {
+            std::string id = in.read_string();
+            std::vector<char> state(in.read<uint64_t>());
+            in.read_bytes(state.data(), state.size());
+            records.emplace_back(std::move(id), std::move(state));
+        }
+    }
+}
+
+const uint32_t Checkpoint::FORMAT_VERSION;
+
+std::string Checkpoint::get_file_path(const std::string &prefix, int rank)
+{
+    return prefix + "." + std::to_string(rank) + ".ckpt";
+}
+
+void Checkpoint::write(const std::string &path) const
+{
+    utils::State_Writer payload;
+    write_records(payload, catchment_states);
+    write_records(payload, nexus_states);
+
+    utils::State_Writer header;
+    header.write_bytes(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    header.write<uint32_t>(FORMAT_VERSION);
+    header.write<uint32_t>(BYTE_ORDER_MARKER);
+    header.write<int32_t>(rank);
+    header.write<int64_t>(output_time_index);
+    header.write<int64_t>(epoch_time);
+    header.write<uint64_t>(payload.size());
+    header.write<uint64_t>(fnv1a(payload.data().data(), payload.size()));
+
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Could not open checkpoint file " + temp_path + " for writing");
+        }
+        file.write(header.data().data(), header.size());
+        file.write(payload.data().data(), payload.size());
+        file.close();
+        if (!file) {
+            throw std::runtime_error("Could not write checkpoint file " + temp_path);
+        }
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Could not move checkpoint file " + temp_path + " to " + path);
+    }
+}
+
+Checkpoint Checkpoint::read(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Could not open checkpoint file " + path);
+    }
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    Checkpoint checkpoint;
+    utils::State_Reader in(bytes);
+    try {
+        char magic[sizeof(CHECKPOINT_MAGIC)];
+        in.read_bytes(magic, sizeof(magic));
+        if (std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0) {
+            throw std::runtime_error("not a checkpoint file");
+        }
+        uint32_t version = in.read<uint32_t>();
+        if (version != FORMAT_VERSION) {
+            throw std::runtime_error("unsupported format version " + std::to_string(version));
+        }
+        if (in.read<uint32_t>() != BYTE_ORDER_MARKER) {
+            throw std::runtime_error("written with a different byte order");
+        }
+        checkpoint.rank = in.read<int32_t>();
+        checkpoint.output_time_index = in.read<int64_t>();
+        checkpoint.epoch_time = in.read<int64_t>();
+        uint64_t payload_size = in.read<uint64_t>();
+        uint64_t checksum = in.read<uint64_t>();
+        if (payload_size != in.remaining()
+            || checksum != fnv1a(bytes.data() + (bytes.size() - in.remaining()), in.remaining())) {
+            throw std::runtime_error("contents are corrupt");
+        }
+        read_records(in, checkpoint.catchment_states);
+        read_records(in, checkpoint.nexus_states);
+    }
+    catch (const std::runtime_error &e) {
+        throw std::runtime_error("Could not read checkpoint file " + path + ": " + e.what());
+    }
+    return checkpoint;
+}
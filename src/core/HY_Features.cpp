@@ -28,10 +28,13 @@ HY_Features::HY_Features(network::Network network, std::shared_ptr<Formulation_M
         {
           //Find and prepare formulation
           auto formulation = formulations->get_formulation(feat_id);
-          formulation->set_output_stream(feat_id+".csv");
-          // TODO: add command line or config option to have this be omitted
-          //FIXME why isn't default param working here??? get_output_header_line() fails.
-          formulation->write_output("Time Step,""Time,"+formulation->get_output_header_line(",")+"\n");
+          //With NetCDF output, all catchments are written to a single file by the driver instead
+          if(!formulations->get_output_params().is_netcdf()) {
+            formulation->set_output_stream(feat_id+".csv");
+            // TODO: add command line or config option to have this be omitted
+            //FIXME why isn't default param working here??? get_output_header_line() fails.
+            formulation->write_output("Time Step,""Time,"+formulation->get_output_header_line(",")+"\n");
+          }
           //Find upstream nexus ids
           origins = network.get_origination_ids(feat_id);
           //Create the HY_Catchment with the formulation realization
@@ -0,0 +1,215 @@
+#ifdef NETCDF_ACTIVE
+#include "NetCDF_Output.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace hy_features;
+using namespace netCDF;
+
+namespace {
+
+    //Aim for chunks of about 1 MiB of doubles
+    const size_t TARGET_CHUNK_VALUES = 128 * 1024;
+
+    NcVar add_series_var(NcFile &file, const std::string &name, const NcDim &time_dim, const NcDim &feature_dim,
+                         size_t block_steps, int compression_level)
+    {
+        NcVar var = file.addVar(name, ncDouble, std::vector<NcDim>{time_dim, feature_dim});
+        size_t feature_chunk = std::max<size_t>(1, std::min(feature_dim.getSize(), TARGET_CHUNK_VALUES / block_steps));
+        std::vector<size_t> chunks{block_steps, feature_chunk};
+        var.setChunking(NcVar::nc_CHUNKED, chunks);
+        if (compression_level > 0) {
+            var.setCompression(true, true, compression_level);
+        }
+        var.setFill(true, std::numeric_limits<double>::quiet_NaN());
+        return var;
+    }
+
+    void put_ids(NcFile &file, const std::string &name, const NcDim &dim, const std::vector<std::string> &ids)
+    {
+        NcVar var = file.addVar(name, ncString, dim);
+        std::vector<const char*> id_ptrs(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            id_ptrs[i] = ids[i].c_str();
+        }
+        if (!ids.empty()) {
+            var.putVar(id_ptrs.data());
+        }
+    }
+}
+
+NetCDF_Output::NetCDF_Output(const std::string &path, const std::vector<std::string> &catchment_ids,
+                             const std::vector<std::vector<std::string>> &catchment_fields,
+                             const std::vector<std::string> &nexus_ids, int first_step, time_t first_epoch_time,
+                             int interval_seconds, int block_steps, int ahead_steps, int compression_level) :
+    catchment_count(catchment_ids.size()), nexus_count(nexus_ids.size()), first_step(first_step),
+    first_epoch_time(first_epoch_time), interval_seconds(interval_seconds), block_steps(block_steps),
+    buffer_steps(block_steps + std::max(ahead_steps, 0)), written_step(first_step)
+{
+    if (catchment_fields.size() != catchment_count) {
+        throw std::runtime_error("NetCDF output requires the output fields of every catchment");
+    }
+    if (block_steps < 1) {
+        throw std::runtime_error("NetCDF output block must be at least 1 time step");
+    }
+
+    try {
+        file.reset(new NcFile(path, NcFile::replace, NcFile::nc4));
+        NcDim time_dim = file->addDim("time");
+        //Zero-length dimensions would be unlimited, so always give features a dimension of at least 1
+        NcDim catchment_dim = file->addDim("catchment", std::max<size_t>(1, catchment_count));
+        NcDim nexus_dim = file->addDim("nexus", std::max<size_t>(1, nexus_count));
+
+        time_var = file->addVar("time", ncInt64, time_dim);
+        time_var.putAtt("units", "seconds since 1970-01-01 00:00:00");
+        time_var.putAtt("standard_name", "time");
+
+        put_ids(*file, "catchment_id", catchment_dim, catchment_ids);
+        put_ids(*file, "nexus_id", nexus_dim, nexus_ids);
+
+        std::unordered_map<std::string, size_t> var_index;
+        catchment_field_vars.resize(catchment_count);
+        for (size_t i = 0; i < catchment_count; ++i) {
+            for (const std::string &field : catchment_fields[i]) {
+                std::string name = get_variable_name(field);
+                auto it = var_index.find(name);
+                if (it == var_index.end()) {
+                    it = var_index.emplace(name, field_vars.size()).first;
+                    field_vars.push_back(add_series_var(*file, name, time_dim, catchment_dim, block_steps,
+                                                        compression_level));
+                    field_vars.back().putAtt("long_name", field);
+                }
+                catchment_field_vars[i].push_back(it->second);
+            }
+        }
+
+        nexus_var = add_series_var(*file, "nexus_flow", time_dim, nexus_dim, block_steps, compression_level);
+        nexus_var.putAtt("units", "m3 s-1");
+    }
+    catch (const exceptions::NcException &e) {
+        throw std::runtime_error("Could not create NetCDF output file " + path + ": " + e.what());
+    }
+
+    const double fill = std::numeric_limits<double>::quiet_NaN();
+    field_values.assign(field_vars.size(), std::vector<double>(buffer_steps * catchment_count, fill));
+    nexus_flows.assign(buffer_steps * nexus_count, fill);
+}
+
+size_t NetCDF_Output::slot(int step) const
+{
+    return (size_t)(step - first_step) % buffer_steps;
+}
+
+void NetCDF_Output::set_catchment_values(size_t catchment, int step, const std::vector<double> &values)
+{
+    const std::vector<size_t> &vars = catchment_field_vars[catchment];
+    const size_t offset = slot(step) * catchment_count + catchment;
+    const size_t count = std::min(vars.size(), values.size());
+    for (size_t k = 0; k < count; ++k) {
+        field_values[vars[k]][offset] = values[k];
+    }
+}
+
+void NetCDF_Output::set_nexus_flow(size_t nexus, int step, double flow)
+{
+    nexus_flows[slot(step) * nexus_count + nexus] = flow;
+}
+
+void NetCDF_Output::write(int begin, int end)
+{
+    if (end - begin > (int)buffer_steps) {
+        throw std::runtime_error("Cannot write more NetCDF output at once than is buffered");
+    }
+    if (begin >= end) {
+        return;
+    }
+    //The range may wrap around the end of the buffer, in which case it is written in two parts
+    const int wrap = begin + (int)(buffer_steps - slot(begin));
+    try {
+        if (end > wrap) {
+            write_slots(begin, wrap);
+            write_slots(wrap, end);
+        }
+        else {
+            write_slots(begin, end);
+        }
+    }
+    catch (const exceptions::NcException &e) {
+        throw std::runtime_error(std::string("Could not write NetCDF output: ") + e.what());
+    }
+}
+
+void NetCDF_Output::write_blocks(int end, bool partial)
+{
+    while (end - written_step >= block_steps) {
+        write(written_step, written_step + block_steps);
+        written_step += block_steps;
+    }
+    if (partial && end > written_step) {
+        write(written_step, end);
+        written_step = end;
+    }
+}
+
+void NetCDF_Output::write_slots(int begin, int end)
+{
+    const size_t steps = end - begin;
+    const size_t time_index = begin - first_step;
+
+    std::vector<int64_t> times(steps);
+    for (size_t s = 0; s < steps; ++s) {
+        times[s] = first_epoch_time + (int64_t)(time_index + s) * interval_seconds;
+    }
+    time_var.putVar(std::vector<size_t>{time_index}, std::vector<size_t>{steps}, times.data());
+
+    const size_t first_slot = slot(begin);
+    if (catchment_count > 0) {
+        for (size_t v = 0; v < field_vars.size(); ++v) {
+            field_vars[v].putVar(std::vector<size_t>{time_index, 0}, std::vector<size_t>{steps, catchment_count},
+                                 field_values[v].data() + first_slot * catchment_count);
+        }
+    }
+    if (nexus_count > 0) {
+        nexus_var.putVar(std::vector<size_t>{time_index, 0}, std::vector<size_t>{steps, nexus_count},
+                         nexus_flows.data() + first_slot * nexus_count);
+    }
+}
+
+void NetCDF_Output::close()
+{
+    if (file) {
+        try {
+            file->close();
+        }
+        catch (const exceptions::NcException &e) {
+            file.reset();
+            throw std::runtime_error(std::string("Could not close NetCDF output: ") + e.what());
+        }
+        file.reset();
+    }
+}
+
+std::string NetCDF_Output::get_variable_name(const std::string &field)
+{
+    std::string name = field;
+    for (char &c : name) {
+        if (!std::isalnum((unsigned char)c) && c != '_') {
+            c = '_';
+        }
+    }
+    if (name.empty() || std::isdigit((unsigned char)name[0])) {
+        name = "_" + name;
+    }
+    //Keep clear of the names of the file's own variables and dimensions
+    if (name == "time" || name == "catchment" || name == "catchment_id" || name == "nexus" || name == "nexus_id"
+        || name == "nexus_flow") {
+        name = "catchment_" + name;
+    }
+    return name;
+}
+#endif //NETCDF_ACTIVE
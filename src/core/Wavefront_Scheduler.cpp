@@ -0,0 +1,238 @@
+#include "Wavefront_Scheduler.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+using namespace hy_features;
+
+Wavefront_Scheduler::Wavefront_Scheduler(std::vector<std::vector<size_t>> upstream, const std::vector<int> &levels,
+                                         std::vector<bool> main_thread_only, size_t num_threads, size_t window) :
+    upstream(std::move(upstream)), main_thread_only(std::move(main_thread_only)), num_threads(num_threads),
+    window(window), run_step_func(nullptr), is_barrier_func(nullptr), total_steps(0), finalized_steps(0), stop(false)
+{
+    const size_t count = this->upstream.size();
+    if (levels.size() != count || this->main_thread_only.size() != count) {
+        throw std::runtime_error("Wavefront scheduler requires levels and thread restrictions for every catchment");
+    }
+    if (window < 1) {
+        throw std::runtime_error("Wavefront scheduler window must be at least 1 time step");
+    }
+    if (this->num_threads == 0) {
+        unsigned int n = std::thread::hardware_concurrency();
+        this->num_threads = n == 0 ? 1 : n;
+    }
+
+    downstream.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t u : this->upstream[i]) {
+            if (u >= count) {
+                throw std::runtime_error("Wavefront scheduler given an invalid upstream catchment index");
+            }
+            downstream[u].push_back(i);
+        }
+    }
+
+    //Hand out initial work upstream first
+    seed_order.resize(count);
+    std::iota(seed_order.begin(), seed_order.end(), 0);
+    std::stable_sort(seed_order.begin(), seed_order.end(),
+                     [&levels](size_t a, size_t b) { return levels[a] < levels[b]; });
+}
+
+void Wavefront_Scheduler::run(int total_steps, const std::function<void(size_t, int)> &run_step,
+                              const std::function<void(int)> &complete_step, int first_step,
+                              const std::function<bool(int)> &is_barrier)
+{
+    const size_t count = upstream.size();
+    std::unique_lock<std::mutex> lock(scheduler_mutex);
+    this->total_steps = total_steps;
+    run_step_func = &run_step;
+    is_barrier_func = is_barrier ? &is_barrier : nullptr;
+    finalized_steps = first_step;
+    next_step.assign(count, first_step);
+    in_flight.assign(count, false);
+    done_counts.assign(window, 0);
+    window_blocked.clear();
+    thread_queues.assign(num_threads, std::deque<Task>());
+    main_queue.clear();
+    stop = false;
+    first_error = nullptr;
+
+    size_t seeded = 0;
+    for (size_t c : seed_order) {
+        if (try_schedule(c, seeded % num_threads)) {
+            ++seeded;
+        }
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < num_threads; ++i) {
+        workers.emplace_back(&Wavefront_Scheduler::worker_loop, this, i);
+    }
+
+    while (!stop && finalized_steps < total_steps) {
+        if (done_counts[finalized_steps % window] == count) {
+            //Every catchment is done with the oldest open time step, so complete it while others keep working
+            int t = finalized_steps;
+            if (!thread_queues[0].empty()) {
+                state_changed.notify_all();
+            }
+            lock.unlock();
+            try {
+                complete_step(t);
+            }
+            catch (...) {
+                lock.lock();
+                record_error(std::current_exception());
+                break;
+            }
+            lock.lock();
+            done_counts[t % window] = 0;
+            ++finalized_steps;
+
+            std::vector<size_t> blocked;
+            blocked.swap(window_blocked);
+            bool queued = false;
+            for (size_t c : blocked) {
+                queued = try_schedule(c, 0) || queued;
+            }
+            if (queued) {
+                state_changed.notify_all();
+            }
+            continue;
+        }
+        Task task;
+        if (take_task(0, task)) {
+            execute(0, task, lock);
+        }
+        else {
+            state_changed.wait(lock);
+        }
+    }
+
+    stop = true;
+    std::exception_ptr error = first_error;
+    first_error = nullptr;
+    run_step_func = nullptr;
+    is_barrier_func = nullptr;
+    lock.unlock();
+    state_changed.notify_all();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void Wavefront_Scheduler::worker_loop(size_t thread)
+{
+    std::unique_lock<std::mutex> lock(scheduler_mutex);
+    while (!stop) {
+        Task task;
+        if (take_task(thread, task)) {
+            execute(thread, task, lock);
+        }
+        else {
+            state_changed.wait(lock);
+        }
+    }
+}
+
+void Wavefront_Scheduler::execute(size_t thread, const Task &task, std::unique_lock<std::mutex> &lock)
+{
+    const size_t c = task.first;
+    const int t = task.second;
+    lock.unlock();
+    try {
+        (*run_step_func)(c, t);
+    }
+    catch (...) {
+        lock.lock();
+        record_error(std::current_exception());
+        return;
+    }
+    lock.lock();
+
+    in_flight[c] = false;
+    next_step[c] = t + 1;
+    //Wake the calling thread when this completes a time step
+    bool notify = ++done_counts[t % window] == next_step.size();
+    size_t queued = 0;
+    if (try_schedule(c, thread)) {
+        ++queued;
+        notify = notify || main_thread_only[c];
+    }
+    for (size_t d : downstream[c]) {
+        if (try_schedule(d, thread)) {
+            ++queued;
+            notify = notify || main_thread_only[d];
+        }
+    }
+    //A single new task is simply picked up next by this thread; anything more is left for others to steal
+    if (notify || queued > 1) {
+        state_changed.notify_all();
+    }
+}
+
+bool Wavefront_Scheduler::try_schedule(size_t catchment, size_t thread)
+{
+    if (in_flight[catchment] || next_step[catchment] >= total_steps) {
+        return false;
+    }
+    const int t = next_step[catchment];
+    for (size_t u : upstream[catchment]) {
+        if (next_step[u] <= t) {
+            //Rechecked when the upstream catchment finishes
+            return false;
+        }
+    }
+    if (t >= finalized_steps + window || (t > finalized_steps && is_barrier_func && (*is_barrier_func)(t))) {
+        //Rechecked when the oldest open time step is completed
+        window_blocked.push_back(catchment);
+        return false;
+    }
+    in_flight[catchment] = true;
+    if (main_thread_only[catchment]) {
+        main_queue.emplace_back(catchment, t);
+    }
+    else {
+        thread_queues[thread].emplace_back(catchment, t);
+    }
+    return true;
+}
+
+bool Wavefront_Scheduler::take_task(size_t thread, Task &task)
+{
+    if (thread == 0 && !main_queue.empty()) {
+        task = main_queue.front();
+        main_queue.pop_front();
+        return true;
+    }
+    std::deque<Task> &own = thread_queues[thread];
+    if (!own.empty()) {
+        task = own.back();
+        own.pop_back();
+        return true;
+    }
+    for (size_t k = 1; k < num_threads; ++k) {
+        std::deque<Task> &victim = thread_queues[(thread + k) % num_threads];
+        if (!victim.empty()) {
+            task = victim.front();
+            victim.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void Wavefront_Scheduler::record_error(std::exception_ptr e)
+{
+    if (!first_error) {
+        first_error = e;
+    }
+    stop = true;
+    state_changed.notify_all();
+}
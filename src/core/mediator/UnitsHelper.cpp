@@ -88,3 +88,12 @@ double* UnitsHelper::convert_values(const std::string &in_units, double* in_valu
     return out_values;
 }
 
+std::shared_ptr<cv_converter> UnitsHelper::get_shared_converter(const std::string &in_units, const std::string &out_units)
+{
+    if(in_units == out_units){
+        return nullptr;
+    }
+    std::call_once(unit_system_inited, init_unit_system);
+
+    return get_converter(in_units, out_units);
+}
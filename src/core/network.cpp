@@ -1,6 +1,7 @@
 #include "network.hpp"
 #include <boost/graph/topological_sort.hpp>
 #include <stdexcept>
+#include <algorithm>
 #include <boost/graph/reverse_graph.hpp>
 #include <boost/graph/graph_utility.hpp>
 
@@ -177,6 +178,36 @@ std::vector<std::string> Network::get_destination_ids(std::string id){
   return ids;
 }
 
+std::vector<std::vector<std::string>> Network::get_topological_levels(std::string type){
+  std::vector<std::size_t> level(boost::num_vertices(this->graph), 0);
+  std::size_t max_level = 0;
+  //topo_order is stored downstream first, so walk it in reverse so every upstream level is known before it is needed
+  for(auto it = this->topo_order.rbegin(); it != this->topo_order.rend(); ++it)
+  {
+    Graph::in_edge_iterator begin, end;
+    boost::tie(begin, end) = boost::in_edges(*it, this->graph);
+    for(auto e = begin; e != end; ++e)
+    {
+      level[*it] = std::max(level[*it], level[boost::source(*e, this->graph)] + 1);
+    }
+    max_level = std::max(max_level, level[*it]);
+  }
+
+  std::vector<std::vector<std::string>> levels(max_level + 1);
+  for(auto it = this->topo_order.rbegin(); it != this->topo_order.rend(); ++it)
+  {
+    std::string id = get_id(*it);
+    std::string prefix = id.substr(0,3);
+    if(prefix == type || (type == "nex" && prefix == "tnx")){
+      levels[level[*it]].push_back(id);
+    }
+  }
+  levels.erase(std::remove_if(levels.begin(), levels.end(),
+                              [](const std::vector<std::string>& l){ return l.empty(); }),
+               levels.end());
+  return levels;
+}
+
 const NetworkIndexT& Network::get_sorted_index(SortOrder order, bool cache){
   if (order == SortOrder::TransposedDepthFirstPreorder) {
     if (!this->tdfp_order.empty()){
@@ -260,3 +260,87 @@ void HY_PointHydroNexus::set_mintime(time_step_t t)
     l2(min_timestep,total_requests);
 
 }
+
+void HY_PointHydroNexus::save_state(utils::State_Writer &out)
+{
+    auto write_flows = [&out](const std::unordered_map<time_step_t, flow_vector>& m)
+    {
+        out.write<uint64_t>(m.size());
+        for( auto& t: m )
+        {
+            out.write<int64_t>(t.first);
+            out.write<uint64_t>(t.second.size());
+            for( auto& f: t.second )
+            {
+                out.write_string(f.first);
+                out.write<double>(f.second);
+            }
+        }
+    };
+
+    auto write_values = [&out](const std::unordered_map<time_step_t, double>& m)
+    {
+        out.write<uint64_t>(m.size());
+        for( auto& t: m )
+        {
+            out.write<int64_t>(t.first);
+            out.write<double>(t.second);
+        }
+    };
+
+    out.write<int64_t>(min_timestep);
+    out.write<uint64_t>(completed.size());
+    for( auto& t: completed )
+    {
+        out.write<int64_t>(t);
+    }
+    write_flows(upstream_flows);
+    write_flows(downstream_requests);
+    write_values(summed_flows);
+    write_values(total_requests);
+}
+
+void HY_PointHydroNexus::load_state(utils::State_Reader &in, time_step_t step_offset)
+{
+    auto read_flows = [&in, step_offset](std::unordered_map<time_step_t, flow_vector>& m)
+    {
+        m.clear();
+        uint64_t count = in.read<uint64_t>();
+        for( uint64_t i = 0; i < count; ++i )
+        {
+            time_step_t t = in.read<int64_t>() + step_offset;
+            uint64_t n = in.read<uint64_t>();
+            flow_vector v;
+            v.reserve(n);
+            for( uint64_t j = 0; j < n; ++j )
+            {
+                std::string id = in.read_string();
+                v.push_back(flows(id, in.read<double>()));
+            }
+            m[t] = v;
+        }
+    };
+
+    auto read_values = [&in, step_offset](std::unordered_map<time_step_t, double>& m)
+    {
+        m.clear();
+        uint64_t count = in.read<uint64_t>();
+        for( uint64_t i = 0; i < count; ++i )
+        {
+            time_step_t t = in.read<int64_t>() + step_offset;
+            m[t] = in.read<double>();
+        }
+    };
+
+    min_timestep = in.read<int64_t>() + step_offset;
+    completed.clear();
+    uint64_t count = in.read<uint64_t>();
+    for( uint64_t i = 0; i < count; ++i )
+    {
+        completed.emplace(in.read<int64_t>() + step_offset);
+    }
+    read_flows(upstream_flows);
+    read_flows(downstream_requests);
+    read_values(summed_flows);
+    read_values(total_requests);
+}
@@ -3,5 +3,8 @@
 
 std::mutex data_access::NetCDFPerFeatureDataProvider::shared_providers_mutex;
 std::map<std::string, std::shared_ptr<data_access::NetCDFPerFeatureDataProvider>> data_access::NetCDFPerFeatureDataProvider::shared_providers;
+std::mutex data_access::NetCDFPerFeatureDataProvider::netcdf_access_mutex;
+const size_t data_access::NetCDFPerFeatureDataProvider::DEFAULT_CHUNK_TIME_STEPS;
+const size_t data_access::NetCDFPerFeatureDataProvider::DEFAULT_CACHE_BYTES;
 
 #endif
@@ -0,0 +1,112 @@
+// Forcings without well known units are read in their native units, which makes every read warn, so keep quiet
+#define UDUNITS_QUIET
+
+#include <FileChecker.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AorcForcing.hpp"
+#include "BinaryForcingStore.hpp"
+#include "CsvPerFeatureForcingProvider.hpp"
+#ifdef NETCDF_ACTIVE
+    #include "NetCDFPerFeatureDataProvider.hpp"
+#endif
+
+/**
+ * @brief Get the catchment id of a per-catchment CSV forcing file, from the start of its name.
+ *
+ * For instance, ``data/forcing/cat-27_2015-12-01 00_00_00_2015-12-30 23_00_00.csv`` is for ``cat-27``.
+ *
+ * @param path The path of the forcing file.
+ * @return The catchment id.
+ */
+std::string csv_catchment_id(const std::string &path)
+{
+    std::string name = path.substr(path.find_last_of('/') + 1);
+    return name.substr(0, name.find_first_of("_."));
+}
+
+bool is_netcdf(const std::string &path)
+{
+    return path.size() > 3 && path.compare(path.size() - 3, 3, ".nc") == 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 5) {
+        std::cout << "Missing required args:" << std::endl;
+        std::cout << argv[0] << " <store_output_path> <start_time> <end_time> <forcing_file> [<forcing_file> ...]" << std::endl;
+        std::cout << "Times are in the form 'yyyy-mm-dd hh:mm:ss', as in the realization config, and the store covers the"
+                  << " time steps from the start time through the end time." << std::endl;
+        std::cout << "Forcing files are either per-catchment CSV files named with the catchment id followed by '_' or '.',"
+                  << " or a single NetCDF file (ending in '.nc') of all catchments." << std::endl;
+        return 1;
+    }
+    std::string store_path = argv[1];
+    std::string start_time = argv[2];
+    std::string end_time = argv[3];
+    std::vector<std::string> forcing_paths(argv + 4, argv + argc);
+
+    for (const std::string &path : forcing_paths) {
+        if (!utils::FileChecker::file_is_readable(path)) {
+            std::cout << "forcing file " << path << " not readable" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        std::vector<std::string> catchment_ids;
+        std::shared_ptr<data_access::GenericDataProvider> first_provider;
+        if (is_netcdf(forcing_paths[0])) {
+#ifdef NETCDF_ACTIVE
+            if (forcing_paths.size() > 1) {
+                std::cout << "only one NetCDF forcing file can be converted at a time" << std::endl;
+                return 1;
+            }
+            auto netcdf_provider = data_access::NetCDFPerFeatureDataProvider::get_shared_provider(forcing_paths[0], utils::StreamHandler());
+            catchment_ids = netcdf_provider->get_ids();
+            first_provider = netcdf_provider;
+#else
+            std::cout << "NetCDF forcing requires NetCDF support to be enabled" << std::endl;
+            return 1;
+#endif
+        }
+        else {
+            for (const std::string &path : forcing_paths) {
+                catchment_ids.push_back(csv_catchment_id(path));
+            }
+            first_provider = std::make_shared<CsvPerFeatureForcingProvider>(
+                    forcing_params(forcing_paths[0], "CsvPerFeature", start_time, end_time));
+        }
+
+        forcing_params period(store_path, "BinaryStore", start_time, end_time);
+        const time_t time_stride = first_provider->record_duration();
+        const size_t time_count = (period.end_t - period.start_t) / time_stride + 1;
+        data_access::BinaryForcingStoreWriter writer(store_path, catchment_ids,
+                                                     data_access::BinaryForcingStoreWriter::get_provider_variables(*first_provider),
+                                                     period.start_t, time_stride, time_count);
+
+        if (forcing_paths.size() == 1) {
+            for (const std::string &id : catchment_ids) {
+                writer.write_catchment(id, *first_provider);
+            }
+        }
+        else {
+            writer.write_catchment(catchment_ids[0], *first_provider);
+            first_provider.reset();
+            for (size_t i = 1; i < forcing_paths.size(); ++i) {
+                CsvPerFeatureForcingProvider provider(forcing_params(forcing_paths[i], "CsvPerFeature", start_time, end_time));
+                writer.write_catchment(catchment_ids[i], provider);
+            }
+        }
+        std::cout << "Wrote " << catchment_ids.size() << " catchments of " << time_count << " time steps to "
+                  << store_path << std::endl;
+    }
+    catch (const std::exception &e) {
+        std::cout << "Error converting forcings: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
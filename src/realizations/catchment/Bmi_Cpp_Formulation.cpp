@@ -56,12 +56,17 @@ std::string Bmi_Cpp_Formulation::get_output_line_for_timestep(int timestep, std:
     if (timestep != (next_time_step_index - 1)) {
         throw std::invalid_argument("Only current time step valid when getting output for BMI C++ formulation");
     }
-    std::string output_str;
+    output_line.clear();
+    append_output_values(output_line, CPP_OUTPUT_PRECISION);
+    return output_line.str();
+}
 
-    for (const std::string& name : get_output_variable_names()) {
-        output_str += (output_str.empty() ? "" : ",") + std::to_string(get_var_value_as_double(name));
+void Bmi_Cpp_Formulation::append_output_line_for_timestep(int timestep, utils::Output_Line_Buffer &line,
+                                                          const std::string &delimiter) {
+    if (timestep != (next_time_step_index - 1)) {
+        throw std::invalid_argument("Only current time step valid when getting output for BMI C++ formulation");
     }
-    return output_str;
+    append_output_values(line, CPP_OUTPUT_PRECISION);
 }
 
 /**
@@ -144,42 +149,15 @@ double Bmi_Cpp_Formulation::get_var_value_as_double(const std::string& var_name)
 double Bmi_Cpp_Formulation::get_var_value_as_double(const int& index, const std::string& var_name) {
     // TODO: consider different way of handling (and how to document) cases like long double or unsigned long long that
     //  don't fit or might convert inappropriately
-    std::string type = get_bmi_model()->GetVarType(var_name);
-    if (type == "long double")
-        return (double) (get_bmi_model()->GetValuePtr<long double>(var_name))[index];
-
-    if (type == "double")
-        return (double) (get_bmi_model()->GetValuePtr<double>(var_name))[index];
-
-    if (type == "float")
-        return (double) (get_bmi_model()->GetValuePtr<float>(var_name))[index];
-
-    if (type == "short" || type == "short int" || type == "signed short" || type == "signed short int")
-        return (double) (get_bmi_model()->GetValuePtr<short>(var_name))[index];
-
-    if (type == "unsigned short" || type == "unsigned short int")
-        return (double) (get_bmi_model()->GetValuePtr<unsigned short>(var_name))[index];
-
-    if (type == "int" || type == "signed" || type == "signed int")
-        return (double) (get_bmi_model()->GetValuePtr<int>(var_name))[index];
-
-    if (type == "unsigned" || type == "unsigned int")
-        return (double) (get_bmi_model()->GetValuePtr<unsigned int>(var_name))[index];
-
-    if (type == "long" || type == "long int" || type == "signed long" || type == "signed long int")
-        return (double) (get_bmi_model()->GetValuePtr<long>(var_name))[index];
-
-    if (type == "unsigned long" || type == "unsigned long int")
-        return (double) (get_bmi_model()->GetValuePtr<unsigned long>(var_name))[index];
-
-    if (type == "long long" || type == "long long int" || type == "signed long long" || type == "signed long long int")
-        return (double) (get_bmi_model()->GetValuePtr<long long>(var_name))[index];
-
-    if (type == "unsigned long long" || type == "unsigned long long int")
-        return (double) (get_bmi_model()->GetValuePtr<unsigned long long>(var_name))[index];
-
-    throw std::runtime_error("Unable to get value of variable " + var_name + " from " + get_model_type_name() +
-                             " as double: no logic for converting variable type " + type);
+    models::bmi::BmiType type = get_var_bmi_type(var_name);
+    if (type == models::bmi::BmiType::UNKNOWN) {
+        throw std::runtime_error("Unable to get value of variable " + var_name + " from " + get_model_type_name() +
+                                 " as double: no logic for converting variable type " +
+                                 get_bmi_model()->GetVarType(var_name));
+    }
+    return models::bmi::dispatch_bmi_type(type, [this, &index, &var_name](auto tag) -> double {
+        return (double) (get_bmi_model()->GetValuePtr<typename decltype(tag)::type>(var_name))[index];
+    });
 }
 
 bool Bmi_Cpp_Formulation::is_bmi_input_variable(const std::string &var_name) {
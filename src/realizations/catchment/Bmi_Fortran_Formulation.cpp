@@ -52,42 +52,15 @@ double Bmi_Fortran_Formulation::get_var_value_as_double(const string &var_name)
 double Bmi_Fortran_Formulation::get_var_value_as_double(const int &index, const string &var_name) {
     // TODO: consider different way of handling (and how to document) cases like long double or unsigned long long that
     //  don't fit or might convert inappropriately
-    std::string type = get_bmi_model()->GetVarType(var_name);
-    if (type == "long double")
-        return (double) (get_bmi_model()->GetValue<long double>(var_name))[index];
-
-    if (type == "double" || type == "double precision")
-        return (double) (get_bmi_model()->GetValue<double>(var_name))[index];
-
-    if (type == "float" || type == "real")
-        return (double) (get_bmi_model()->GetValue<float>(var_name))[index];
-
-    if (type == "short" || type == "short int" || type == "signed short" || type == "signed short int")
-        return (double) (get_bmi_model()->GetValue<short>(var_name))[index];
-
-    if (type == "unsigned short" || type == "unsigned short int")
-        return (double) (get_bmi_model()->GetValue<unsigned short>(var_name))[index];
-
-    if (type == "int" || type == "signed" || type == "signed int" || type == "integer")
-        return (double) (get_bmi_model()->GetValue<int>(var_name))[index];
-
-    if (type == "unsigned" || type == "unsigned int")
-        return (double) (get_bmi_model()->GetValue<unsigned int>(var_name))[index];
-
-    if (type == "long" || type == "long int" || type == "signed long" || type == "signed long int")
-        return (double) (get_bmi_model()->GetValue<long>(var_name))[index];
-
-    if (type == "unsigned long" || type == "unsigned long int")
-        return (double) (get_bmi_model()->GetValue<unsigned long>(var_name))[index];
-
-    if (type == "long long" || type == "long long int" || type == "signed long long" || type == "signed long long int")
-        return (double) (get_bmi_model()->GetValue<long long>(var_name))[index];
-
-    if (type == "unsigned long long" || type == "unsigned long long int")
-        return (double) (get_bmi_model()->GetValue<unsigned long long>(var_name))[index];
-
-    throw std::runtime_error("Unable to get value of variable " + var_name + " from " + get_model_type_name() +
-    " as double: no logic for converting variable type " + type);
+    models::bmi::BmiType type = get_var_bmi_type(var_name);
+    if (type == models::bmi::BmiType::UNKNOWN) {
+        throw std::runtime_error("Unable to get value of variable " + var_name + " from " + get_model_type_name() +
+                                 " as double: no logic for converting variable type " +
+                                 get_bmi_model()->GetVarType(var_name));
+    }
+    return models::bmi::dispatch_bmi_type(type, [this, &index, &var_name](auto tag) -> double {
+        return (double) (get_bmi_model()->GetValue<typename decltype(tag)::type>(var_name))[index];
+    });
 }
 
 string Bmi_Fortran_Formulation::get_output_line_for_timestep(int timestep, std::string delimiter) {
@@ -98,20 +71,9 @@ string Bmi_Fortran_Formulation::get_output_line_for_timestep(int timestep, std::
 
     // TODO: see Github issue 355: this design (and formulation output handling in general) needs to be reworked
     // Clear anything currently in there
-    output_text_stream->str(std::string());
-
-    const std::vector<std::string> &output_var_names = get_output_variable_names();
-    // This probably should never happen, but just to be safe ...
-    if (output_var_names.empty()) { return ""; }
-
-    // Do the first separately, without the leading comma
-    *output_text_stream << get_var_value_as_double(output_var_names[0]);
-
-    // Do the rest with a leading comma
-    for (int i = 1; i < output_var_names.size(); ++i) {
-        *output_text_stream << "," << get_var_value_as_double(output_var_names[i]);
-    }
-    return output_text_stream->str();
+    output_line.clear();
+    append_output_values(output_line, get_output_precision());
+    return output_line.str();
 }
 
 /**
@@ -296,29 +296,18 @@ string Bmi_Multi_Formulation::get_output_line_for_timestep(int timestep, std::st
     if (!is_out_vars_from_last_mod) {
 
         // TODO: see Github issue 355: this design (and formulation output handling in general) needs to be reworked
-        // Clear anything currently in the multi formulation's stream buffer
-        output_text_stream->str(std::string());
-
-        const std::vector<std::string> &output_var_names = get_output_variable_names();
-        // This almost certainly should never happen, but just to be safe ...
-        if (output_var_names.empty()) { return ""; }
+        // Clear anything currently in the multi formulation's line buffer
+        output_line.clear();
 
         try {
-            // Do the first separately, without the leading comma
-            auto output_data_provider_iter = availableData.find(output_var_names[0]);
-            *output_text_stream << get_var_value_as_double(output_var_names[0]);
-
-            // Do the rest with a leading comma
-            for (int i = 1; i < output_var_names.size(); ++i) {
-                *output_text_stream << "," << get_var_value_as_double(output_var_names[i]);
-            }
-            return output_text_stream->str();
+            append_output_values(output_line);
+            return output_line.str();
         }
         catch (const std::exception &e) {
             std::cerr << "WARN: " << e.what()
                       << "; reverting to default behavior for multi-BMI formulation type (using last module)";
-            output_text_stream->str(std::string()); // ... clear any output contents being staged ...
-            is_out_vars_from_last_mod = true;          // ... revert to default behavior (just use last nested module)
+            output_line.clear();                // ... clear any output contents being staged ...
+            is_out_vars_from_last_mod = true;   // ... revert to default behavior (just use last nested module)
         }
     }
     // Otherwise, use the default behavior, which means we either
@@ -327,6 +316,39 @@ string Bmi_Multi_Formulation::get_output_line_for_timestep(int timestep, std::st
     return modules.back()->get_output_line_for_timestep(timestep, delimiter);
 }
 
+void Bmi_Multi_Formulation::append_output_line_for_timestep(int timestep, utils::Output_Line_Buffer &line,
+                                                            const std::string &delimiter) {
+    if (timestep != (next_time_step_index - 1)) {
+        throw std::invalid_argument("Only current time step valid when getting multi-module BMI formulation output");
+    }
+
+    if (!is_out_vars_from_last_mod) {
+        // Remember where this formulation's values start, so a partial line can be backed out on error
+        size_t line_start = line.size();
+        try {
+            append_output_values(line);
+            return;
+        }
+        catch (const std::exception &e) {
+            std::cerr << "WARN: " << e.what()
+                      << "; reverting to default behavior for multi-BMI formulation type (using last module)";
+            line.truncate(line_start);
+            is_out_vars_from_last_mod = true;
+        }
+    }
+    modules.back()->append_output_line_for_timestep(timestep, line, delimiter);
+}
+
+void Bmi_Multi_Formulation::append_output_values(utils::Output_Line_Buffer &line) {
+    const std::vector<std::string> &output_var_names = get_output_variable_names();
+    for (size_t i = 0; i < output_var_names.size(); ++i) {
+        if (i > 0) {
+            line.append(',');
+        }
+        line.append_fixed(get_var_value_as_double(output_var_names[i]), get_output_precision());
+    }
+}
+
 double Bmi_Multi_Formulation::get_response(time_step_t t_index, time_step_t t_delta) {
     if (modules.empty()) {
         throw std::runtime_error("Trying to get response of improperly created empty BMI multi-module formulation.");
@@ -436,6 +458,40 @@ bool Bmi_Multi_Formulation::is_model_initialized() {
                        [](const std::shared_ptr<Bmi_Formulation>& m) { return m->is_model_initialized(); });
 }
 
+bool Bmi_Multi_Formulation::is_thread_safe() const {
+    return std::all_of(modules.cbegin(), modules.cend(),
+                       [](const std::shared_ptr<Bmi_Formulation>& m) { return m->is_thread_safe(); });
+}
+
+bool Bmi_Multi_Formulation::uses_python() const {
+    return std::any_of(modules.cbegin(), modules.cend(),
+                       [](const std::shared_ptr<Bmi_Formulation>& m) { return m->uses_python(); });
+}
+
+bool Bmi_Multi_Formulation::is_checkpointable() const {
+    return std::all_of(modules.cbegin(), modules.cend(),
+                       [](const std::shared_ptr<Bmi_Formulation>& m) { return m->is_checkpointable(); });
+}
+
+void Bmi_Multi_Formulation::save_state(utils::State_Writer &out) {
+    out.write<int64_t>(next_time_step_index);
+    out.write<uint64_t>(modules.size());
+    for (nested_module_ptr &module : modules) {
+        module->save_state(out);
+    }
+}
+
+void Bmi_Multi_Formulation::load_state(utils::State_Reader &in, time_step_t step_offset) {
+    next_time_step_index = in.read<int64_t>() + step_offset;
+    if (in.read<uint64_t>() != modules.size()) {
+        throw std::runtime_error("Cannot restore BMI multi-module formulation " + get_id()
+                                 + ": saved state has a different number of modules");
+    }
+    for (nested_module_ptr &module : modules) {
+        module->load_state(in, step_offset);
+    }
+}
+
 /**
  * Get whether this time step goes beyond this formulation's (i.e., any of it's modules') end time.
  *
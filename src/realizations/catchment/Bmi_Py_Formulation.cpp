@@ -57,20 +57,9 @@ string Bmi_Py_Formulation::get_output_line_for_timestep(int timestep, std::strin
 
     // TODO: see Github issue 355: this design (and formulation output handling in general) needs to be reworked
     // Clear anything currently in there
-    output_text_stream->str(std::string());
-
-    const std::vector<std::string> &output_var_names = get_output_variable_names();
-    // This probably should never happen, but just to be safe ...
-    if (output_var_names.empty()) { return ""; }
-
-    // Do the first separately, without the leading comma
-    *output_text_stream << get_var_value_as_double(output_var_names[0]);
-
-    // Do the rest with a leading comma
-    for (int i = 1; i < output_var_names.size(); ++i) {
-        *output_text_stream << "," << get_var_value_as_double(output_var_names[i]);
-    }
-    return output_text_stream->str();
+    output_line.clear();
+    append_output_values(output_line, get_output_precision());
+    return output_line.str();
 }
 
 double Bmi_Py_Formulation::get_response(time_step_t t_index, time_step_t t_delta) {
@@ -118,54 +107,52 @@ double Bmi_Py_Formulation::get_var_value_as_double(const string &var_name) {
 }
 
 double Bmi_Py_Formulation::get_var_value_as_double(const int &index, const string &var_name) {
-    string val_type = get_bmi_model()->GetVarType(var_name);
-    size_t val_item_size = (size_t)get_bmi_model()->GetVarItemsize(var_name);
+    models::bmi::BmiType type = get_var_bmi_type(var_name);
+    if (type == models::bmi::BmiType::UNKNOWN) {
+        throw std::runtime_error("Unable to get value of variable " + var_name + " from " + get_model_type_name() +
+        " as double: no logic for converting variable type " + get_bmi_model()->GetVarType(var_name));
+    }
 
-    //void *dest;
     int indices[1];
     indices[0] = index;
 
-    // The available types and how they are handled here should match what is in SetValueAtIndices
-    if (val_type == "int" && val_item_size == sizeof(short)) {
-        short dest;
-        get_bmi_model()->get_value_at_indices(var_name, &dest, indices, 1, false);
-        return (double)dest;
-    }
-    if (val_type == "int" && val_item_size == sizeof(int)) {
-        int dest;
+    return models::bmi::dispatch_bmi_type(type, [this, &indices, &var_name](auto tag) -> double {
+        typename decltype(tag)::type dest;
         get_bmi_model()->get_value_at_indices(var_name, &dest, indices, 1, false);
-        return (double)dest;
+        return (double) dest;
+    });
+}
+
+models::bmi::BmiType Bmi_Py_Formulation::resolve_var_bmi_type(const string &var_name) {
+    string val_type = get_bmi_model()->GetVarType(var_name);
+    size_t val_item_size = (size_t)get_bmi_model()->GetVarItemsize(var_name);
+
+    // The available types and how they are handled here should match what is in SetValueAtIndices
+    if (val_type == "int") {
+        if (val_item_size == sizeof(short))
+            return models::bmi::BmiType::SHORT;
+        if (val_item_size == sizeof(int))
+            return models::bmi::BmiType::INT;
+        if (val_item_size == sizeof(long))
+            return models::bmi::BmiType::LONG;
+        if (val_item_size == sizeof(long long))
+            return models::bmi::BmiType::LONG_LONG;
     }
-    if (val_type == "int" && val_item_size == sizeof(long)) {
-        long dest;
-        get_bmi_model()->get_value_at_indices(var_name, &dest, indices, 1, false);
-        return (double)dest;
+    if (val_type == "float" || val_type == "float16" || val_type == "float32" || val_type == "float64") {
+        if (val_item_size == sizeof(float))
+            return models::bmi::BmiType::FLOAT;
+        if (val_item_size == sizeof(double))
+            return models::bmi::BmiType::DOUBLE;
+        if (val_item_size == sizeof(long double))
+            return models::bmi::BmiType::LONG_DOUBLE;
     }
-    if (val_type == "int" && val_item_size == sizeof(long long)) {
-        long long dest;
-        get_bmi_model()->get_value_at_indices(var_name, &dest, indices, 1, false);
-        return (double)dest;
+    // Fall back to the adapter's mapping, which knows some further numpy type names
+    try {
+        return models::bmi::get_bmi_type(get_bmi_model()->get_analogous_cxx_type(val_type, val_item_size));
     }
-    if (val_type == "float" || val_type == "float16" || val_type == "float32" || val_type == "float64") {
-        if (val_item_size == sizeof(float)) {
-            float dest;
-            get_bmi_model()->get_value_at_indices(var_name, &dest, indices, 1, false);
-            return (double) dest;
-        }
-        if (val_item_size == sizeof(double)) {
-            double dest;
-            get_bmi_model()->get_value_at_indices(var_name, &dest, indices, 1, false);
-            return dest;
-        }
-        if (val_item_size == sizeof(long double)) {
-            long double dest;
-            get_bmi_model()->get_value_at_indices(var_name, &dest, indices, 1, false);
-            return (double) dest;
-        }
+    catch (const std::runtime_error &) {
+        return models::bmi::BmiType::UNKNOWN;
     }
-
-    throw std::runtime_error("Unable to get value of variable " + var_name + " from " + get_model_type_name() +
-    " as double: no logic for converting variable type " + val_type);
 }
 
 bool Bmi_Py_Formulation::is_bmi_input_variable(const string &var_name) {
@@ -182,4 +169,12 @@ bool Bmi_Py_Formulation::is_model_initialized() {
     return get_bmi_model()->is_model_initialized();
 }
 
+bool Bmi_Py_Formulation::is_thread_safe() const {
+    return false;
+}
+
+bool Bmi_Py_Formulation::uses_python() const {
+    return true;
+}
+
 #endif //ACTIVATE_PYTHON
@@ -1,6 +1,8 @@
 #ifdef ACTIVATE_PYTHON
 
 #include <exception>
+#include <stdexcept>
+#include <string>
 #include <utility>
 
 #include "Routing_Py_Adapter.hpp"
@@ -14,10 +16,65 @@ Routing_Py_Adapter::Routing_Py_Adapter(std::string t_route_config_file_with_path
   this->t_route_module = utils::ngenPy::InterpreterUtil::getPyModule("ngen_routing.ngen_main");
   }
 
-void Routing_Py_Adapter::route(int number_of_timesteps, int delta_time,
-                          const std::vector<double> &flow_vector){
-  throw "Routing_Py_Adapter::route overload with flow_vector unimplemented.";
-};
+void Routing_Py_Adapter::route(const Nexus_Flow_Buffer &flows, bool last_window)
+{
+  std::vector<std::string> arg_vector;
+
+  arg_vector.push_back("-f");
+
+  arg_vector.push_back(this->t_route_config_path);
+
+  //Cast vector of args to Python list 
+  py::list arg_list = py::cast(arg_vector);
+
+  py::list nexus_ids = py::cast(flows.get_nexus_ids());
+
+  //View the flow buffer as a (nexus, time) array without copying it; the capsule base keeps pybind11 from taking
+  //a copy, and owns nothing, since the buffer outlives the call
+  const py::ssize_t rows = flows.nexus_count();
+  const py::ssize_t cols = flows.get_step_count();
+  double *flow_data = const_cast<double*>(flows.data());
+  py::array_t<double> nexus_flows({rows, cols}, {cols * (py::ssize_t)sizeof(double), (py::ssize_t)sizeof(double)},
+                                  flow_data, py::capsule(flow_data, [](void*) {}));
+
+  //Create object for the ngen_main subroutine
+  py::object ngen_main = t_route_module.attr("ngen_main");
+
+  //Call ngen_main subroutine
+  ngen_main(arg_list, py::arg("nexus_ids") = nexus_ids, py::arg("nexus_flows") = nexus_flows,
+            py::arg("first_timestep") = flows.get_first_step(), py::arg("last_window") = last_window);
+
+  if(last_window) {
+    std::cout << "Finished routing" << std::endl;
+  }
+}
+
+bool Routing_Py_Adapter::accepts_in_memory_flows()
+{
+  py::object ngen_main = t_route_module.attr("ngen_main");
+  py::module_ inspect = utils::ngenPy::InterpreterUtil::getPyModule("inspect");
+  py::object parameters;
+  try {
+    parameters = inspect.attr("signature")(ngen_main).attr("parameters");
+  }
+  catch(const py::error_already_set &) {
+    //Without a signature to check (e.g., some builtins), assume only the file-based arguments are accepted
+    return false;
+  }
+  //A **kwargs parameter takes any keyword argument
+  py::object var_keyword = inspect.attr("Parameter").attr("VAR_KEYWORD");
+  for(auto item : parameters.attr("values")()) {
+    if(item.attr("kind").equal(var_keyword)) {
+      return true;
+    }
+  }
+  for(const char *name : {"nexus_ids", "nexus_flows", "first_timestep", "last_window"}) {
+    if(!parameters.contains(name)) {
+      return false;
+    }
+  }
+  return true;
+}
 
 void Routing_Py_Adapter::route(int number_of_timesteps, int delta_time)
 {
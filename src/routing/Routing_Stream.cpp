@@ -0,0 +1,113 @@
+#ifdef ACTIVATE_PYTHON
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "Routing_Stream.hpp"
+
+using namespace routing_py_adapter;
+
+Routing_Stream::Routing_Stream(Routing_Py_Adapter &router, bool concurrent) :
+  router(router), concurrent(concurrent), stopping(false)
+{
+  if(concurrent) {
+    worker = std::thread(&Routing_Stream::run, this);
+  }
+}
+
+Routing_Stream::~Routing_Stream()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    //Anything not yet started is abandoned
+    while(pending.size() > 1) {
+      pending.pop_back();
+    }
+  }
+  stop();
+}
+
+void Routing_Stream::submit(const Nexus_Flow_Buffer &flows, bool last_window)
+{
+  if(!concurrent) {
+    router.route(flows, last_window);
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  changed.wait(lock, [this]() { return pending.size() < 2 || error; });
+  if(error) {
+    std::rethrow_exception(error);
+  }
+  pending.push_back(Window{flows, last_window});
+  changed.notify_all();
+  lock.unlock();
+  //The background thread needs the interpreter lock to route, so give it up once there is something to route
+  if(!gil_release) {
+    gil_release.reset(new py::gil_scoped_release());
+  }
+}
+
+void Routing_Stream::finish()
+{
+  stop();
+  if(error) {
+    std::exception_ptr e = error;
+    error = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+void Routing_Stream::stop()
+{
+  if(worker.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    changed.notify_all();
+    worker.join();
+  }
+  //Take back the interpreter lock for the constructing thread
+  gil_release.reset();
+}
+
+void Routing_Stream::run()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  while(true) {
+    changed.wait(lock, [this]() { return !pending.empty() || stopping; });
+    if(pending.empty() || error) {
+      //Once a window fails, later ones are not routed, since routing state would be inconsistent
+      if(stopping) {
+        return;
+      }
+      pending.clear();
+      continue;
+    }
+    Window &window = pending.front();
+    lock.unlock();
+    std::exception_ptr window_error;
+    {
+      py::gil_scoped_acquire gil;
+      try {
+        router.route(window.flows, window.last_window);
+      }
+      catch(const py::error_already_set &e) {
+        //Python errors need the interpreter lock to be destroyed, so keep only the message
+        window_error = std::make_exception_ptr(std::runtime_error(std::string("Routing failed: ") + e.what()));
+      }
+      catch(...) {
+        window_error = std::current_exception();
+      }
+    }
+    lock.lock();
+    pending.pop_front();
+    if(window_error && !error) {
+      error = window_error;
+    }
+    changed.notify_all();
+  }
+}
+
+#endif //ACTIVATE_PYTHON
@@ -0,0 +1,106 @@
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Checkpoint.hpp"
+#include "Checkpoint_Params.hpp"
+#include "HY_PointHydroNexus.hpp"
+#include "State_Serialization.hpp"
+
+class Checkpoint_Test : public ::testing::Test {
+
+    protected:
+
+    Checkpoint_Test() {
+
+    }
+
+    ~Checkpoint_Test() override {
+
+    }
+
+    void SetUp() override {
+        file_path = hy_features::Checkpoint::get_file_path("checkpoint_test", 3);
+    }
+
+    void TearDown() override {
+        std::remove(file_path.c_str());
+    }
+
+    std::string file_path;
+
+};
+
+//! Test that a checkpoint file can be written and read back unchanged.
+TEST_F(Checkpoint_Test, TestWriteAndRead)
+{
+    hy_features::Checkpoint checkpoint(3, 24, 1262304000);
+    checkpoint.catchment_states.emplace_back("cat-1", std::vector<char>{'a', 'b', 'c'});
+    checkpoint.catchment_states.emplace_back("cat-2", std::vector<char>());
+    checkpoint.nexus_states.emplace_back("nex-1", std::vector<char>{'\0', 'x'});
+    checkpoint.write(file_path);
+
+    hy_features::Checkpoint read = hy_features::Checkpoint::read(file_path);
+    ASSERT_EQ(read.rank, 3);
+    ASSERT_EQ(read.output_time_index, 24);
+    ASSERT_EQ(read.epoch_time, 1262304000);
+    ASSERT_EQ(read.catchment_states, checkpoint.catchment_states);
+    ASSERT_EQ(read.nexus_states, checkpoint.nexus_states);
+}
+
+//! Test that a damaged checkpoint file is rejected.
+TEST_F(Checkpoint_Test, TestCorruptFile)
+{
+    hy_features::Checkpoint checkpoint(3, 24, 1262304000);
+    checkpoint.catchment_states.emplace_back("cat-1", std::vector<char>{'a', 'b', 'c'});
+    checkpoint.write(file_path);
+
+    std::fstream file(file_path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-1, std::ios::end);
+    file.put('z');
+    file.close();
+    ASSERT_THROW(hy_features::Checkpoint::read(file_path), std::runtime_error);
+
+    std::ofstream truncated(file_path, std::ios::binary | std::ios::trunc);
+    truncated << "NGENCKPT";
+    truncated.close();
+    ASSERT_THROW(hy_features::Checkpoint::read(file_path), std::runtime_error);
+}
+
+//! Test that nexus state is restored with its time steps shifted by the given offset.
+TEST_F(Checkpoint_Test, TestNexusStateOffset)
+{
+    HY_PointHydroNexus saved("nex-1", std::vector<std::string>{"cat-2"});
+    saved.add_upstream_flow(1.5, "cat-1", 3);
+    saved.add_upstream_flow(2.0, "cat-3", 3);
+    utils::State_Writer out;
+    saved.save_state(out);
+
+    HY_PointHydroNexus restored("nex-1", std::vector<std::string>{"cat-2"});
+    utils::State_Reader in(out.data());
+    restored.load_state(in, 10);
+    ASSERT_EQ(in.remaining(), 0);
+    ASSERT_EQ(restored.inspect_upstream_flows(13).second, 2);
+    ASSERT_DOUBLE_EQ(restored.get_downstream_flow("cat-2", 13, 100.0), 3.5);
+}
+
+//! Test which output times are checkpoint times.
+TEST_F(Checkpoint_Test, TestCheckpointTimes)
+{
+    checkpoint_params params;
+    ASSERT_FALSE(params.is_writing());
+    ASSERT_FALSE(params.is_checkpoint_time(24));
+
+    params.path = "checkpoint";
+    params.interval = 24;
+    params.write_at = {10};
+    ASSERT_TRUE(params.is_writing());
+    ASSERT_FALSE(params.is_checkpoint_time(0));
+    ASSERT_TRUE(params.is_checkpoint_time(10));
+    ASSERT_FALSE(params.is_checkpoint_time(12));
+    ASSERT_TRUE(params.is_checkpoint_time(48));
+}
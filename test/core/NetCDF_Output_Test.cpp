@@ -0,0 +1,120 @@
+#ifdef NETCDF_ACTIVE
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "NetCDF_Output.hpp"
+
+class NetCDF_Output_Test : public ::testing::Test {
+
+    protected:
+
+    NetCDF_Output_Test() {
+
+    }
+
+    ~NetCDF_Output_Test() override {
+
+    }
+
+    void SetUp() override {
+        file_path = "netcdf_output_test.nc";
+    }
+
+    void TearDown() override {
+        std::remove(file_path.c_str());
+    }
+
+    std::string file_path;
+
+};
+
+//! Test that catchment and nexus values written across wrapping blocks are read back at the right times and features.
+TEST_F(NetCDF_Output_Test, TestWriteBlocks)
+{
+    const int first_step = 3;
+    const int steps = 7;
+    {
+        hy_features::NetCDF_Output output(file_path, {"cat-1", "cat-2"}, {{"Q_OUT", "ET"}, {"Q_OUT"}},
+                                          {"nex-1"}, first_step, 1000, 3600, 2, 2, 1);
+        for (int t = first_step; t < first_step + steps; t += 2) {
+            int end = std::min(t + 2, first_step + steps);
+            for (int s = t; s < end; ++s) {
+                output.set_catchment_values(0, s, {1.0 * s, 10.0 * s});
+                output.set_catchment_values(1, s, {2.0 * s});
+                output.set_nexus_flow(0, s, 3.0 * s);
+            }
+            output.write(t, end);
+        }
+        output.close();
+    }
+
+    netCDF::NcFile file(file_path, netCDF::NcFile::read);
+    ASSERT_EQ(file.getDim("time").getSize(), steps);
+
+    std::vector<long long> times(steps);
+    file.getVar("time").getVar(times.data());
+    ASSERT_EQ(times[0], 1000);
+    ASSERT_EQ(times[steps - 1], 1000 + (steps - 1) * 3600);
+
+    std::vector<double> q(steps * 2), et(steps * 2), flow(steps);
+    file.getVar("Q_OUT").getVar(q.data());
+    file.getVar("ET").getVar(et.data());
+    file.getVar("nexus_flow").getVar(flow.data());
+    for (int i = 0; i < steps; ++i) {
+        int s = first_step + i;
+        ASSERT_DOUBLE_EQ(q[i * 2], 1.0 * s);
+        ASSERT_DOUBLE_EQ(q[i * 2 + 1], 2.0 * s);
+        ASSERT_DOUBLE_EQ(et[i * 2], 10.0 * s);
+        // The second catchment has no ET output
+        ASSERT_TRUE(std::isnan(et[i * 2 + 1]));
+        ASSERT_DOUBLE_EQ(flow[i], 3.0 * s);
+    }
+}
+
+//! Test that values set a time step at a time are still written, and chunked, a configured block at a time.
+TEST_F(NetCDF_Output_Test, TestWriteBlocksByStep)
+{
+    const int first_step = 0;
+    const int steps = 8;
+    {
+        hy_features::NetCDF_Output output(file_path, {"cat-1"}, {{"Q_OUT"}}, {"nex-1"}, first_step, 1000, 3600, 3, 1,
+                                          1);
+        ASSERT_EQ(output.get_block_steps(), 3);
+        for (int s = first_step; s < first_step + steps; ++s) {
+            output.set_catchment_values(0, s, {1.0 * s});
+            output.set_nexus_flow(0, s, 3.0 * s);
+            output.write_blocks(s + 1, s + 1 == first_step + steps);
+        }
+        output.close();
+    }
+
+    netCDF::NcFile file(file_path, netCDF::NcFile::read);
+    ASSERT_EQ(file.getDim("time").getSize(), steps);
+
+    netCDF::NcVar::ChunkMode mode;
+    std::vector<size_t> chunks(2);
+    file.getVar("Q_OUT").getChunkingParameters(mode, chunks);
+    ASSERT_EQ(mode, netCDF::NcVar::nc_CHUNKED);
+    ASSERT_EQ(chunks[0], 3);
+
+    std::vector<double> q(steps), flow(steps);
+    file.getVar("Q_OUT").getVar(q.data());
+    file.getVar("nexus_flow").getVar(flow.data());
+    for (int s = 0; s < steps; ++s) {
+        ASSERT_DOUBLE_EQ(q[s], 1.0 * s);
+        ASSERT_DOUBLE_EQ(flow[s], 3.0 * s);
+    }
+}
+
+//! Test that output field names are made into valid variable names that do not clash with the file's own.
+TEST_F(NetCDF_Output_Test, TestVariableNames)
+{
+    ASSERT_EQ(hy_features::NetCDF_Output::get_variable_name("Total Discharge"), "Total_Discharge");
+    ASSERT_EQ(hy_features::NetCDF_Output::get_variable_name("1st"), "_1st");
+    ASSERT_EQ(hy_features::NetCDF_Output::get_variable_name("time"), "catchment_time");
+}
+#endif
@@ -355,3 +355,22 @@ TEST_F(Network_Test2, test_dfr_filter)
   //ASSERT_FALSE( std::distance(cat0_it, cat2_it) > 0 );
 }
 
+
+TEST_F(Network_Test2, test_topological_levels)
+{
+  //cat-0 and cat-1 are headwaters, cat-3 and cat-4 are too, but cat-2 must come after cat-0 and cat-1
+  auto levels = n.get_topological_levels("cat");
+  ASSERT_EQ( levels.size(), 2 );
+  ASSERT_EQ( levels[0].size(), 4 );
+  ASSERT_EQ( levels[1].size(), 1 );
+  ASSERT_EQ( levels[1][0], "cat-2" );
+  ASSERT_FALSE( std::find(levels[0].begin(), levels[0].end(), "cat-0") == levels[0].end() );
+  ASSERT_FALSE( std::find(levels[0].begin(), levels[0].end(), "cat-1") == levels[0].end() );
+  ASSERT_FALSE( std::find(levels[0].begin(), levels[0].end(), "cat-3") == levels[0].end() );
+  ASSERT_FALSE( std::find(levels[0].begin(), levels[0].end(), "cat-4") == levels[0].end() );
+
+  auto nexus_levels = n.get_topological_levels("nex");
+  ASSERT_EQ( nexus_levels.size(), 2 );
+  ASSERT_EQ( nexus_levels[0][0], "nex-0" );
+  ASSERT_EQ( nexus_levels[1][0], "nex-1" );
+}
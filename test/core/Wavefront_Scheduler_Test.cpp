@@ -0,0 +1,170 @@
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Wavefront_Scheduler.hpp"
+
+class Wavefront_Scheduler_Test : public ::testing::Test {
+
+    protected:
+
+    Wavefront_Scheduler_Test() {
+
+    }
+
+    ~Wavefront_Scheduler_Test() override {
+
+    }
+
+    void SetUp() override {
+        // Two headwater branches of three catchments each join into a trunk of two catchments:
+        //   0 -> 1 -> 2 --+
+        //                 +--> 6 -> 7
+        //   3 -> 4 -> 5 --+
+        upstream = {{}, {0}, {1}, {}, {3}, {4}, {2, 5}, {6}};
+        levels = {0, 1, 2, 0, 1, 2, 3, 4};
+    }
+
+    void TearDown() override {
+
+    }
+
+    /**
+     * Run a scheduler over the test network, checking every ordering guarantee from within the callbacks.
+     */
+    void run_and_check(size_t threads, size_t window, std::vector<bool> main_thread_only, int steps) {
+        const size_t count = upstream.size();
+        hy_features::Wavefront_Scheduler scheduler(upstream, levels, main_thread_only, threads, window);
+
+        std::unique_ptr<std::atomic<int>[]> done(new std::atomic<int>[count * steps]);
+        for (size_t i = 0; i < count * steps; ++i) {
+            done[i] = 0;
+        }
+        std::atomic<int> completed_steps(0);
+        std::atomic<bool> ordered(true);
+        std::thread::id caller = std::this_thread::get_id();
+
+        scheduler.run(steps, [&](size_t c, int t) {
+            bool ok = t < completed_steps.load() + (int)window;
+            ok = ok && (t == 0 || done[c * steps + t - 1].load() == 1);
+            for (size_t u : upstream[c]) {
+                ok = ok && done[u * steps + t].load() == 1;
+            }
+            ok = ok && (!main_thread_only[c] || std::this_thread::get_id() == caller);
+            if (!ok) {
+                ordered = false;
+            }
+            done[c * steps + t]++;
+        }, [&](int t) {
+            bool ok = t == completed_steps.load() && std::this_thread::get_id() == caller;
+            for (size_t c = 0; c < count; ++c) {
+                ok = ok && done[c * steps + t].load() == 1;
+            }
+            if (!ok) {
+                ordered = false;
+            }
+            completed_steps++;
+        });
+
+        ASSERT_TRUE(ordered.load());
+        ASSERT_EQ(completed_steps.load(), steps);
+        for (size_t i = 0; i < count * steps; ++i) {
+            ASSERT_EQ(done[i].load(), 1);
+        }
+    }
+
+    std::vector<std::vector<size_t>> upstream;
+    std::vector<int> levels;
+
+};
+
+//! Test that a single thread runs everything in a valid order.
+TEST_F(Wavefront_Scheduler_Test, TestSingleThread)
+{
+    run_and_check(1, 4, std::vector<bool>(upstream.size(), false), 50);
+}
+
+//! Test that with a window of 1, every time step is completed before any catchment starts the next.
+TEST_F(Wavefront_Scheduler_Test, TestWindowOfOne)
+{
+    run_and_check(4, 1, std::vector<bool>(upstream.size(), false), 50);
+}
+
+//! Test dependency, window, and completion ordering with several threads over many repetitions.
+TEST_F(Wavefront_Scheduler_Test, TestMultipleThreads)
+{
+    for (int i = 0; i < 20; ++i) {
+        run_and_check(4, 8, std::vector<bool>(upstream.size(), false), 200);
+    }
+}
+
+//! Test that catchments restricted to the main thread only run on the calling thread.
+TEST_F(Wavefront_Scheduler_Test, TestMainThreadOnly)
+{
+    std::vector<bool> main_thread_only(upstream.size(), false);
+    main_thread_only[1] = true;
+    main_thread_only[6] = true;
+    for (int i = 0; i < 10; ++i) {
+        run_and_check(3, 4, main_thread_only, 100);
+    }
+}
+
+//! Test that an exception from a catchment stops the run and is rethrown on the calling thread.
+TEST_F(Wavefront_Scheduler_Test, TestExceptionPropagates)
+{
+    hy_features::Wavefront_Scheduler scheduler(upstream, levels, std::vector<bool>(upstream.size(), false), 4, 4);
+
+    std::atomic<int> completed_steps(0);
+    ASSERT_THROW(scheduler.run(100, [&](size_t c, int t) {
+        if (c == 6 && t == 10) {
+            throw std::runtime_error("catchment failure");
+        }
+    }, [&](int) { completed_steps++; }), std::runtime_error);
+    ASSERT_LE(completed_steps.load(), 10);
+
+    // The scheduler should remain usable afterward
+    completed_steps = 0;
+    scheduler.run(10, [&](size_t, int) {}, [&](int) { completed_steps++; });
+    ASSERT_EQ(completed_steps.load(), 10);
+}
+
+//! Test that a run can start part way through, and that no catchment starts a barrier time step early.
+TEST_F(Wavefront_Scheduler_Test, TestFirstStepAndBarriers)
+{
+    const size_t count = upstream.size();
+    const int first_step = 5;
+    const int steps = 60;
+    hy_features::Wavefront_Scheduler scheduler(upstream, levels, std::vector<bool>(count, false), 4, 8);
+
+    std::atomic<int> completed_steps(first_step);
+    std::atomic<int> early_runs(0);
+    std::atomic<int> late_barriers(0);
+    for (int i = 0; i < 10; ++i) {
+        completed_steps = first_step;
+        scheduler.run(steps, [&](size_t, int t) {
+            if (t < first_step) {
+                early_runs++;
+            }
+            if (t % 10 == 0 && completed_steps.load() != t) {
+                late_barriers++;
+            }
+        }, [&](int t) {
+            ASSERT_EQ(t, completed_steps.load());
+            completed_steps++;
+        }, first_step, [](int t) { return t % 10 == 0; });
+        ASSERT_EQ(completed_steps.load(), steps);
+    }
+    ASSERT_EQ(early_runs.load(), 0);
+    ASSERT_EQ(late_barriers.load(), 0);
+}
+
+//! Test that an invalid window is rejected.
+TEST_F(Wavefront_Scheduler_Test, TestInvalidWindow)
+{
+    ASSERT_THROW(hy_features::Wavefront_Scheduler(upstream, levels, std::vector<bool>(upstream.size(), false), 2, 0),
+                 std::runtime_error);
+}
@@ -0,0 +1,174 @@
+#include "gtest/gtest.h"
+#include "BinaryForcingStore.hpp"
+#include "BinaryForcingStoreProvider.hpp"
+#include "CsvPerFeatureForcingProvider.hpp"
+#include "FileChecker.h"
+#ifdef NETCDF_ACTIVE
+#include "NetCDFPerFeatureDataProvider.hpp"
+#endif
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+class BinaryForcingStoreTest : public ::testing::Test {
+
+    protected:
+
+    void SetUp() override;
+
+    void TearDown() override;
+
+    std::string find_forcing_file(const std::string &name);
+
+    void write_store(const std::vector<std::string> &ids, const std::vector<std::string> &csv_paths);
+
+    std::string store_path = "binary_forcing_store_test.fst";
+    std::string start_time = "2015-12-01 00:00:00";
+    std::string end_time = "2015-12-05 23:00:00";
+};
+
+void BinaryForcingStoreTest::SetUp() {
+}
+
+void BinaryForcingStoreTest::TearDown() {
+    std::remove(store_path.c_str());
+}
+
+std::string BinaryForcingStoreTest::find_forcing_file(const std::string &name) {
+    return utils::FileChecker::find_first_readable({
+        "data/forcing/" + name,
+        "../data/forcing/" + name,
+        "../../data/forcing/" + name
+        });
+}
+
+void BinaryForcingStoreTest::write_store(const std::vector<std::string> &ids, const std::vector<std::string> &csv_paths) {
+    CsvPerFeatureForcingProvider first(forcing_params(csv_paths[0], "CsvPerFeature", start_time, end_time));
+    forcing_params period(store_path, "BinaryStore", start_time, end_time);
+    size_t time_count = (period.end_t - period.start_t) / first.record_duration() + 1;
+    data_access::BinaryForcingStoreWriter writer(store_path, ids,
+                                                 data_access::BinaryForcingStoreWriter::get_provider_variables(first),
+                                                 period.start_t, first.record_duration(), time_count);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        CsvPerFeatureForcingProvider provider(forcing_params(csv_paths[i], "CsvPerFeature", start_time, end_time));
+        writer.write_catchment(ids[i], provider);
+    }
+}
+
+///Test that values read from a store match those of the CSV files it was written from
+TEST_F(BinaryForcingStoreTest, TestValuesMatchCsv)
+{
+    std::vector<std::string> ids = {"cat-27", "cat-52"};
+    std::vector<std::string> paths = {
+        find_forcing_file("cat-27_2015-12-01 00_00_00_2015-12-30 23_00_00.csv"),
+        find_forcing_file("cat-52_2015-12-01 00_00_00_2015-12-30 23_00_00.csv")
+        };
+    write_store(ids, paths);
+
+    data_access::BinaryForcingStoreProvider store(store_path);
+    ASSERT_EQ(store.get_ids(), ids);
+    ASSERT_EQ(store.record_duration(), 3600);
+    time_t begin = store.get_data_start_time();
+    ASSERT_EQ(store.get_data_stop_time(), begin + 120 * 3600);
+
+    for (size_t c = 0; c < ids.size(); ++c) {
+        CsvPerFeatureForcingProvider csv(forcing_params(paths[c], "CsvPerFeature", start_time, end_time));
+        for (int i : {0, 17, 65, 119}) {
+            for (const std::string &name : {std::string(CSDMS_STD_NAME_LIQUID_EQ_PRECIP_RATE), std::string(CSDMS_STD_NAME_SURFACE_TEMP), std::string("DLWRF_surface")}) {
+                double expected = csv.get_value(CSVDataSelector(name, begin + i * 3600, 3600, ""), data_access::SUM);
+                double actual = store.get_value(CatchmentAggrDataSelector(ids[c], name, begin + i * 3600, 3600, ""), data_access::SUM);
+                EXPECT_NEAR(actual, expected, std::abs(expected) * 1e-6 + 1e-12) << ids[c] << " " << name << " " << i;
+            }
+        }
+        // Spanning several time steps, part way through the first
+        double expected = csv.get_value(CSVDataSelector(CSDMS_STD_NAME_SURFACE_TEMP, begin + 1800, 3 * 3600, ""), data_access::MEAN);
+        double actual = store.get_value(CatchmentAggrDataSelector(ids[c], CSDMS_STD_NAME_SURFACE_TEMP, begin + 1800, 3 * 3600, ""), data_access::MEAN);
+        EXPECT_NEAR(actual, expected, 1e-3);
+    }
+
+    EXPECT_TRUE(store.is_property_sum_over_time_step(CSDMS_STD_NAME_LIQUID_EQ_PRECIP_RATE));
+    EXPECT_FALSE(store.is_property_sum_over_time_step(CSDMS_STD_NAME_SURFACE_TEMP));
+    EXPECT_THROW(store.get_ts_index_for_time(begin + 120 * 3600), std::out_of_range);
+    EXPECT_THROW(store.get_value(CatchmentAggrDataSelector("cat-1", CSDMS_STD_NAME_SURFACE_TEMP, begin, 3600, ""), data_access::MEAN), std::runtime_error);
+}
+
+///Test that values read through bound handles match those read with selectors
+TEST_F(BinaryForcingStoreTest, TestBoundValues)
+{
+    std::vector<std::string> ids = {"cat-27", "cat-52"};
+    std::vector<std::string> paths = {
+        find_forcing_file("cat-27_2015-12-01 00_00_00_2015-12-30 23_00_00.csv"),
+        find_forcing_file("cat-52_2015-12-01 00_00_00_2015-12-30 23_00_00.csv")
+        };
+    write_store(ids, paths);
+
+    data_access::BinaryForcingStoreProvider store(store_path);
+    time_t begin = store.get_data_start_time();
+    for (const std::string &id : ids) {
+        data_access::value_handle_t precip = store.bind_value(id, CSDMS_STD_NAME_LIQUID_EQ_PRECIP_RATE, "", data_access::SUM);
+        data_access::value_handle_t temp = store.bind_value(id, "TMP_2maboveground", "", data_access::MEAN);
+        for (int i : {0, 17, 119}) {
+            EXPECT_EQ(store.get_bound_value(precip, begin + i * 3600, 3600),
+                      store.get_value(CatchmentAggrDataSelector(id, CSDMS_STD_NAME_LIQUID_EQ_PRECIP_RATE, begin + i * 3600, 3600, ""), data_access::SUM));
+            EXPECT_EQ(store.get_bound_value(temp, begin + i * 3600 + 1800, 3 * 3600),
+                      store.get_value(CatchmentAggrDataSelector(id, "TMP_2maboveground", begin + i * 3600 + 1800, 3 * 3600, ""), data_access::MEAN));
+        }
+    }
+    EXPECT_THROW(store.bind_value("cat-1", CSDMS_STD_NAME_SURFACE_TEMP, "", data_access::MEAN), std::runtime_error);
+    EXPECT_THROW(store.bind_value("cat-27", "not_a_forcing", "", data_access::SUM), std::runtime_error);
+}
+
+#ifdef NETCDF_ACTIVE
+///Test that a store converted from a NetCDF file holds only its forcings, in their native units, with matching values
+TEST_F(BinaryForcingStoreTest, TestValuesMatchNetCDF)
+{
+    std::vector<std::string> ids = {"cat-27", "cat-52", "cat-67"};
+    data_access::NetCDFPerFeatureDataProvider netcdf(
+        find_forcing_file("cats-27_52_67-2015_12_01-2015_12_30.nc"), utils::StreamHandler());
+
+    std::vector<data_access::binary_forcing_store::Variable> variables =
+        data_access::BinaryForcingStoreWriter::get_provider_variables(netcdf);
+    ASSERT_FALSE(variables.empty());
+    for (const auto &variable : variables) {
+        EXPECT_NE(variable.name, "ids");
+        EXPECT_NE(variable.name, "Time");
+        EXPECT_EQ(variable.units, netcdf.get_variable_units(variable.name)) << variable.name;
+    }
+
+    time_t begin = netcdf.get_data_start_time();
+    long stride = netcdf.record_duration();
+    size_t time_count = 48;
+    {
+        data_access::BinaryForcingStoreWriter writer(store_path, ids, variables, begin, stride, time_count);
+        for (const std::string &id : ids) {
+            writer.write_catchment(id, netcdf);
+        }
+    }
+
+    data_access::BinaryForcingStoreProvider store(store_path);
+    ASSERT_EQ(store.get_ids(), ids);
+    for (const auto &variable : variables) {
+        EXPECT_EQ(store.get_variable_units(variable.name), variable.units);
+        for (const std::string &id : ids) {
+            for (int i : {0, 13, 47}) {
+                CatchmentAggrDataSelector selector(id, variable.name, begin + i * stride, stride, variable.units);
+                double expected = netcdf.get_value(selector, data_access::MEAN);
+                double actual = store.get_value(selector, data_access::MEAN);
+                EXPECT_NEAR(actual, expected, std::abs(expected) * 1e-6 + 1e-12) << id << " " << variable.name << " " << i;
+            }
+        }
+    }
+}
+#endif
+
+///Test that files that are not stores are rejected
+TEST_F(BinaryForcingStoreTest, TestRejectsOtherFiles)
+{
+    {
+        std::ofstream out(store_path);
+        out << "time,precip_rate\n2015-12-01 00:00:00,0.0\n2015-12-01 01:00:00,0.0\n";
+    }
+    EXPECT_THROW(data_access::BinaryForcingStoreProvider provider(store_path), std::runtime_error);
+}
@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <fstream>
 #include <unistd.h>
 #include <stdio.h>
 #include <limits.h>
@@ -164,3 +165,114 @@ TEST_F(CsvPerFeatureForcingProviderTest, TestGetAvailableForcingOutputs)
 
 }
 
+
+///Test time indexing and values for forcing with 15 minute records
+TEST_F(CsvPerFeatureForcingProviderTest, TestSubHourlyForcing)
+{
+    std::string forcing_file_name = "csv_per_feature_sub_hourly_test.csv";
+    {
+        std::ofstream out(forcing_file_name);
+        out << "time,precip_rate,TMP_2maboveground\n"
+            << "2015-12-01 00:00:00,1.0,280.0\n"
+            << "2015-12-01 00:15:00,2.0,281.0\n"
+            << "2015-12-01 00:30:00,3.0,282.0\n"
+            << "2015-12-01 00:45:00,4.0,283.0\n"
+            << "2015-12-01 01:00:00,5.0,284.0\n";
+    }
+    forcing_params forcing_p(forcing_file_name, "CsvPerFeature", "2015-12-01 00:00:00", "2015-12-01 01:00:00");
+    CsvPerFeatureForcingProvider provider(forcing_p);
+    std::remove(forcing_file_name.c_str());
+
+    time_t begin = provider.get_data_start_time();
+    EXPECT_EQ(provider.record_duration(), 900);
+    EXPECT_EQ(provider.get_ts_index_for_time(begin), 0);
+    EXPECT_EQ(provider.get_ts_index_for_time(begin + 1200), 1);
+    EXPECT_EQ(provider.get_ts_index_for_time(begin + 3600), 4);
+    // Past the end of the model period, the last time step is used
+    EXPECT_EQ(provider.get_ts_index_for_time(begin + 5400), 4);
+
+    double precip = provider.get_value(CSVDataSelector(CSDMS_STD_NAME_LIQUID_EQ_PRECIP_RATE, begin, 3600, ""), data_access::SUM);
+    EXPECT_NEAR(precip, 10.0, 0.00001);
+
+    double temp_k = provider.get_value(CSVDataSelector(CSDMS_STD_NAME_SURFACE_TEMP, begin, 3600, ""), data_access::MEAN);
+    EXPECT_NEAR(temp_k, 281.5, 0.00001);
+
+    temp_k = provider.get_value(CSVDataSelector(CSDMS_STD_NAME_SURFACE_TEMP, begin + 1200, 900, ""), data_access::MEAN);
+    EXPECT_NEAR(temp_k, (600 * 281.0 + 300 * 282.0) / 900, 0.00001);
+}
+
+///Test time indexing and values for forcing with irregularly spaced records
+TEST_F(CsvPerFeatureForcingProviderTest, TestIrregularForcing)
+{
+    std::string forcing_file_name = "csv_per_feature_irregular_test.csv";
+    {
+        std::ofstream out(forcing_file_name);
+        out << "time,precip_rate,TMP_2maboveground\n"
+            << "2015-12-01 00:00:00,1.0,280.0\n"
+            << "2015-12-01 01:00:00,2.0,283.0\n"
+            << "2015-12-01 03:00:00,3.0,290.0\n"
+            << "2015-12-01 04:00:00,4.0,291.0\n";
+    }
+    forcing_params forcing_p(forcing_file_name, "CsvPerFeature", "2015-12-01 00:00:00", "2015-12-01 04:00:00");
+    CsvPerFeatureForcingProvider provider(forcing_p);
+    std::remove(forcing_file_name.c_str());
+
+    time_t begin = provider.get_data_start_time();
+    EXPECT_EQ(provider.get_ts_index_for_time(begin + 3599), 0);
+    EXPECT_EQ(provider.get_ts_index_for_time(begin + 9000), 1);
+    EXPECT_EQ(provider.get_ts_index_for_time(begin + 10800), 2);
+    EXPECT_EQ(provider.get_ts_index_for_time(begin + 20000), 3);
+
+    double temp_k = provider.get_value(CSVDataSelector(CSDMS_STD_NAME_SURFACE_TEMP, begin, 10800, ""), data_access::MEAN);
+    EXPECT_NEAR(temp_k, (3600 * 280.0 + 7200 * 283.0) / 10800, 0.00001);
+
+    // Half of the two hour time step's total
+    double precip = provider.get_value(CSVDataSelector(CSDMS_STD_NAME_LIQUID_EQ_PRECIP_RATE, begin + 7200, 3600, ""), data_access::SUM);
+    EXPECT_NEAR(precip, 1.0, 0.00001);
+}
+
+///Test that providers for the same forcing file and time period are shared
+TEST_F(CsvPerFeatureForcingProviderTest, TestSharedProvider)
+{
+    std::vector<std::string> forcing_file_names = {
+        "test/data/forcing/cat-10_2015-12-01 00_00_00_2015-12-30 23_00_00.csv",
+        "../test/data/forcing/cat-10_2015-12-01 00_00_00_2015-12-30 23_00_00.csv",
+        "../../test/data/forcing/cat-10_2015-12-01 00_00_00_2015-12-30 23_00_00.csv"
+        };
+    std::string forcing_file_name = utils::FileChecker::find_first_readable(forcing_file_names);
+
+    forcing_params forcing_p(forcing_file_name, "CsvPerFeature", "2015-12-14 21:00:00", "2015-12-30 23:00:00");
+    std::shared_ptr<CsvPerFeatureForcingProvider> first = CsvPerFeatureForcingProvider::get_shared_provider(forcing_p);
+    std::shared_ptr<CsvPerFeatureForcingProvider> second = CsvPerFeatureForcingProvider::get_shared_provider(forcing_p);
+    EXPECT_EQ(first, second);
+
+    // The same file by another path is still shared
+    forcing_params forcing_p_alt("./" + forcing_file_name, "CsvPerFeature", "2015-12-14 21:00:00", "2015-12-30 23:00:00");
+    EXPECT_EQ(CsvPerFeatureForcingProvider::get_shared_provider(forcing_p_alt), first);
+
+    // A different time period reads the file separately
+    forcing_params forcing_p_other(forcing_file_name, "CsvPerFeature", "2015-12-01 00:00:00", "2015-12-30 23:00:00");
+    std::shared_ptr<CsvPerFeatureForcingProvider> other = CsvPerFeatureForcingProvider::get_shared_provider(forcing_p_other);
+    EXPECT_NE(first, other);
+    EXPECT_NE(first->get_data_start_time(), other->get_data_start_time());
+}
+
+///Test that values read through bound handles match those read with selectors
+TEST_F(CsvPerFeatureForcingProviderTest, TestBoundValues)
+{
+    time_t begin = Forcing_Object->get_data_start_time();
+    data_access::value_handle_t precip = Forcing_Object->bind_value("", CSDMS_STD_NAME_LIQUID_EQ_PRECIP_RATE, "", data_access::SUM);
+    data_access::value_handle_t temp = Forcing_Object->bind_value("", AORC_FIELD_NAME_TEMP_2M_AG, "K", data_access::MEAN);
+    EXPECT_NE(precip, temp);
+
+    for (int i : {0, 65, 100, 387, 388}) {
+        for (long duration : {1800, 3600, 7200}) {
+            EXPECT_DOUBLE_EQ(Forcing_Object->get_bound_value(precip, begin + i * 3600, duration),
+                             Forcing_Object->get_value(CSVDataSelector(CSDMS_STD_NAME_LIQUID_EQ_PRECIP_RATE, begin + i * 3600, duration, ""), data_access::SUM));
+            EXPECT_DOUBLE_EQ(Forcing_Object->get_bound_value(temp, begin + i * 3600, duration),
+                             Forcing_Object->get_value(CSVDataSelector(AORC_FIELD_NAME_TEMP_2M_AG, begin + i * 3600, duration, "K"), data_access::MEAN));
+        }
+    }
+
+    EXPECT_THROW(Forcing_Object->bind_value("", "not_a_forcing", "", data_access::SUM), std::runtime_error);
+}
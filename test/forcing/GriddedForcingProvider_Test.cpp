@@ -0,0 +1,175 @@
+#ifdef NETCDF_ACTIVE
+#include "gtest/gtest.h"
+#include "GriddedForcingProvider.hpp"
+#include "StreamHandler.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+using data_access::GriddedForcingProvider;
+
+/**
+ * Tests of providing catchment forcings from a small gridded file, written for each test, of 3 by 2 cells of width 1
+ * from the origin, where the ``T2D`` value of a cell is ``100 * t + 10 * y + x`` for time step ``t``.
+ */
+class GriddedForcingProviderTest : public ::testing::Test {
+
+    protected:
+
+    void SetUp() override {
+        write_grid();
+    }
+
+    void TearDown() override {
+        std::remove(grid_path.c_str());
+        for (const std::string &path : written_paths) {
+            std::remove(path.c_str());
+        }
+    }
+
+    void write_grid() {
+        netCDF::NcFile nc(grid_path, netCDF::NcFile::replace);
+        netCDF::NcDim time_dim = nc.addDim("time", 2);
+        netCDF::NcDim y_dim = nc.addDim("y", 2);
+        netCDF::NcDim x_dim = nc.addDim("x", 3);
+
+        netCDF::NcVar time_var = nc.addVar("time", netCDF::ncDouble, time_dim);
+        time_var.putAtt("units", "hours since 2015-12-01 00:00:00");
+        std::vector<double> times = {0.0, 1.0};
+        time_var.putVar(times.data());
+        std::vector<double> ys = {0.5, 1.5};
+        nc.addVar("y", netCDF::ncDouble, y_dim).putVar(ys.data());
+        std::vector<double> xs = {0.5, 1.5, 2.5};
+        nc.addVar("x", netCDF::ncDouble, x_dim).putVar(xs.data());
+
+        netCDF::NcVar t2d = nc.addVar("T2D", netCDF::ncDouble, std::vector<netCDF::NcDim>{time_dim, y_dim, x_dim});
+        t2d.putAtt("units", "K");
+        std::vector<double> values;
+        for (int t = 0; t < 2; ++t) {
+            for (int y = 0; y < 2; ++y) {
+                for (int x = 0; x < 3; ++x) {
+                    values.push_back(100.0 * t + 10.0 * y + x);
+                }
+            }
+        }
+        t2d.putVar(values.data());
+    }
+
+    /** Make a fabric of axis-aligned rectangular catchments, each given by its id and x and y bounds. */
+    static geojson::GeoJSON make_fabric(const std::vector<std::pair<std::string, std::vector<double>>> &catchments) {
+        std::stringstream data;
+        data << R"({"type": "FeatureCollection", "features": [)";
+        for (size_t i = 0; i < catchments.size(); ++i) {
+            const std::vector<double> &b = catchments[i].second;
+            data << (i > 0 ? "," : "") << R"({"type": "Feature", "id": ")" << catchments[i].first
+                 << R"(", "properties": {}, "geometry": {"type": "Polygon", "coordinates": [[)"
+                 << "[" << b[0] << "," << b[2] << "],[" << b[1] << "," << b[2] << "],["
+                 << b[1] << "," << b[3] << "],[" << b[0] << "," << b[3] << "],[" << b[0] << "," << b[2] << "]]]}}";
+        }
+        data << "]}";
+        return geojson::read(data);
+    }
+
+    /** Get the weights file for the given catchments, to be removed after the test. */
+    std::string get_weights_file(const std::vector<std::string> &catchment_ids) {
+        std::string path = GriddedForcingProvider::get_weights_path(weights_prefix,
+                                                                    GriddedForcingProvider::get_catchments_key(catchment_ids));
+        written_paths.push_back(path);
+        return path;
+    }
+
+    static ino_t get_inode(const std::string &path) {
+        struct stat s;
+        return stat(path.c_str(), &s) == 0 ? s.st_ino : 0;
+    }
+
+    double get_t2d(GriddedForcingProvider &provider, const std::string &id, int step) {
+        CatchmentAggrDataSelector selector(id, "T2D", provider.get_data_start_time() + 3600 * step, 3600, "K");
+        return provider.get_value(selector, data_access::MEAN);
+    }
+
+    std::string grid_path = "gridded_forcing_provider_test.nc";
+    std::string weights_prefix = "gridded_forcing_provider_test.nc.weights";
+    std::vector<std::string> written_paths;
+};
+
+//! Test that catchment values are the area weighted means of the cells they cover.
+TEST_F(GriddedForcingProviderTest, TestAreaWeightedMeans)
+{
+    geojson::GeoJSON fabric = make_fabric({{"cat-1", {0.0, 1.0, 0.0, 1.0}}, {"cat-2", {1.5, 3.0, 0.0, 1.0}}});
+    get_weights_file({"cat-1", "cat-2"});
+    GriddedForcingProvider provider(grid_path, weights_prefix, fabric, utils::getStdErr());
+
+    EXPECT_NEAR(get_t2d(provider, "cat-1", 0), 0.0, 1e-9);
+    EXPECT_NEAR(get_t2d(provider, "cat-1", 1), 100.0, 1e-9);
+    // Covers half of cell x = 1 and all of cell x = 2
+    EXPECT_NEAR(get_t2d(provider, "cat-2", 0), (1.0 + 2 * 2.0) / 3.0, 1e-9);
+    EXPECT_NEAR(get_t2d(provider, "cat-2", 1), 100.0 + (1.0 + 2 * 2.0) / 3.0, 1e-9);
+}
+
+//! Test that weights are written to a file named for the catchments, and read back by a provider for the same ones.
+TEST_F(GriddedForcingProviderTest, TestWeightsFileReused)
+{
+    geojson::GeoJSON fabric = make_fabric({{"cat-1", {0.0, 1.0, 0.0, 1.0}}, {"cat-2", {1.5, 3.0, 0.0, 1.0}}});
+    std::string weights_file = get_weights_file({"cat-1", "cat-2"});
+    {
+        GriddedForcingProvider provider(grid_path, weights_prefix, fabric, utils::getStdErr());
+    }
+    ino_t written = get_inode(weights_file);
+    ASSERT_NE(written, (ino_t) 0);
+
+    // Weights are written to a temporary file and renamed, so a rewrite would leave a new inode
+    GriddedForcingProvider provider(grid_path, weights_prefix, fabric, utils::getStdErr());
+    EXPECT_EQ(get_inode(weights_file), written);
+    EXPECT_NEAR(get_t2d(provider, "cat-2", 0), (1.0 + 2 * 2.0) / 3.0, 1e-9);
+}
+
+//! Test that providers for different sets of catchments, like MPI ranks' partitions, keep separate weights files.
+TEST_F(GriddedForcingProviderTest, TestWeightsFilePerCatchmentSet)
+{
+    std::string first_file = get_weights_file({"cat-1"});
+    std::string second_file = get_weights_file({"cat-2"});
+    ASSERT_NE(first_file, second_file);
+
+    GriddedForcingProvider first(grid_path, weights_prefix, make_fabric({{"cat-1", {0.0, 1.0, 0.0, 1.0}}}),
+                                 utils::getStdErr());
+    GriddedForcingProvider second(grid_path, weights_prefix, make_fabric({{"cat-2", {1.5, 3.0, 0.0, 1.0}}}),
+                                  utils::getStdErr());
+    EXPECT_NE(get_inode(first_file), (ino_t) 0);
+    EXPECT_NE(get_inode(second_file), (ino_t) 0);
+    EXPECT_NEAR(get_t2d(first, "cat-1", 0), 0.0, 1e-9);
+    EXPECT_NEAR(get_t2d(second, "cat-2", 0), (1.0 + 2 * 2.0) / 3.0, 1e-9);
+}
+
+//! Test that a weights file whose key is for other catchments is not used, even at this set's path.
+TEST_F(GriddedForcingProviderTest, TestWeightsFileKeyChecked)
+{
+    std::string first_file = get_weights_file({"cat-1"});
+    std::string second_file = get_weights_file({"cat-2"});
+    {
+        GriddedForcingProvider first(grid_path, weights_prefix, make_fabric({{"cat-1", {0.0, 1.0, 0.0, 1.0}}}),
+                                     utils::getStdErr());
+    }
+    {
+        std::ifstream in(first_file, std::ios::binary);
+        std::ofstream out(second_file, std::ios::binary);
+        out << in.rdbuf();
+    }
+
+    GriddedForcingProvider second(grid_path, weights_prefix, make_fabric({{"cat-2", {1.5, 3.0, 0.0, 1.0}}}),
+                                  utils::getStdErr());
+    EXPECT_NEAR(get_t2d(second, "cat-2", 0), (1.0 + 2 * 2.0) / 3.0, 1e-9);
+}
+
+//! Test that a catchment covering no cell of the grid is an error when the provider is set up.
+TEST_F(GriddedForcingProviderTest, TestUncoveredCatchmentThrows)
+{
+    geojson::GeoJSON fabric = make_fabric({{"cat-1", {0.0, 1.0, 0.0, 1.0}}, {"cat-3", {10.0, 11.0, 10.0, 11.0}}});
+    get_weights_file({"cat-1", "cat-3"});
+    ASSERT_THROW(GriddedForcingProvider(grid_path, weights_prefix, fabric, utils::getStdErr()), std::runtime_error);
+}
+
+#endif  // NETCDF_ACTIVE
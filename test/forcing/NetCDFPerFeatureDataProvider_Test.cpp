@@ -109,4 +109,124 @@ TEST_F(NetCDFPerFeatureDataProviderTest, TestForcingDataRead)
         std::runtime_error);
     
 }
+///Test that reading in chunks of several time steps, with a small cache, gives the same values as single time steps
+TEST_F(NetCDFPerFeatureDataProviderTest, TestChunkedReads)
+{
+    std::vector<std::string> forcing_file_names = {
+        "data/forcing/cats-27_52_67-2015_12_01-2015_12_30.nc",
+        "../data/forcing/cats-27_52_67-2015_12_01-2015_12_30.nc",
+        "../../data/forcing/cats-27_52_67-2015_12_01-2015_12_30.nc"
+        };
+    std::string forcing_file_name = utils::FileChecker::find_first_readable(forcing_file_names);
+
+    data_access::NetCDFPerFeatureDataProvider single(forcing_file_name, utils::getStdErr(), 1);
+    // Just big enough for one chunk of every variable
+    size_t num_vars = single.get_avaliable_variable_names().size();
+    size_t chunk_bytes = single.get_ids().size() * 7 * sizeof(double);
+    data_access::NetCDFPerFeatureDataProvider chunked(forcing_file_name, utils::getStdErr(), 7, num_vars * chunk_bytes);
+    ASSERT_EQ(chunked.get_cache_chunks(), num_vars);
+
+    auto start_time = single.get_data_start_time();
+    auto duration = single.record_duration();
+    for (const std::string &id : single.get_ids()) {
+        for (int i : {0, 5, 6, 7, 13, 14, 100, 715}) {
+            for (const std::string &name : {std::string(CSDMS_STD_NAME_SURFACE_TEMP), std::string(CSDMS_STD_NAME_LIQUID_EQ_PRECIP_RATE)}) {
+                double expected = single.get_value(NetCDFDataSelector(id, name, start_time + i * duration, duration * 3, ""), data_access::SUM);
+                double actual = chunked.get_value(NetCDFDataSelector(id, name, start_time + i * duration, duration * 3, ""), data_access::SUM);
+                EXPECT_DOUBLE_EQ(actual, expected) << id << " " << name << " " << i;
+            }
+        }
+    }
+}
+
+///Test that the cache holds as many chunks as fit its limit, and that a limit too small for a chunk of every variable is an error
+TEST_F(NetCDFPerFeatureDataProviderTest, TestCacheLimit)
+{
+    std::vector<std::string> forcing_file_names = {
+        "data/forcing/cats-27_52_67-2015_12_01-2015_12_30.nc",
+        "../data/forcing/cats-27_52_67-2015_12_01-2015_12_30.nc",
+        "../../data/forcing/cats-27_52_67-2015_12_01-2015_12_30.nc"
+        };
+    std::string forcing_file_name = utils::FileChecker::find_first_readable(forcing_file_names);
+
+    size_t num_vars = nc_provider->get_avaliable_variable_names().size();
+    size_t chunk_bytes = nc_provider->get_ids().size() * 7 * sizeof(double);
+    ASSERT_GT(num_vars, 1u);
+
+    data_access::NetCDFPerFeatureDataProvider defaulted(forcing_file_name, utils::getStdErr(), 7);
+    EXPECT_EQ(defaulted.get_cache_chunk_bytes(), chunk_bytes);
+    EXPECT_EQ(defaulted.get_cache_chunks(), NetCDFPerFeatureDataProvider::DEFAULT_CACHE_BYTES / chunk_bytes);
+
+    // Partial chunks' worth of the limit are not used
+    data_access::NetCDFPerFeatureDataProvider limited(forcing_file_name, utils::getStdErr(), 7,
+                                                      (num_vars + 2) * chunk_bytes + chunk_bytes / 2);
+    EXPECT_EQ(limited.get_cache_chunks(), num_vars + 2);
+
+    EXPECT_THROW(data_access::NetCDFPerFeatureDataProvider(forcing_file_name, utils::getStdErr(), 7, 1), std::runtime_error);
+    EXPECT_THROW(data_access::NetCDFPerFeatureDataProvider(forcing_file_name, utils::getStdErr(), 7,
+                                                           num_vars * chunk_bytes - 1), std::runtime_error);
+}
+
+///Test that reading a batch of catchments and variables gives the same values as reading them one at a time
+TEST_F(NetCDFPerFeatureDataProviderTest, TestBatchValues)
+{
+    std::vector<std::string> forcing_file_names = {
+        "data/forcing/cats-27_52_67-2015_12_01-2015_12_30.nc",
+        "../data/forcing/cats-27_52_67-2015_12_01-2015_12_30.nc",
+        "../../data/forcing/cats-27_52_67-2015_12_01-2015_12_30.nc"
+        };
+    std::string forcing_file_name = utils::FileChecker::find_first_readable(forcing_file_names);
+
+    data_access::NetCDFPerFeatureDataProvider provider(forcing_file_name, utils::getStdErr(), 7);
+    std::vector<std::string> ids = provider.get_ids();
+    std::reverse(ids.begin(), ids.end());
+    std::vector<std::string> names = {CSDMS_STD_NAME_SURFACE_TEMP, CSDMS_STD_NAME_LIQUID_EQ_PRECIP_RATE};
+    std::vector<data_access::ReSampleMethod> methods = {data_access::MEAN, data_access::SUM};
+    data_access::BatchPlan plan = provider.prepare_batch(ids, names, {"K", ""}, methods);
+    ASSERT_EQ(plan.size(), ids.size() * names.size());
+
+    auto start_time = provider.get_data_start_time();
+    auto duration = provider.record_duration();
+    std::vector<double> values(plan.size());
+    for (int i : {0, 6, 13, 715}) {
+        for (long period : {duration, duration / 2, duration * 3}) {
+            provider.get_batch_values(plan, start_time + i * duration, period, values.data());
+            for (size_t v = 0; v < names.size(); ++v) {
+                for (size_t c = 0; c < ids.size(); ++c) {
+                    double expected = provider.get_value(NetCDFDataSelector(ids[c], names[v], start_time + i * duration, period, plan.output_units[v]), methods[v]);
+                    EXPECT_DOUBLE_EQ(values[v * ids.size() + c], expected) << ids[c] << " " << names[v] << " " << i;
+                }
+            }
+        }
+    }
+
+    EXPECT_THROW(provider.prepare_batch({"cat-nope"}, names, {"K", ""}, methods), std::out_of_range);
+}
+
+///Test that values read through bound handles match those read with selectors
+TEST_F(NetCDFPerFeatureDataProviderTest, TestBoundValues)
+{
+    std::vector<std::string> forcing_file_names = {
+        "data/forcing/cats-27_52_67-2015_12_01-2015_12_30.nc",
+        "../data/forcing/cats-27_52_67-2015_12_01-2015_12_30.nc",
+        "../../data/forcing/cats-27_52_67-2015_12_01-2015_12_30.nc"
+        };
+    std::string forcing_file_name = utils::FileChecker::find_first_readable(forcing_file_names);
+
+    data_access::NetCDFPerFeatureDataProvider provider(forcing_file_name, utils::getStdErr());
+    auto start_time = provider.get_data_start_time();
+    auto duration = provider.record_duration();
+    for (const std::string &id : provider.get_ids()) {
+        data_access::value_handle_t temp = provider.bind_value(id, CSDMS_STD_NAME_SURFACE_TEMP, "K", data_access::MEAN);
+        for (int i : {0, 13, 715}) {
+            for (long period : {duration, duration / 2, duration * 3}) {
+                EXPECT_DOUBLE_EQ(provider.get_bound_value(temp, start_time + i * duration, period),
+                                 provider.get_value(NetCDFDataSelector(id, CSDMS_STD_NAME_SURFACE_TEMP, start_time + i * duration, period, "K"), data_access::MEAN));
+            }
+        }
+    }
+
+    EXPECT_THROW(provider.bind_value("cat-nope", CSDMS_STD_NAME_SURFACE_TEMP, "K", data_access::MEAN), std::out_of_range);
+    EXPECT_THROW(provider.bind_value(provider.get_ids()[0], "T3D", "K", data_access::MEAN), std::runtime_error);
+}
 #endif
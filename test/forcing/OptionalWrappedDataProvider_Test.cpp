@@ -214,3 +214,49 @@ TEST_F(OptionalWrappedDataProvider_Test, test_get_value_3_b) {
         ASSERT_EQ(value, backing_value);
     }
 }
+
+/**
+ * Test that a bound value with 1 override wait is the default first, even though bound after provider has been set.
+ */
+TEST_F(OptionalWrappedDataProvider_Test, test_get_bound_value_1_a) {
+    int example_index = 1;
+
+    OptionalWrappedDataProvider &optProvider = providers[example_index];
+    optProvider.setWrappedProvider(&backingProvider);
+    value_handle_t handle = optProvider.bind_value("", OUTPUT_NAME_1, "m", data_access::SUM);
+    double value = optProvider.get_bound_value(handle, 0, 10);
+    ASSERT_EQ(value, OUTPUT_DEFAULT_1);
+
+    // Second time should be the actual value
+    value = optProvider.get_bound_value(handle, 0, 10);
+    ASSERT_EQ(value, OUTPUT_VALUE_1);
+}
+
+/**
+ * Test that a value bound before the provider is set is read through it once set, when default is not provided.
+ */
+TEST_F(OptionalWrappedDataProvider_Test, test_get_bound_value_3_a) {
+    int example_index = 3;
+
+    OptionalWrappedDataProvider &optProvider = providers[example_index];
+    value_handle_t handle = optProvider.bind_value("", OUTPUT_NAME_1, "m", data_access::SUM);
+    optProvider.setWrappedProvider(&backingProvider);
+    double value = optProvider.get_bound_value(handle, 0, 10);
+
+    ASSERT_EQ(value, OUTPUT_VALUE_1);
+}
+
+/**
+ * Test that a value bound after the provider is set is read straight from it, when default is not provided.
+ */
+TEST_F(OptionalWrappedDataProvider_Test, test_get_bound_value_3_b) {
+    int example_index = 3;
+
+    OptionalWrappedDataProvider &optProvider = providers[example_index];
+    optProvider.setWrappedProvider(&backingProvider);
+    value_handle_t handle = optProvider.bind_value("", OUTPUT_NAME_1, "m", data_access::SUM);
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(optProvider.get_bound_value(handle, 0, 10), OUTPUT_VALUE_1);
+    }
+}
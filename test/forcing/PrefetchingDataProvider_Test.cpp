@@ -0,0 +1,150 @@
+#include "gtest/gtest.h"
+#include "PrefetchingDataProvider.hpp"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * A provider whose values encode the request, and which counts how often it is read.
+ */
+class CountingDataProvider : public data_access::GenericDataProvider {
+    public:
+
+    const std::vector<std::string>& get_avaliable_variable_names() override {
+        return names;
+    }
+
+    long get_data_start_time() override {
+        return 0;
+    }
+
+    long get_data_stop_time() override {
+        return 100 * 3600;
+    }
+
+    long record_duration() override {
+        return 3600;
+    }
+
+    size_t get_ts_index_for_time(const time_t &epoch_time) override {
+        return epoch_time / 3600;
+    }
+
+    double get_value(const CatchmentAggrDataSelector& selector, data_access::ReSampleMethod m) override {
+        ++reads;
+        if (selector.get_id() == "bad") {
+            throw std::out_of_range("No such catchment");
+        }
+        return selector.get_init_time() / 3600 + (selector.get_variable_name() == "b" ? 1000.0 : 0.0)
+               + (selector.get_id() == "cat-2" ? 0.5 : 0.0);
+    }
+
+    std::vector<double> get_values(const CatchmentAggrDataSelector& selector, data_access::ReSampleMethod m) override {
+        return std::vector<double>(1, get_value(selector, m));
+    }
+
+    std::vector<std::string> names = {"a", "b"};
+    std::atomic<size_t> reads{0};
+};
+
+class PrefetchingDataProviderTest : public ::testing::Test {
+
+    protected:
+
+    void SetUp() override {
+        wrapped = std::make_shared<CountingDataProvider>();
+    }
+
+    void TearDown() override {
+    }
+
+    std::shared_ptr<CountingDataProvider> wrapped;
+};
+
+///Test that values are the wrapped provider's, and that later windows are read ahead rather than on demand
+TEST_F(PrefetchingDataProviderTest, TestReadsAhead)
+{
+    data_access::PrefetchingDataProvider provider(wrapped, 4);
+    for (int t = 0; t < 100; ++t) {
+        for (const std::string &id : {"cat-1", "cat-2"}) {
+            for (const std::string &name : {"a", "b"}) {
+                CatchmentAggrDataSelector selector(id, name, t * 3600, 3600, "");
+                ASSERT_EQ(provider.get_value(selector, data_access::SUM), wrapped->get_value(selector, data_access::SUM));
+            }
+        }
+    }
+    // Each value was read once by the test and once by the provider, so nothing read ahead went unused
+    EXPECT_EQ(wrapped->reads, 2 * 100 * 4);
+    EXPECT_GE(provider.get_stall_seconds(), 0.0);
+}
+
+///Test that value_ready reflects what has been read ahead, and that errors are raised when the value is used
+TEST_F(PrefetchingDataProviderTest, TestValueReadyAndErrors)
+{
+    data_access::PrefetchingDataProvider provider(wrapped, 2);
+    CatchmentAggrDataSelector first("cat-1", "a", 0, 3600, "");
+    EXPECT_FALSE(provider.value_ready(first));
+    provider.get_value(first);
+    // Nothing is read ahead for the first window a value is read in, only for the one after it
+    EXPECT_FALSE(provider.value_ready(CatchmentAggrDataSelector("cat-1", "a", 3600, 3600, "")));
+
+    EXPECT_EQ(provider.get_value(CatchmentAggrDataSelector("cat-1", "a", 7200, 3600, "")), 2.0);
+    EXPECT_TRUE(provider.value_ready(CatchmentAggrDataSelector("cat-1", "a", 7200, 3600, "")));
+    EXPECT_TRUE(provider.value_ready(CatchmentAggrDataSelector("cat-1", "a", 10800, 3600, "")));
+    EXPECT_FALSE(provider.value_ready(CatchmentAggrDataSelector("cat-1", "b", 7200, 3600, "")));
+    // Periods of another length are not what was read ahead
+    EXPECT_FALSE(provider.value_ready(CatchmentAggrDataSelector("cat-1", "a", 7200, 7200, "")));
+
+    provider.request_value(CatchmentAggrDataSelector("bad", "a", 0, 3600, ""));
+    EXPECT_THROW(provider.get_value(CatchmentAggrDataSelector("bad", "a", 0, 3600, "")), std::out_of_range);
+    EXPECT_THROW(provider.get_value(CatchmentAggrDataSelector("bad", "a", 7200, 3600, "")), std::out_of_range);
+    EXPECT_FALSE(provider.value_ready(CatchmentAggrDataSelector("bad", "a", 7200, 3600, "")));
+}
+
+///Test that bound values are read ahead for each caller at its own pace, through the wrapped provider's handles
+TEST_F(PrefetchingDataProviderTest, TestBoundValuesPerCallerWindows)
+{
+    data_access::PrefetchingDataProvider provider(wrapped, 4);
+    data_access::value_handle_t ahead = provider.bind_value("cat-1", "a", "", data_access::SUM);
+    data_access::value_handle_t behind = provider.bind_value("cat-2", "b", "", data_access::SUM);
+
+    // One caller running well ahead of the other must not keep the other from having its values read ahead
+    for (int t = 0; t < 100; ++t) {
+        ASSERT_EQ(provider.get_bound_value(ahead, t * 3600, 3600), t);
+        if (t >= 50) {
+            ASSERT_EQ(provider.get_bound_value(behind, (t - 50) * 3600, 3600), t - 50 + 1000.5);
+        }
+    }
+    for (int t = 50; t < 100; ++t) {
+        ASSERT_EQ(provider.get_bound_value(behind, t * 3600, 3600), t + 1000.5);
+    }
+
+    // Only the first window of each caller is read on demand
+    EXPECT_EQ(provider.get_misses(), 2 * 4);
+    EXPECT_EQ(provider.get_hits(), 2 * (100 - 4));
+    EXPECT_EQ(wrapped->reads, 2 * 100);
+}
+
+///Test that shared providers are one per wrapped provider, and are listed, for reporting, only while in use
+TEST_F(PrefetchingDataProviderTest, TestSharedProviders)
+{
+    std::shared_ptr<data_access::PrefetchingDataProvider> first = data_access::PrefetchingDataProvider::get_shared_provider(wrapped, 4);
+    EXPECT_EQ(data_access::PrefetchingDataProvider::get_shared_provider(wrapped, 8), first);
+    std::shared_ptr<data_access::PrefetchingDataProvider> second =
+        data_access::PrefetchingDataProvider::get_shared_provider(std::make_shared<CountingDataProvider>(), 4);
+    EXPECT_NE(second, first);
+
+    std::vector<std::shared_ptr<data_access::PrefetchingDataProvider>> shared = data_access::PrefetchingDataProvider::get_shared_providers();
+    ASSERT_EQ(shared.size(), 2u);
+    EXPECT_NE(std::find(shared.begin(), shared.end(), first), shared.end());
+    EXPECT_NE(std::find(shared.begin(), shared.end(), second), shared.end());
+
+    shared.clear();
+    second.reset();
+    shared = data_access::PrefetchingDataProvider::get_shared_providers();
+    ASSERT_EQ(shared.size(), 1u);
+    EXPECT_EQ(shared[0], first);
+}
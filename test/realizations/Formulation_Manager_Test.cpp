@@ -8,6 +8,10 @@
 
 #include <iostream>
 #include <memory>
+#include <cstdio>
+#include <fstream>
+#include <stdlib.h>
+#include <unistd.h>
 
 #include <iostream>
 
@@ -804,3 +808,280 @@ TEST_F(Formulation_Manager_Test, forcing_provider_specification) {
     }
 }
 
+TEST_F(Formulation_Manager_Test, read_execution_config) {
+    std::stringstream stream;
+    std::string json = fix_paths(EXAMPLE_3);
+    // Add an "execution" section to the beginning of the top-level object
+    json.insert(json.find("{") + 1, " \"execution\": { \"threads\": 4, \"mode\": \"time_blocked\", \"block_size\": 12 }, ");
+    stream << json;
+
+    std::ostream* raw_pointer = &std::cout;
+    std::shared_ptr<std::ostream> s_ptr(raw_pointer, [](void*) {});
+    utils::StreamHandler catchment_output(s_ptr);
+
+    realization::Formulation_Manager manager = realization::Formulation_Manager(stream);
+
+    // Defaults to serial execution, one time step at a time, until read
+    ASSERT_EQ(manager.get_execution_params().threads, 1);
+    ASSERT_EQ(manager.get_execution_params().get_time_block_size(), 1);
+
+    this->add_feature("cat-67");
+    manager.read(this->fabric, catchment_output);
+
+    ASSERT_EQ(manager.get_execution_params().threads, 4);
+    ASSERT_TRUE(manager.get_execution_params().mode == ExecutionMode::TimeBlocked);
+    ASSERT_EQ(manager.get_execution_params().get_time_block_size(), 12);
+}
+
+TEST_F(Formulation_Manager_Test, read_execution_config_wavefront) {
+    std::stringstream stream;
+    std::string json = fix_paths(EXAMPLE_3);
+    json.insert(json.find("{") + 1, " \"execution\": { \"threads\": 0, \"mode\": \"wavefront\", \"block_size\": 8 }, ");
+    stream << json;
+
+    std::ostream* raw_pointer = &std::cout;
+    std::shared_ptr<std::ostream> s_ptr(raw_pointer, [](void*) {});
+    utils::StreamHandler catchment_output(s_ptr);
+
+    realization::Formulation_Manager manager = realization::Formulation_Manager(stream);
+    this->add_feature("cat-67");
+    manager.read(this->fabric, catchment_output);
+
+    ASSERT_EQ(manager.get_execution_params().threads, 0);
+    ASSERT_TRUE(manager.get_execution_params().mode == ExecutionMode::Wavefront);
+    ASSERT_EQ(manager.get_execution_params().block_size, 8);
+    // Time blocks only apply to time-blocked execution
+    ASSERT_EQ(manager.get_execution_params().get_time_block_size(), 1);
+}
+
+/**
+ * A manager given its global forcing and execution configs directly, exposing the options it sets for reading forcings.
+ */
+class Forcing_Read_Options_Manager : public realization::Formulation_Manager {
+    public:
+    Forcing_Read_Options_Manager(std::stringstream &data, const execution_params &execution)
+        : Formulation_Manager(data)
+    {
+        this->execution_config = execution;
+    }
+
+    void set_global_forcing_option(const std::string &key, long value) {
+        this->global_forcing.emplace(key, geojson::JSONProperty(key, value));
+    }
+
+    forcing_params get_read_options() {
+        forcing_params forcing_config("", "NetCDF", "2015-12-01 00:00:00", "2015-12-30 23:00:00");
+        this->set_forcing_read_options(forcing_config);
+        return forcing_config;
+    }
+};
+
+TEST_F(Formulation_Manager_Test, forcing_chunks_default_to_time_block) {
+    std::stringstream stepped_config{"{}"};
+    Forcing_Read_Options_Manager stepped(stepped_config, execution_params(1, ExecutionMode::TimeStep, 12));
+    ASSERT_EQ(stepped.get_read_options().chunk_time_steps, 0u);
+
+    // Time-blocked, a block of every catchment's forcings is read at once
+    std::stringstream blocked_config{"{}"};
+    Forcing_Read_Options_Manager blocked(blocked_config, execution_params(1, ExecutionMode::TimeBlocked, 12));
+    ASSERT_EQ(blocked.get_read_options().chunk_time_steps, 12u);
+
+    // Unless chunks are configured
+    blocked.set_global_forcing_option("chunk_time_steps", 48);
+    ASSERT_EQ(blocked.get_read_options().chunk_time_steps, 48u);
+}
+
+TEST_F(Formulation_Manager_Test, read_checkpoint_config) {
+    std::stringstream stream;
+    std::string json = fix_paths(EXAMPLE_3);
+    json.insert(json.find("{") + 1, " \"checkpoint\": { \"path\": \"./ngen\", \"interval\": 24, \"write_at\": [10], \"restart_from\": \"./previous/ngen\" }, ");
+    stream << json;
+
+    std::ostream* raw_pointer = &std::cout;
+    std::shared_ptr<std::ostream> s_ptr(raw_pointer, [](void*) {});
+    utils::StreamHandler catchment_output(s_ptr);
+
+    realization::Formulation_Manager manager = realization::Formulation_Manager(stream);
+    this->add_feature("cat-67");
+    manager.read(this->fabric, catchment_output);
+
+    const checkpoint_params& params = manager.get_checkpoint_params();
+    ASSERT_EQ(params.path, "./ngen");
+    ASSERT_EQ(params.interval, 24);
+    ASSERT_EQ(params.write_at.count(10), 1);
+    ASSERT_EQ(params.restart_from, "./previous/ngen");
+    ASSERT_TRUE(params.is_writing());
+    ASSERT_TRUE(params.is_restoring());
+}
+
+TEST_F(Formulation_Manager_Test, read_checkpoint_config_requires_path) {
+    std::stringstream stream;
+    std::string json = fix_paths(EXAMPLE_3);
+    json.insert(json.find("{") + 1, " \"checkpoint\": { \"interval\": 24 }, ");
+    stream << json;
+
+    std::ostream* raw_pointer = &std::cout;
+    std::shared_ptr<std::ostream> s_ptr(raw_pointer, [](void*) {});
+    utils::StreamHandler catchment_output(s_ptr);
+
+    realization::Formulation_Manager manager = realization::Formulation_Manager(stream);
+    this->add_feature("cat-67");
+    ASSERT_THROW(manager.read(this->fabric, catchment_output), std::runtime_error);
+}
+
+TEST_F(Formulation_Manager_Test, read_output_config) {
+    std::stringstream stream;
+    std::string json = fix_paths(EXAMPLE_3);
+    json.insert(json.find("{") + 1, " \"output\": { \"format\": \"csv\", \"path\": \"./out/ngen\", \"compression_level\": 4 }, ");
+    stream << json;
+
+    std::ostream* raw_pointer = &std::cout;
+    std::shared_ptr<std::ostream> s_ptr(raw_pointer, [](void*) {});
+    utils::StreamHandler catchment_output(s_ptr);
+
+    realization::Formulation_Manager manager = realization::Formulation_Manager(stream);
+    this->add_feature("cat-67");
+    manager.read(this->fabric, catchment_output);
+
+    ASSERT_FALSE(manager.get_output_params().is_netcdf());
+    ASSERT_EQ(manager.get_output_params().path, "./out/ngen");
+    ASSERT_EQ(manager.get_output_params().compression_level, 4);
+}
+
+TEST_F(Formulation_Manager_Test, read_output_config_invalid_format) {
+    std::stringstream stream;
+    std::string json = fix_paths(EXAMPLE_3);
+    json.insert(json.find("{") + 1, " \"output\": { \"format\": \"parquet\" }, ");
+    stream << json;
+
+    std::ostream* raw_pointer = &std::cout;
+    std::shared_ptr<std::ostream> s_ptr(raw_pointer, [](void*) {});
+    utils::StreamHandler catchment_output(s_ptr);
+
+    realization::Formulation_Manager manager = realization::Formulation_Manager(stream);
+    this->add_feature("cat-67");
+    ASSERT_THROW(manager.read(this->fabric, catchment_output), std::runtime_error);
+}
+
+/**
+ * A manager given the global forcing and hydrofabric directly, exposing its lookup of each catchment's forcing file.
+ */
+class Forcing_Lookup_Manager : public realization::Formulation_Manager {
+    public:
+    Forcing_Lookup_Manager(std::stringstream &data, geojson::GeoJSON fabric, const std::string &path,
+                           const std::string &file_pattern)
+        : Formulation_Manager(data)
+    {
+        this->fabric = fabric;
+        this->global_forcing.emplace("path", geojson::JSONProperty("path", path));
+        this->global_forcing.emplace("file_pattern", geojson::JSONProperty("file_pattern", file_pattern));
+    }
+
+    std::string get_forcing_path(const std::string &identifier) {
+        simulation_time_params simulation_time_config("2015-12-01 00:00:00", "2015-12-30 23:00:00", 3600);
+        return this->get_global_forcing_params(identifier, simulation_time_config).path;
+    }
+
+    const std::unordered_map<std::string, std::string> &get_indexed_files() const {
+        return this->forcing_files_by_id;
+    }
+
+    const std::vector<std::string> &get_listed_files() const {
+        return this->forcing_file_names;
+    }
+};
+
+/**
+ * Tests of finding catchments' forcing files in a directory by a global file pattern, in a directory of files written
+ * for each test.
+ */
+class Formulation_Manager_Forcing_Lookup_Test : public Formulation_Manager_Test {
+
+    protected:
+
+    void SetUp() override {
+        char directory_template[] = "/tmp/ngen_forcing_lookup_XXXXXX";
+        ASSERT_NE(mkdtemp(directory_template), nullptr);
+        forcing_dir = std::string(directory_template) + "/";
+        for (const std::string &file_name : file_names) {
+            std::ofstream(forcing_dir + file_name) << "time,APCP_surface\n";
+        }
+        this->add_feature("cat-52");
+        this->add_feature("cat-67");
+    }
+
+    void TearDown() override {
+        for (const std::string &file_name : file_names) {
+            std::remove((forcing_dir + file_name).c_str());
+        }
+        rmdir(forcing_dir.c_str());
+    }
+
+    /** Get the first listed file that the pattern, with the given id in place of ``{{id}}``, matches all of. */
+    std::string get_first_match(Forcing_Lookup_Manager &manager, const std::string &pattern) {
+        std::regex regex(pattern);
+        for (const std::string &file_name : manager.get_listed_files()) {
+            if (std::regex_match(file_name, regex)) {
+                return file_name;
+            }
+        }
+        return "";
+    }
+
+    std::string forcing_dir;
+    std::vector<std::string> file_names = {
+        "cat-52_2015.csv",
+        "cat-67_2015.csv",
+        "cat-67_2016.csv",
+        "cat-99_2015.csv",
+        "cat-52_notes.txt"
+    };
+    std::stringstream empty_config{"{}"};
+};
+
+//! Test that the pattern is split at its id to index each hydrofabric catchment to the file its id is found in.
+TEST_F(Formulation_Manager_Forcing_Lookup_Test, index_forcing_files_by_fabric_id) {
+    Forcing_Lookup_Manager manager(empty_config, this->fabric, forcing_dir, ".*{{id}}_.*\\.csv");
+
+    ASSERT_EQ(manager.get_forcing_path("cat-52"), forcing_dir + "cat-52_2015.csv");
+    ASSERT_EQ(manager.get_listed_files().size(), file_names.size());
+
+    const std::unordered_map<std::string, std::string> &indexed = manager.get_indexed_files();
+    ASSERT_EQ(indexed.size(), 2u);
+    ASSERT_EQ(indexed.at("cat-52"), "cat-52_2015.csv");
+    ASSERT_EQ(indexed.count("cat-99"), 0u);
+    ASSERT_EQ(manager.get_forcing_path("cat-67"), forcing_dir + indexed.at("cat-67"));
+}
+
+//! Test that a catchment with several matching files is indexed to the first listed, as matching one by one would.
+TEST_F(Formulation_Manager_Forcing_Lookup_Test, index_forcing_files_first_match) {
+    Forcing_Lookup_Manager manager(empty_config, this->fabric, forcing_dir, ".*{{id}}_.*\\.csv");
+    manager.get_forcing_path("cat-52");
+
+    std::string first = get_first_match(manager, ".*cat-67_.*\\.csv");
+    ASSERT_TRUE(first == "cat-67_2015.csv" || first == "cat-67_2016.csv");
+    ASSERT_EQ(manager.get_indexed_files().at("cat-67"), first);
+    ASSERT_EQ(manager.get_forcing_path("cat-67"), forcing_dir + first);
+}
+
+//! Test that ids outside the hydrofabric are found by matching the listed files one by one, or not at all.
+TEST_F(Formulation_Manager_Forcing_Lookup_Test, index_forcing_files_fallback_outside_fabric) {
+    Forcing_Lookup_Manager manager(empty_config, this->fabric, forcing_dir, ".*{{id}}_.*\\.csv");
+
+    ASSERT_EQ(manager.get_forcing_path("cat-99"), forcing_dir + "cat-99_2015.csv");
+    ASSERT_THROW(manager.get_forcing_path("cat-27"), std::runtime_error);
+}
+
+//! Test that a pattern that cannot be split at its id indexes nothing, and the files are matched one by one instead.
+TEST_F(Formulation_Manager_Forcing_Lookup_Test, index_forcing_files_fallback_unsplittable) {
+    Forcing_Lookup_Manager indexed(empty_config, this->fabric, forcing_dir, ".*{{id}}_.*\\.csv");
+    std::stringstream other_config{"{}"};
+    Forcing_Lookup_Manager unsplittable(other_config, this->fabric, forcing_dir, "(.*{{id}})_.*\\.csv");
+
+    ASSERT_EQ(unsplittable.get_forcing_path("cat-52"), forcing_dir + "cat-52_2015.csv");
+    ASSERT_TRUE(unsplittable.get_indexed_files().empty());
+
+    // Both ways find the same file, including the first listed for a catchment with several
+    ASSERT_EQ(unsplittable.get_forcing_path("cat-67"), indexed.get_forcing_path("cat-67"));
+    ASSERT_EQ(unsplittable.get_forcing_path("cat-99"), indexed.get_forcing_path("cat-99"));
+}
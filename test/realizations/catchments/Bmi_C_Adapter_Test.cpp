@@ -6,6 +6,8 @@
 #include <chrono>
 #include <unordered_map>
 #include <numeric>
+#include <memory>
+#include <dlfcn.h>
 
 #include "FileChecker.h"
 #include "Bmi_C_Adapter.hpp"
@@ -52,6 +54,10 @@ protected:
         return (model_data*) adapter->bmi_model->data;
     }
 
+    static const void* friend_get_dyn_lib_handle(Bmi_C_Adapter *adapter) {
+        return adapter->get_dyn_lib_handle();
+    }
+
     std::string config_file_name_0;
     std::string lib_file_name_0;
     std::string forcing_file_name_0;
@@ -655,4 +661,46 @@ TEST_F(Bmi_C_Adapter_Test, DISABLED_GetGridSize_0_a) {
     }
 }
 
+/** Test adapters for the same library share one handle to it, and its looked up symbols, until the last is released. */
+TEST_F(Bmi_C_Adapter_Test, DynamicLibrary_0_a) {
+    std::weak_ptr<DynamicLibrary> library;
+    {
+        const std::lock_guard<std::mutex> lock(DynamicLibrary::get_loaded_libraries_mutex());
+        library = DynamicLibrary::get_loaded_libraries()[lib_file_name_0];
+    }
+    std::shared_ptr<DynamicLibrary> shared = library.lock();
+    ASSERT_NE(shared, nullptr);
+    ASSERT_EQ(friend_get_dyn_lib_handle(adapter.get()), shared->handle);
+    ASSERT_EQ(shared->symbols.count(REGISTRATION_FUNC), 1u);
+    void *registration_symbol = shared->symbols[REGISTRATION_FUNC];
+    ASSERT_EQ(registration_symbol, dlsym(shared->handle, REGISTRATION_FUNC));
+
+    std::unique_ptr<Bmi_C_Adapter> second = std::make_unique<Bmi_C_Adapter>(
+            bmi_module_type_name_0, lib_file_name_0, config_file_name_0, forcing_file_name_0, false, true,
+            REGISTRATION_FUNC, utils::StreamHandler());
+    ASSERT_EQ(friend_get_dyn_lib_handle(second.get()), shared->handle);
+    // Held by the two adapters and here, but not by the registry
+    ASSERT_EQ(shared.use_count(), 3);
+    ASSERT_EQ(shared->symbols.size(), 1u);
+    ASSERT_EQ(shared->symbols[REGISTRATION_FUNC], registration_symbol);
+
+    // Each adapter still has its own model
+    ASSERT_NE(friend_get_model_data_struct(adapter.get()), friend_get_model_data_struct(second.get()));
+
+    std::string library_path = shared->path;
+    shared.reset();
+    adapter.reset();
+    ASSERT_FALSE(library.expired());
+    second.reset();
+    ASSERT_TRUE(library.expired());
+    // Closed for good, so asking for it without loading it finds nothing
+    ASSERT_EQ(dlopen(library_path.c_str(), RTLD_NOW | RTLD_NOLOAD), nullptr);
+
+    // And loaded again by the next adapter to use it
+    adapter = std::make_unique<Bmi_C_Adapter>(bmi_module_type_name_0, lib_file_name_0, config_file_name_0,
+                                              forcing_file_name_0, false, true, REGISTRATION_FUNC,
+                                              utils::StreamHandler());
+    ASSERT_NE(friend_get_dyn_lib_handle(adapter.get()), nullptr);
+}
+
 #endif  // NGEN_BMI_C_LIB_TESTS_ACTIVE
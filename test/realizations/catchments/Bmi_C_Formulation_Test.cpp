@@ -57,6 +57,12 @@ protected:
         return formulation.get_bmi_model_start_time_forcing_offset_s();
     }
 
+    /** Get the forcing time the model's current time maps to. */
+    static time_t get_friend_model_forcing_time(Bmi_C_Formulation& formulation) {
+        return formulation.convert_model_time(formulation.get_bmi_model()->GetCurrentTime())
+               + formulation.get_bmi_model_start_time_forcing_offset_s();
+    }
+
     static std::string get_friend_forcing_file_path(const Bmi_C_Formulation& formulation) {
         return formulation.get_forcing_file_path();
     }
@@ -77,6 +83,37 @@ protected:
         return formulation.get_var_value_as_double(var_name);
     }
 
+    /** Get whether an input variable is set by writing through the model's own pointer to it, not by ``SetValue``. */
+    static bool is_friend_input_set_by_value_ptr(Bmi_C_Formulation& formulation, const std::string& var_name) {
+        for (auto &descriptor : formulation.input_variable_descriptors) {
+            if (descriptor.name == var_name) {
+                if (descriptor.value_ptr == nullptr) {
+                    return false;
+                }
+                // Only the model's pointer is written through, and no staging buffer is kept alongside it
+                EXPECT_EQ(descriptor.value_ptr, formulation.get_bmi_model()->GetValuePtr(var_name));
+                EXPECT_EQ(descriptor.staging, nullptr);
+                return true;
+            }
+        }
+        throw std::runtime_error("No input variable " + var_name);
+    }
+
+    /** Get the value an input variable should receive for the model's next one hour update, from its provider. */
+    static double get_friend_expected_input(Bmi_C_Formulation& formulation, const std::string& var_name) {
+        for (auto &descriptor : formulation.input_variable_descriptors) {
+            if (descriptor.name == var_name) {
+                time_t epoch_time = formulation.convert_model_time(formulation.get_bmi_model()->GetCurrentTime())
+                        + formulation.get_bmi_model_start_time_forcing_offset_s();
+                CatchmentAggrDataSelector selector(formulation.get_catchment_id(),
+                                                   descriptor.selector.get_variable_name(), epoch_time, 3600,
+                                                   descriptor.units);
+                return descriptor.provider->get_value(selector, data_access::SUM);
+            }
+        }
+        throw std::runtime_error("No input variable " + var_name);
+    }
+
     static time_t parse_forcing_time(const std::string& date_time_str) {
 
         std::locale format = std::locale(std::locale::classic(), new boost::posix_time::time_input_facet("%Y-%m-%d %H:%M:%S"));
@@ -396,6 +433,117 @@ TEST_F(Bmi_C_Formulation_Test, determine_model_time_offset_0_c) {
     ASSERT_EQ(get_friend_bmi_model_start_time_forcing_offset_s(formulation), expected_offset);
 }
 
+/** Test that a formulation only runs alongside others on other threads when configured as thread safe. */
+TEST_F(Bmi_C_Formulation_Test, is_thread_safe_0_a) {
+    int ex_index = 0;
+
+    Bmi_C_Formulation formulation(catchment_ids[ex_index], std::make_shared<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    formulation.create_formulation(config_prop_ptree[ex_index]);
+    ASSERT_FALSE(formulation.is_thread_safe());
+
+    boost::property_tree::ptree config = config_prop_ptree[ex_index];
+    config.put(BMI_REALIZATION_CFG_PARAM_OPT__THREAD_SAFE, true);
+    Bmi_C_Formulation thread_safe(catchment_ids[ex_index], std::make_shared<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    thread_safe.create_formulation(config);
+    ASSERT_TRUE(thread_safe.is_thread_safe());
+}
+
+/** Test that a formulation without configured state variables refuses to checkpoint. */
+TEST_F(Bmi_C_Formulation_Test, save_state_0_a) {
+    int ex_index = 0;
+
+    Bmi_C_Formulation formulation(catchment_ids[ex_index], std::make_shared<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    formulation.create_formulation(config_prop_ptree[ex_index]);
+
+    ASSERT_FALSE(formulation.is_checkpointable());
+    utils::State_Writer out;
+    ASSERT_THROW(formulation.save_state(out), std::runtime_error);
+}
+
+/** Test that state saved part way through a run is restored without re-running the model, so the runs continue alike. */
+TEST_F(Bmi_C_Formulation_Test, load_state_0_a) {
+    int ex_index = 0;
+
+    boost::property_tree::ptree config = config_prop_ptree[ex_index];
+    boost::property_tree::ptree state_vars;
+    for (const std::string &name : {"INPUT_VAR_1", "INPUT_VAR_2", "OUTPUT_VAR_1", "OUTPUT_VAR_2"}) {
+        boost::property_tree::ptree state_var;
+        state_var.put("", name);
+        state_vars.push_back(std::make_pair("", state_var));
+    }
+    config.add_child(BMI_REALIZATION_CFG_PARAM_OPT__STATE_VARS, state_vars);
+
+    Bmi_C_Formulation saved(catchment_ids[ex_index], std::make_shared<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    saved.create_formulation(config);
+    ASSERT_TRUE(saved.is_checkpointable());
+    for (int i = 0; i < 10; i++) {
+        saved.get_response(i, 3600);
+    }
+    utils::State_Writer out;
+    saved.save_state(out);
+
+    Bmi_C_Formulation restored(catchment_ids[ex_index], std::make_shared<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    restored.create_formulation(config);
+    utils::State_Reader in(out.data());
+    double restored_model_time = get_friend_bmi_model(restored)->GetCurrentTime();
+    restored.load_state(in, 0);
+
+    // The restored model's clock is left where it was, and mapped onto the saved forcing time
+    ASSERT_EQ(get_friend_bmi_model(restored)->GetCurrentTime(), restored_model_time);
+    ASSERT_LT(restored_model_time, get_friend_bmi_model(saved)->GetCurrentTime());
+    ASSERT_EQ(get_friend_model_forcing_time(restored), get_friend_model_forcing_time(saved));
+    ASSERT_EQ(get_friend_var_value_as_double(restored, "OUTPUT_VAR_1"),
+              get_friend_var_value_as_double(saved, "OUTPUT_VAR_1"));
+    for (int i = 10; i < 15; i++) {
+        ASSERT_EQ(restored.get_response(i, 3600), saved.get_response(i, 3600));
+    }
+}
+
+/** Test that by default input variables are set through a reused staging buffer, and receive their forcing values. */
+TEST_F(Bmi_C_Formulation_Test, set_model_inputs_0_a) {
+    int ex_index = 0;
+
+    Bmi_C_Formulation formulation(catchment_ids[ex_index], std::make_shared<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    formulation.create_formulation(config_prop_ptree[ex_index]);
+    ASSERT_FALSE(is_friend_input_set_by_value_ptr(formulation, "INPUT_VAR_1"));
+    ASSERT_FALSE(is_friend_input_set_by_value_ptr(formulation, "INPUT_VAR_2"));
+
+    bool any_nonzero = false;
+    for (int i = 0; i < 40; i++) {
+        double expected_1 = get_friend_expected_input(formulation, "INPUT_VAR_1");
+        double expected_2 = get_friend_expected_input(formulation, "INPUT_VAR_2");
+        formulation.get_response(i, 3600);
+        ASSERT_EQ(get_friend_bmi_model(formulation)->GetValue<double>("INPUT_VAR_1")[0], expected_1);
+        ASSERT_EQ(get_friend_bmi_model(formulation)->GetValue<double>("INPUT_VAR_2")[0], expected_2);
+        any_nonzero = any_nonzero || expected_1 != 0.0;
+    }
+    ASSERT_TRUE(any_nonzero);
+}
+
+/** Test that input variables configured to be set by value pointer are written through it, to the same values. */
+TEST_F(Bmi_C_Formulation_Test, set_model_inputs_0_b) {
+    int ex_index = 0;
+
+    boost::property_tree::ptree config = config_prop_ptree[ex_index];
+    config.put(BMI_REALIZATION_CFG_PARAM_OPT__INPUTS_BY_VALUE_PTR, true);
+    Bmi_C_Formulation by_value_ptr(catchment_ids[ex_index], std::make_shared<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    by_value_ptr.create_formulation(config);
+    ASSERT_TRUE(is_friend_input_set_by_value_ptr(by_value_ptr, "INPUT_VAR_1"));
+    ASSERT_TRUE(is_friend_input_set_by_value_ptr(by_value_ptr, "INPUT_VAR_2"));
+
+    Bmi_C_Formulation staged(catchment_ids[ex_index], std::make_shared<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    staged.create_formulation(config_prop_ptree[ex_index]);
+
+    for (int i = 0; i < 40; i++) {
+        double expected_1 = get_friend_expected_input(by_value_ptr, "INPUT_VAR_1");
+        double expected_2 = get_friend_expected_input(by_value_ptr, "INPUT_VAR_2");
+        double response = by_value_ptr.get_response(i, 3600);
+        ASSERT_EQ(get_friend_bmi_model(by_value_ptr)->GetValue<double>("INPUT_VAR_1")[0], expected_1);
+        ASSERT_EQ(get_friend_bmi_model(by_value_ptr)->GetValue<double>("INPUT_VAR_2")[0], expected_2);
+        ASSERT_EQ(response, staged.get_response(i, 3600));
+    }
+}
+
 #endif  // NGEN_BMI_C_LIB_TESTS_ACTIVE
 
 #endif // NGEN_BMI_C_FORMULATION_TEST_CPP
@@ -75,6 +75,37 @@ protected:
         return formulation.get_var_value_as_double(var_name);
     }
 
+    /** Get whether an input variable is set by writing through the model's own pointer to it, not by ``SetValue``. */
+    static bool is_friend_input_set_by_value_ptr(Bmi_Cpp_Formulation& formulation, const std::string& var_name) {
+        for (auto &descriptor : formulation.input_variable_descriptors) {
+            if (descriptor.name == var_name) {
+                if (descriptor.value_ptr == nullptr) {
+                    return false;
+                }
+                // Only the model's pointer is written through, and no staging buffer is kept alongside it
+                EXPECT_EQ(descriptor.value_ptr, formulation.get_bmi_model()->GetValuePtr(var_name));
+                EXPECT_EQ(descriptor.staging, nullptr);
+                return true;
+            }
+        }
+        throw std::runtime_error("No input variable " + var_name);
+    }
+
+    /** Get the value an input variable should receive for the model's next one hour update, from its provider. */
+    static double get_friend_expected_input(Bmi_Cpp_Formulation& formulation, const std::string& var_name) {
+        for (auto &descriptor : formulation.input_variable_descriptors) {
+            if (descriptor.name == var_name) {
+                time_t epoch_time = formulation.convert_model_time(formulation.get_bmi_model()->GetCurrentTime())
+                        + formulation.get_bmi_model_start_time_forcing_offset_s();
+                CatchmentAggrDataSelector selector(formulation.get_catchment_id(),
+                                                   descriptor.selector.get_variable_name(), epoch_time, 3600,
+                                                   descriptor.units);
+                return descriptor.provider->get_value(selector, data_access::SUM);
+            }
+        }
+        throw std::runtime_error("No input variable " + var_name);
+    }
+
     static time_t parse_forcing_time(const std::string& date_time_str) {
 
         std::locale format = std::locale(std::locale::classic(), new boost::posix_time::time_input_facet("%Y-%m-%d %H:%M:%S"));
@@ -375,6 +406,51 @@ TEST_F(Bmi_Cpp_Formulation_Test, determine_model_time_offset_0_c) {
     ASSERT_EQ(get_friend_bmi_model_start_time_forcing_offset_s(formulation), expected_offset);
 }
 
+/** Test that by default input variables are set through a reused staging buffer, and receive their forcing values. */
+TEST_F(Bmi_Cpp_Formulation_Test, set_model_inputs_0_a) {
+    int ex_index = 0;
+
+    Bmi_Cpp_Formulation formulation(catchment_ids[ex_index], std::make_shared<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    formulation.create_formulation(config_prop_ptree[ex_index]);
+    ASSERT_FALSE(is_friend_input_set_by_value_ptr(formulation, "INPUT_VAR_1"));
+    ASSERT_FALSE(is_friend_input_set_by_value_ptr(formulation, "INPUT_VAR_2"));
+
+    bool any_nonzero = false;
+    for (int i = 0; i < 40; i++) {
+        double expected_1 = get_friend_expected_input(formulation, "INPUT_VAR_1");
+        double expected_2 = get_friend_expected_input(formulation, "INPUT_VAR_2");
+        formulation.get_response(i, 3600);
+        ASSERT_EQ(get_friend_bmi_model(formulation)->GetValue<double>("INPUT_VAR_1")[0], expected_1);
+        ASSERT_EQ(get_friend_bmi_model(formulation)->GetValue<double>("INPUT_VAR_2")[0], expected_2);
+        any_nonzero = any_nonzero || expected_1 != 0.0;
+    }
+    ASSERT_TRUE(any_nonzero);
+}
+
+/** Test that input variables configured to be set by value pointer are written through it, to the same values. */
+TEST_F(Bmi_Cpp_Formulation_Test, set_model_inputs_0_b) {
+    int ex_index = 0;
+
+    boost::property_tree::ptree config = config_prop_ptree[ex_index];
+    config.put(BMI_REALIZATION_CFG_PARAM_OPT__INPUTS_BY_VALUE_PTR, true);
+    Bmi_Cpp_Formulation by_value_ptr(catchment_ids[ex_index], std::make_shared<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    by_value_ptr.create_formulation(config);
+    ASSERT_TRUE(is_friend_input_set_by_value_ptr(by_value_ptr, "INPUT_VAR_1"));
+    ASSERT_TRUE(is_friend_input_set_by_value_ptr(by_value_ptr, "INPUT_VAR_2"));
+
+    Bmi_Cpp_Formulation staged(catchment_ids[ex_index], std::make_shared<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    staged.create_formulation(config_prop_ptree[ex_index]);
+
+    for (int i = 0; i < 40; i++) {
+        double expected_1 = get_friend_expected_input(by_value_ptr, "INPUT_VAR_1");
+        double expected_2 = get_friend_expected_input(by_value_ptr, "INPUT_VAR_2");
+        double response = by_value_ptr.get_response(i, 3600);
+        ASSERT_EQ(get_friend_bmi_model(by_value_ptr)->GetValue<double>("INPUT_VAR_1")[0], expected_1);
+        ASSERT_EQ(get_friend_bmi_model(by_value_ptr)->GetValue<double>("INPUT_VAR_2")[0], expected_2);
+        ASSERT_EQ(response, staged.get_response(i, 3600));
+    }
+}
+
 #endif  // NGEN_BMI_CPP_LIB_TESTS_ACTIVE
 
 #endif // NGEN_BMI_CPP_FORMULATION_TEST_CPP
@@ -8,10 +8,12 @@
 #include "Bmi_Testing_Util.hpp"
 #include <exception>
 #include <map>
+#include <set>
 #include <vector>
 #include "gtest/gtest.h"
 #include "Bmi_Multi_Formulation.hpp"
 #include "Bmi_Module_Formulation.hpp"
+#include "Bmi_C_Formulation.hpp"
 #include "Bmi_Fortran_Formulation.hpp"
 #include "Bmi_Py_Formulation.hpp"
 #include "CsvPerFeatureForcingProvider.hpp"
@@ -63,6 +65,41 @@ protected:
         return nested->get_var_value_as_double(var_name);
     }
 
+    /**
+     * Add the handles bound for a nested module's inputs to those of the provider each was bound with.
+     *
+     * The providers the multi formulation wraps for each nested module only forward to it, so handles from those are
+     * added as the multi formulation's.
+     */
+    template <class N>
+    static void add_friend_nested_input_handles(Bmi_Multi_Formulation& formulation, const int mod_index,
+            std::map<const data_access::GenericDataProvider*, std::set<data_access::value_handle_t>> &handles) {
+        std::shared_ptr<N> nested = std::static_pointer_cast<N>(formulation.modules[mod_index]);
+        for (const auto &descriptor : nested->input_variable_descriptors) {
+            if (!descriptor.bound) {
+                continue;
+            }
+            const data_access::GenericDataProvider *provider = descriptor.provider.get();
+            if (dynamic_cast<const data_access::WrappedDataProvider*>(provider) != nullptr
+                    && dynamic_cast<const data_access::DeferredWrappedProvider*>(provider) == nullptr) {
+                provider = &formulation;
+            }
+            handles[provider].insert(descriptor.handle);
+        }
+    }
+
+    /**
+     * Check each provider's handles for nested module inputs are all it has bound, i.e., are numbered from 0 with no
+     * gaps, as the providers here number handles in the order they bind values.
+     */
+    static void check_input_handles_bound_once(
+            const std::map<const data_access::GenericDataProvider*, std::set<data_access::value_handle_t>> &handles) {
+        ASSERT_FALSE(handles.empty());
+        for (const auto &provider_handles : handles) {
+            EXPECT_EQ(*provider_handles.second.rbegin(), provider_handles.second.size() - 1);
+        }
+    }
+
     static std::string get_friend_catchment_id(Bmi_Multi_Formulation& formulation){
         return formulation.get_catchment_id();
     }
@@ -524,6 +561,28 @@ TEST_F(Bmi_Multi_Formulation_Test, Initialize_0_b) {
     ASSERT_EQ(get_friend_deferred_providers(formulation).size(), 0);
 }
 
+/** Test that the inputs of nested modules in example 0 are bound once, leaving no unused handles with providers. */
+TEST_F(Bmi_Multi_Formulation_Test, Initialize_0_c) {
+
+/* Note that a runtime check in SetUp() prevents this from executing when it can't, but
+   this needs to be here to prevent compile-time errors if either of these flags is not
+   enabled. */
+#if NGEN_BMI_C_LIB_ACTIVE && NGEN_BMI_FORTRAN_ACTIVE
+
+    int ex_index = 0;
+
+    Bmi_Multi_Formulation formulation(catchment_ids[ex_index], std::make_unique<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    formulation.create_formulation(config_prop_ptree[ex_index]);
+
+    std::map<const data_access::GenericDataProvider*, std::set<data_access::value_handle_t>> handles;
+    add_friend_nested_input_handles<Bmi_Fortran_Formulation>(formulation, 0, handles);
+    add_friend_nested_input_handles<Bmi_C_Formulation>(formulation, 1, handles);
+    check_input_handles_bound_once(handles);
+
+#endif // NGEN_BMI_C_LIB_ACTIVE && NGEN_BMI_FORTRAN_ACTIVE
+
+}
+
 /** Simple test to make sure the model config from example 1 initializes. */
 TEST_F(Bmi_Multi_Formulation_Test, Initialize_1_a) {
     int ex_index = 1;
@@ -595,6 +654,37 @@ TEST_F(Bmi_Multi_Formulation_Test, Initialize_3_c) {
     }
 }
 
+/**
+ * Test that the inputs of nested modules in example 3 are bound once, including those bound through a deferred
+ * provider once it is associated.
+ */
+TEST_F(Bmi_Multi_Formulation_Test, Initialize_3_d) {
+
+/* Note that a runtime check in SetUp() prevents this from executing when it can't, but
+   this needs to be here to prevent compile-time errors if either of these flags is not
+   enabled. */
+#if ACTIVATE_PYTHON && NGEN_BMI_FORTRAN_ACTIVE
+
+    int ex_index = 3;
+
+    Bmi_Multi_Formulation formulation(catchment_ids[ex_index], std::make_unique<CsvPerFeatureForcingProvider>(*forcing_params_examples[ex_index]), utils::StreamHandler());
+    formulation.create_formulation(config_prop_ptree[ex_index]);
+
+    std::map<const data_access::GenericDataProvider*, std::set<data_access::value_handle_t>> handles;
+    add_friend_nested_input_handles<Bmi_Fortran_Formulation>(formulation, 0, handles);
+    add_friend_nested_input_handles<Bmi_Py_Formulation>(formulation, 1, handles);
+    check_input_handles_bound_once(handles);
+
+    // Including the handles of the deferred provider
+    const std::vector<std::shared_ptr<data_access::OptionalWrappedDataProvider>> &deferred = get_friend_deferred_providers(
+            formulation);
+    ASSERT_FALSE(deferred.empty());
+    ASSERT_EQ(handles.count(deferred[0].get()), 1u);
+
+#endif // ACTIVATE_PYTHON && NGEN_BMI_FORTRAN_ACTIVE
+
+}
+
 /**
  * Simple test of get response in example 0.
  */
@@ -82,6 +82,10 @@ protected:
         return formulation.get_var_value_as_double(var_name);
     }
 
+    static models::bmi::BmiType get_friend_var_bmi_type(Bmi_Py_Formulation& formulation, const string& var_name) {
+        return formulation.get_var_bmi_type(var_name);
+    }
+
     static time_t parse_forcing_time(const std::string& date_time_str) {
 
         std::locale format = std::locale(std::locale::classic(), new boost::posix_time::time_input_facet("%Y-%m-%d %H:%M:%S"));
@@ -483,6 +487,29 @@ TEST_F(Bmi_Py_Formulation_Test, get_var_value_as_double_0_a) {
     ASSERT_EQ(value, retrieved);
 }
 
+/**
+ * Test that the types of the model's variables, which are numpy type names, resolve through the Python override.
+ */
+TEST_F(Bmi_Py_Formulation_Test, get_var_bmi_type_0_a) {
+    int ex_index = 0;
+
+    std::shared_ptr<models::bmi::Bmi_Py_Adapter> model_adapter = get_friend_bmi_model(*examples[ex_index].formulation);
+
+    std::vector<std::string> var_names = model_adapter->GetInputVarNames();
+    std::vector<std::string> output_var_names = model_adapter->GetOutputVarNames();
+    var_names.insert(var_names.end(), output_var_names.begin(), output_var_names.end());
+    ASSERT_FALSE(var_names.empty());
+
+    for (const std::string &var_name : var_names) {
+        SCOPED_TRACE(var_name);
+        std::string type = model_adapter->GetVarType(var_name);
+        // The test model's variables are all numpy float64, which only the override knows
+        ASSERT_EQ(type, "float64");
+        ASSERT_EQ(models::bmi::get_bmi_type(type), models::bmi::BmiType::UNKNOWN);
+        ASSERT_EQ(get_friend_var_bmi_type(*examples[ex_index].formulation, var_name), models::bmi::BmiType::DOUBLE);
+    }
+}
+
 #endif // ACTIVATE_PYTHON
 
 #endif // NGEN_BMI_PY_TESTS_ACTIVE
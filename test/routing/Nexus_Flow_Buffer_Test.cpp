@@ -0,0 +1,54 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "routing/Nexus_Flow_Buffer.hpp"
+
+class NexusFlowBufferTest : public ::testing::Test {
+
+    protected:
+
+    NexusFlowBufferTest() {
+
+    }
+
+    ~NexusFlowBufferTest() override {
+
+    }
+
+    std::vector<std::string> nexus_ids = {"nex-1", "nex-2", "nex-3"};
+
+};
+
+//! Test that flows are laid out nexus-major, as a row-major (nexus, time) array.
+TEST_F(NexusFlowBufferTest, TestLayout)
+{
+    routing_py_adapter::Nexus_Flow_Buffer flows(nexus_ids, 10, 4);
+    ASSERT_EQ(flows.nexus_count(), 3);
+    ASSERT_EQ(flows.get_step_count(), 4);
+    for (size_t n = 0; n < flows.nexus_count(); ++n) {
+        for (int step = 10; step < 14; ++step) {
+            flows.set_flow(n, step, n * 100.0 + step);
+        }
+    }
+    for (size_t n = 0; n < flows.nexus_count(); ++n) {
+        for (int step = 10; step < 14; ++step) {
+            ASSERT_EQ(flows.data()[n * 4 + (step - 10)], n * 100.0 + step);
+            ASSERT_EQ(flows.get_flow(n, step), n * 100.0 + step);
+        }
+    }
+    ASSERT_EQ(flows.get_nexus_ids(), nexus_ids);
+}
+
+//! Test that resetting for a new range of time steps zeros the flows.
+TEST_F(NexusFlowBufferTest, TestReset)
+{
+    routing_py_adapter::Nexus_Flow_Buffer flows(nexus_ids, 0, 2);
+    flows.set_flow(1, 1, 5.0);
+    flows.reset(2, 2);
+    ASSERT_EQ(flows.get_first_step(), 2);
+    ASSERT_EQ(flows.get_flow(1, 3), 0.0);
+    ASSERT_THROW(flows.reset(0, -1), std::runtime_error);
+}
@@ -0,0 +1,144 @@
+#ifdef ROUTING_PYBIND_TESTS_ACTIVE
+#include "gtest/gtest.h"
+#include "Routing_Py_Adapter.hpp"
+#include "Routing_Stream.hpp"
+#include "python/InterpreterUtil.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <pybind11/embed.h>
+#include <pybind11/stl.h>
+namespace py = pybind11;
+
+/**
+ * Tests of routing nexus flows in memory, against a fake ``ngen_routing.ngen_main`` module whose ``ngen_main``
+ * records what it is given, in place of t-route.
+ */
+class RoutingStreamTest : public ::testing::Test {
+
+protected:
+
+    RoutingStreamTest() {
+
+    }
+
+    ~RoutingStreamTest() override {
+
+    }
+
+    void SetUp() override {
+        utils::ngenPy::InterpreterUtil::getInstance();
+        py::exec(R"(
+import sys, types
+if "ngen_routing.ngen_main" not in sys.modules:
+    package = types.ModuleType("ngen_routing")
+    package.ngen_main = types.ModuleType("ngen_routing.ngen_main")
+    sys.modules["ngen_routing"] = package
+    sys.modules["ngen_routing.ngen_main"] = package.ngen_main
+fake = sys.modules["ngen_routing.ngen_main"]
+fake.calls = []
+def ngen_main(argv, nexus_ids=None, nexus_flows=None, first_timestep=None, last_window=None):
+    fake.calls.append((list(argv), list(nexus_ids), nexus_flows.tolist(), first_timestep, last_window))
+fake.ngen_main = ngen_main
+)");
+    }
+
+    /** Replace the fake ``ngen_main`` with a function defined by the given Python source. */
+    void set_ngen_main(const std::string &source) {
+        py::dict scope;
+        py::exec(source, py::globals(), scope);
+        py::module_::import("ngen_routing.ngen_main").attr("ngen_main") = scope["ngen_main"];
+    }
+
+    /** Get the calls made to the default fake ``ngen_main``, in order. */
+    py::list get_calls() {
+        return py::module_::import("ngen_routing.ngen_main").attr("calls");
+    }
+
+    /** Route @ref total_steps steps of flows through the stream, in windows of @ref window_steps. */
+    void route_windows(routing_py_adapter::Routing_Stream &stream) {
+        routing_py_adapter::Nexus_Flow_Buffer flows(nexus_ids, 0, window_steps);
+        for(int first = 0; first < total_steps; first += window_steps) {
+            flows.reset(first, window_steps);
+            for(size_t n = 0; n < nexus_ids.size(); ++n) {
+                for(int s = first; s < first + window_steps; ++s) {
+                    flows.set_flow(n, s, 10.0 * n + s);
+                }
+            }
+            stream.submit(flows, first + window_steps == total_steps);
+        }
+        stream.finish();
+    }
+
+    /** Check the default fake ``ngen_main`` received the flows of @ref route_windows, a window per call. */
+    void check_windows() {
+        py::list calls = get_calls();
+        ASSERT_EQ(py::len(calls), (size_t)(total_steps / window_steps));
+        for(int w = 0; w < total_steps / window_steps; ++w) {
+            py::tuple call = calls[w];
+            std::vector<std::string> argv = call[0].cast<std::vector<std::string>>();
+            EXPECT_EQ(argv, (std::vector<std::string>{"-f", config_path}));
+            EXPECT_EQ(call[1].cast<std::vector<std::string>>(), nexus_ids);
+            std::vector<std::vector<double>> window_flows = call[2].cast<std::vector<std::vector<double>>>();
+            ASSERT_EQ(window_flows.size(), nexus_ids.size());
+            for(size_t n = 0; n < nexus_ids.size(); ++n) {
+                ASSERT_EQ(window_flows[n].size(), (size_t)window_steps);
+                for(int s = 0; s < window_steps; ++s) {
+                    EXPECT_DOUBLE_EQ(window_flows[n][s], 10.0 * n + w * window_steps + s);
+                }
+            }
+            EXPECT_EQ(call[3].cast<int>(), w * window_steps);
+            EXPECT_EQ(call[4].cast<bool>(), w == total_steps / window_steps - 1);
+        }
+    }
+
+    std::string config_path = "./test/data/routing/ngen_routing_config_unit_test.yaml";
+    std::vector<std::string> nexus_ids = {"nex-1", "nex-2", "nex-3"};
+    int window_steps = 4;
+    int total_steps = 12;
+};
+
+//! Test that only an ngen_main taking the in-memory keyword arguments, or any keyword arguments, is accepted.
+TEST_F(RoutingStreamTest, TestAcceptsInMemoryFlows)
+{
+    routing_py_adapter::Routing_Py_Adapter router(config_path);
+    ASSERT_TRUE(router.accepts_in_memory_flows());
+
+    set_ngen_main("def ngen_main(argv):\n    pass\n");
+    ASSERT_FALSE(router.accepts_in_memory_flows());
+
+    set_ngen_main("def ngen_main(argv, nexus_ids=None, nexus_flows=None):\n    pass\n");
+    ASSERT_FALSE(router.accepts_in_memory_flows());
+
+    set_ngen_main("def ngen_main(argv, **kwargs):\n    pass\n");
+    ASSERT_TRUE(router.accepts_in_memory_flows());
+}
+
+//! Test that windows routed as they are submitted hand ngen_main each window's flows and window flags, in order.
+TEST_F(RoutingStreamTest, TestRoutesWindowsInOrder)
+{
+    routing_py_adapter::Routing_Py_Adapter router(config_path);
+    routing_py_adapter::Routing_Stream stream(router, false);
+    route_windows(stream);
+    check_windows();
+}
+
+//! Test that windows routed on a background thread hand ngen_main the same flows and window flags, in order.
+TEST_F(RoutingStreamTest, TestRoutesWindowsConcurrently)
+{
+    routing_py_adapter::Routing_Py_Adapter router(config_path);
+    routing_py_adapter::Routing_Stream stream(router, true);
+    route_windows(stream);
+    check_windows();
+}
+
+//! Test that an error routing a window on a background thread surfaces when the stream finishes.
+TEST_F(RoutingStreamTest, TestConcurrentErrorSurfaces)
+{
+    set_ngen_main("def ngen_main(argv, **kwargs):\n    raise ValueError('routing failed')\n");
+    routing_py_adapter::Routing_Py_Adapter router(config_path);
+    routing_py_adapter::Routing_Stream stream(router, true);
+    ASSERT_THROW(route_windows(stream), std::runtime_error);
+}
+
+#endif  // ROUTING_PYBIND_TESTS_ACTIVE
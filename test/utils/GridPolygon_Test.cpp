@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "core/utility/GridPolygon.hpp"
+
+class GridPolygonTest : public ::testing::Test {
+
+    protected:
+
+    /** Make a shape of one axis-aligned rectangle. */
+    static multi_polygon_type rectangle(double x1, double y1, double x2, double y2)
+    {
+        polygon_type p;
+        bg::append(p.outer(), point_t(x1, y1));
+        bg::append(p.outer(), point_t(x1, y2));
+        bg::append(p.outer(), point_t(x2, y2));
+        bg::append(p.outer(), point_t(x2, y1));
+        bg::append(p.outer(), point_t(x1, y1));
+        bg::correct(p);
+        multi_polygon_type shape;
+        shape.push_back(p);
+        return shape;
+    }
+
+    static std::map<size_t, double> as_map(const std::vector<std::pair<size_t, double>> &fractions)
+    {
+        return std::map<size_t, double>(fractions.begin(), fractions.end());
+    }
+};
+
+/** Test that a shape within one cell gives all its area to that cell. */
+TEST_F(GridPolygonTest, TestAreaFractionsSingleCell) {
+    auto fractions = compute_cell_area_fractions(rectangle(1.2, 2.2, 1.8, 2.8), 0.0, 1.0, 4, 0.0, 1.0, 4);
+    ASSERT_EQ(fractions.size(), 1);
+    EXPECT_EQ(fractions[0].first, 2 * 4 + 1);
+    EXPECT_NEAR(fractions[0].second, 1.0, 1e-12);
+}
+
+/** Test that a shape spanning cells splits its area between them by overlap, with row-major cell indices. */
+TEST_F(GridPolygonTest, TestAreaFractionsSplit) {
+    // Covers half of column 0 and all of column 1 in rows 0 and 1
+    auto fractions = as_map(compute_cell_area_fractions(rectangle(0.5, 0.0, 2.0, 2.0), 0.0, 1.0, 3, 0.0, 1.0, 3));
+    ASSERT_EQ(fractions.size(), 4);
+    EXPECT_NEAR(fractions[0], 0.5 / 3.0, 1e-12);
+    EXPECT_NEAR(fractions[1], 1.0 / 3.0, 1e-12);
+    EXPECT_NEAR(fractions[3], 0.5 / 3.0, 1e-12);
+    EXPECT_NEAR(fractions[4], 1.0 / 3.0, 1e-12);
+}
+
+/** Test that a grid with rows running from north to south, as many gridded files have, is indexed from the top. */
+TEST_F(GridPolygonTest, TestAreaFractionsNegativeWidth) {
+    auto fractions = compute_cell_area_fractions(rectangle(0.25, 9.25, 0.75, 9.75), 0.0, 1.0, 2, 10.0, -1.0, 10);
+    ASSERT_EQ(fractions.size(), 1);
+    EXPECT_EQ(fractions[0].first, 0);
+    EXPECT_NEAR(fractions[0].second, 1.0, 1e-12);
+}
+
+/** Test that only the part of a shape within the grid is counted. */
+TEST_F(GridPolygonTest, TestAreaFractionsPartlyOutside) {
+    auto fractions = compute_cell_area_fractions(rectangle(-1.0, 0.0, 1.0, 1.0), 0.0, 1.0, 2, 0.0, 1.0, 2);
+    ASSERT_EQ(fractions.size(), 1);
+    EXPECT_EQ(fractions[0].first, 0);
+    EXPECT_NEAR(fractions[0].second, 1.0, 1e-12);
+}
+
+/** Test that a shape missing the grid has no cells. */
+TEST_F(GridPolygonTest, TestAreaFractionsOutside) {
+    EXPECT_TRUE(compute_cell_area_fractions(rectangle(5.0, 5.0, 6.0, 6.0), 0.0, 1.0, 2, 0.0, 1.0, 2).empty());
+}
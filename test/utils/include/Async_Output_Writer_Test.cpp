@@ -0,0 +1,250 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "utilities/Async_Output_Writer.hpp"
+
+class AsyncOutputWriterTest : public ::testing::Test {
+
+    protected:
+
+    AsyncOutputWriterTest() {
+
+    }
+
+    ~AsyncOutputWriterTest() override {
+
+    }
+
+    void SetUp() override {
+
+    }
+
+    void TearDown() override {
+        for (const std::string &path : paths) {
+            std::remove(path.c_str());
+        }
+    }
+
+    std::string make_path(int i) {
+        paths.push_back("async_output_writer_test_" + std::to_string(i) + ".csv");
+        return paths.back();
+    }
+
+    /** Get the targets of this process's open file descriptors. */
+    static std::vector<std::string> get_open_targets() {
+        std::vector<std::string> targets;
+        DIR *dir = opendir("/proc/self/fd");
+        if (dir == nullptr) {
+            return targets;
+        }
+        while (struct dirent *entry = readdir(dir)) {
+            char target[4096];
+            std::string link = std::string("/proc/self/fd/") + entry->d_name;
+            ssize_t length = readlink(link.c_str(), target, sizeof(target) - 1);
+            if (length > 0) {
+                targets.emplace_back(target, length);
+            }
+        }
+        closedir(dir);
+        return targets;
+    }
+
+    /** Whether this process's open file descriptors cannot be listed, so tests of them are skipped. */
+    static bool opendir_fails() {
+        DIR *dir = opendir("/proc/self/fd");
+        if (dir == nullptr) {
+            return true;
+        }
+        closedir(dir);
+        return false;
+    }
+
+    static std::string read_file(const std::string &path) {
+        std::ifstream file(path);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    std::vector<std::string> paths;
+
+};
+
+//! Test that files are truncated when opened, even if nothing is written to them.
+TEST_F(AsyncOutputWriterTest, TestOpenTruncates)
+{
+    std::string path = make_path(0);
+    {
+        std::ofstream existing(path);
+        existing << "old contents";
+    }
+    utils::Async_Output_Writer writer;
+    writer.open(path);
+    writer.flush();
+    ASSERT_EQ(read_file(path), "");
+}
+
+//! Test that writes from several threads to more files than may be open at once all end up in order in each file.
+TEST_F(AsyncOutputWriterTest, TestManyFilesFewHandles)
+{
+    const int file_count = 20;
+    const int line_count = 200;
+    utils::Async_Output_Writer writer(3, 1024);
+    std::vector<size_t> handles;
+    for (int i = 0; i < file_count; ++i) {
+        handles.push_back(writer.open(make_path(i)));
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = t; i < file_count; i += 4) {
+                for (int line = 0; line < line_count; ++line) {
+                    writer.write(handles[i], std::to_string(line) + "\n");
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    writer.flush();
+
+    std::string expected;
+    for (int line = 0; line < line_count; ++line) {
+        expected += std::to_string(line) + "\n";
+    }
+    for (int i = 0; i < file_count; ++i) {
+        ASSERT_EQ(read_file(paths[i]), expected);
+    }
+}
+
+//! Test that output streams over the writer deliver everything written to them.
+TEST_F(AsyncOutputWriterTest, TestStream)
+{
+    std::string path = make_path(0);
+    std::shared_ptr<utils::Async_Output_Writer> writer = std::make_shared<utils::Async_Output_Writer>();
+    {
+        utils::Async_Output_Stream stream(writer, path);
+        stream << "Time Step," << 1 << ',' << 2.5 << std::endl;
+    }
+    writer->flush();
+    ASSERT_EQ(read_file(path), "Time Step,1,2.5\n");
+}
+
+//! Test that an error writing a file is reported by the next flush.
+TEST_F(AsyncOutputWriterTest, TestErrorReportedOnFlush)
+{
+    utils::Async_Output_Writer writer;
+    size_t file = writer.open("no_such_directory/async_output_writer_test.csv");
+    writer.write(file, "data\n");
+    ASSERT_THROW(writer.flush(), std::runtime_error);
+    // The error is only reported once
+    writer.flush();
+}
+
+//! Test that flushing leaves what was written in files the writer still holds open.
+TEST_F(AsyncOutputWriterTest, TestFlushWritesOpenFiles)
+{
+    std::string path = make_path(0);
+    utils::Async_Output_Writer writer;
+    size_t file = writer.open(path);
+    writer.write(file, "first\n");
+    writer.flush();
+    ASSERT_EQ(read_file(path), "first\n");
+    writer.write(file, "second\n");
+    writer.flush();
+    ASSERT_EQ(read_file(path), "first\nsecond\n");
+}
+
+//! Test that by default only a small, fixed number of files are held open, however many are written.
+TEST_F(AsyncOutputWriterTest, TestDefaultBoundsOpenFiles)
+{
+    const int file_count = 100;
+    // Only checked where open files can be counted
+    if (opendir_fails()) {
+        return;
+    }
+    size_t before = get_open_targets().size();
+
+    utils::Async_Output_Writer writer;
+    for (int i = 0; i < file_count; ++i) {
+        writer.write(writer.open(make_path(i)), "data\n");
+    }
+    writer.flush();
+    ASSERT_LE(get_open_targets().size() - before, (size_t) utils::Async_Output_Writer::DEFAULT_MAX_OPEN_FILES);
+    for (int i = 0; i < file_count; ++i) {
+        ASSERT_EQ(read_file(paths[i]), "data\n");
+    }
+}
+
+//! Test that the open file closed to open another is the one least recently written.
+TEST_F(AsyncOutputWriterTest, TestLeastRecentlyWrittenClosed)
+{
+    if (opendir_fails()) {
+        return;
+    }
+    utils::Async_Output_Writer writer(2);
+    size_t first = writer.open(make_path(0));
+    size_t second = writer.open(make_path(1));
+    size_t third = writer.open(make_path(2));
+    writer.flush();
+    for (size_t file : {first, second, first, third}) {
+        writer.write(file, std::to_string(file) + "\n");
+        writer.flush();
+    }
+
+    std::vector<std::string> open = get_open_targets();
+    auto is_open = [&](const std::string &path) {
+        for (const std::string &target : open) {
+            if (target.size() >= path.size() && target.compare(target.size() - path.size(), path.size(), path) == 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+    EXPECT_TRUE(is_open("/" + paths[0]));
+    EXPECT_FALSE(is_open("/" + paths[1]));
+    EXPECT_TRUE(is_open("/" + paths[2]));
+    EXPECT_EQ(read_file(paths[0]), std::to_string(first) + "\n" + std::to_string(first) + "\n");
+    EXPECT_EQ(read_file(paths[1]), std::to_string(second) + "\n");
+    EXPECT_EQ(read_file(paths[2]), std::to_string(third) + "\n");
+}
+
+//! Test that each write to a stream reaches the writer at once, so flushing the writer alone writes it out.
+TEST_F(AsyncOutputWriterTest, TestStreamUnbuffered)
+{
+    std::string path = make_path(0);
+    std::shared_ptr<utils::Async_Output_Writer> writer = std::make_shared<utils::Async_Output_Writer>();
+    utils::Async_Output_Stream stream(writer, path);
+    std::string line = "0,2015-12-01 00:00:00,1.5\n";
+    stream.write(line.data(), line.size());
+    stream << 'x';
+    writer->flush();
+    ASSERT_EQ(read_file(path), line + "x");
+}
+
+//! Test that small and large writes to a stream stay in order.
+TEST_F(AsyncOutputWriterTest, TestStreamMixedWrites)
+{
+    std::string path = make_path(0);
+    std::string large(3 * 4096, 'x');
+    std::shared_ptr<utils::Async_Output_Writer> writer = std::make_shared<utils::Async_Output_Writer>();
+    {
+        utils::Async_Output_Stream stream(writer, path);
+        stream << "a," << 1 << ',';
+        stream << large;
+        stream << 'b' << "\n";
+    }
+    writer->flush();
+    ASSERT_EQ(read_file(path), "a,1," + large + "b\n");
+}
@@ -0,0 +1,104 @@
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "bmi_utilities.hpp"
+
+using models::bmi::BmiType;
+
+class BmiUtilitiesTest : public ::testing::Test {
+
+    protected:
+
+    BmiUtilitiesTest() {
+
+    }
+
+    ~BmiUtilitiesTest() override {
+
+    }
+
+    void SetUp() override {
+
+    }
+
+    void TearDown() override {
+
+    }
+
+    /** Get the size and name of the C++ type that @ref models::bmi::dispatch_bmi_type calls a function for. */
+    static std::pair<size_t, std::string> get_dispatched_type(BmiType type) {
+        return models::bmi::dispatch_bmi_type(type, [](auto tag) {
+            typedef typename decltype(tag)::type T;
+            return std::make_pair(sizeof(T), std::string(typeid(T).name()));
+        });
+    }
+
+    /** Each type name a model may give, with the type it resolves to and the C++ type that is dispatched for it. */
+    struct TypeNameCase {
+        std::string name;
+        BmiType type;
+        size_t size;
+        std::string cxx_type_name;
+    };
+
+    std::vector<TypeNameCase> type_names = {
+        {"double", BmiType::DOUBLE, sizeof(double), typeid(double).name()},
+        {"double precision", BmiType::DOUBLE, sizeof(double), typeid(double).name()},
+        {"float", BmiType::FLOAT, sizeof(float), typeid(float).name()},
+        {"real", BmiType::FLOAT, sizeof(float), typeid(float).name()},
+        {"long double", BmiType::LONG_DOUBLE, sizeof(long double), typeid(long double).name()},
+        {"short", BmiType::SHORT, sizeof(short), typeid(short).name()},
+        {"short int", BmiType::SHORT, sizeof(short), typeid(short).name()},
+        {"signed short", BmiType::SHORT, sizeof(short), typeid(short).name()},
+        {"signed short int", BmiType::SHORT, sizeof(short), typeid(short).name()},
+        {"unsigned short", BmiType::UNSIGNED_SHORT, sizeof(unsigned short), typeid(unsigned short).name()},
+        {"unsigned short int", BmiType::UNSIGNED_SHORT, sizeof(unsigned short), typeid(unsigned short).name()},
+        {"int", BmiType::INT, sizeof(int), typeid(int).name()},
+        {"signed", BmiType::INT, sizeof(int), typeid(int).name()},
+        {"signed int", BmiType::INT, sizeof(int), typeid(int).name()},
+        {"integer", BmiType::INT, sizeof(int), typeid(int).name()},
+        {"unsigned", BmiType::UNSIGNED_INT, sizeof(unsigned int), typeid(unsigned int).name()},
+        {"unsigned int", BmiType::UNSIGNED_INT, sizeof(unsigned int), typeid(unsigned int).name()},
+        {"long", BmiType::LONG, sizeof(long), typeid(long).name()},
+        {"long int", BmiType::LONG, sizeof(long), typeid(long).name()},
+        {"signed long", BmiType::LONG, sizeof(long), typeid(long).name()},
+        {"signed long int", BmiType::LONG, sizeof(long), typeid(long).name()},
+        {"unsigned long", BmiType::UNSIGNED_LONG, sizeof(unsigned long), typeid(unsigned long).name()},
+        {"unsigned long int", BmiType::UNSIGNED_LONG, sizeof(unsigned long), typeid(unsigned long).name()},
+        {"long long", BmiType::LONG_LONG, sizeof(long long), typeid(long long).name()},
+        {"long long int", BmiType::LONG_LONG, sizeof(long long), typeid(long long).name()},
+        {"signed long long", BmiType::LONG_LONG, sizeof(long long), typeid(long long).name()},
+        {"signed long long int", BmiType::LONG_LONG, sizeof(long long), typeid(long long).name()},
+        {"unsigned long long", BmiType::UNSIGNED_LONG_LONG, sizeof(unsigned long long),
+         typeid(unsigned long long).name()},
+        {"unsigned long long int", BmiType::UNSIGNED_LONG_LONG, sizeof(unsigned long long),
+         typeid(unsigned long long).name()}
+    };
+
+};
+
+//! Test that every supported type name resolves to its type, and is dispatched as the matching C++ type.
+TEST_F(BmiUtilitiesTest, TestTypeNamesResolve)
+{
+    for (const TypeNameCase &type_name : type_names) {
+        SCOPED_TRACE(type_name.name);
+        ASSERT_EQ(models::bmi::get_bmi_type(type_name.name), type_name.type);
+        std::pair<size_t, std::string> dispatched = get_dispatched_type(type_name.type);
+        EXPECT_EQ(dispatched.first, type_name.size);
+        EXPECT_EQ(dispatched.second, type_name.cxx_type_name);
+    }
+}
+
+//! Test that unsupported type names, including those only meaningful to particular languages' models, are unknown.
+TEST_F(BmiUtilitiesTest, TestUnsupportedTypeNamesUnknown)
+{
+    for (const char *name : {"", "Double", "char", "bool", "string", "float64", "int32", "complex"}) {
+        SCOPED_TRACE(name);
+        EXPECT_EQ(models::bmi::get_bmi_type(name), BmiType::UNKNOWN);
+    }
+    ASSERT_THROW(get_dispatched_type(BmiType::UNKNOWN), std::invalid_argument);
+}
@@ -0,0 +1,116 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "utilities/Mapped_CSV_Reader.hpp"
+
+class MappedCsvReaderTest : public ::testing::Test {
+
+    protected:
+
+    MappedCsvReaderTest() {
+
+    }
+
+    ~MappedCsvReaderTest() override {
+
+    }
+
+    void SetUp() override {
+        file_name = "mapped_csv_reader_test_" + std::to_string(std::rand()) + ".csv";
+    }
+
+    void TearDown() override {
+        std::remove(file_name.c_str());
+    }
+
+    void write_file(const std::string &contents) {
+        std::ofstream out(file_name, std::ios::binary);
+        out << contents;
+    }
+
+    static Mapped_CSV_Reader::Field field(const char *text) {
+        return Mapped_CSV_Reader::Field{text, text + std::strlen(text)};
+    }
+
+    std::string file_name;
+
+};
+
+//! Test splitting rows, with CRLF line endings, blank lines and no trailing newline.
+TEST_F(MappedCsvReaderTest, TestRows)
+{
+    write_file("time,a,b\r\n2015-12-01 00:00:00, 1.5 ,\n\n2015-12-01 01:00:00,2,3");
+    Mapped_CSV_Reader reader(file_name);
+    std::vector<Mapped_CSV_Reader::Field> row;
+
+    ASSERT_TRUE(reader.next_row(row));
+    ASSERT_EQ(row.size(), 3);
+    ASSERT_EQ(row[0].str(), "time");
+    ASSERT_EQ(row[2].str(), "b");
+
+    ASSERT_TRUE(reader.next_row(row));
+    ASSERT_EQ(row.size(), 3);
+    ASSERT_EQ(row[1].str(), " 1.5 ");
+    ASSERT_TRUE(row[2].empty());
+    ASSERT_EQ(reader.get_line_number(), 2);
+
+    ASSERT_TRUE(reader.next_row(row));
+    ASSERT_EQ(row[2].str(), "3");
+    ASSERT_EQ(reader.get_line_number(), 4);
+    ASSERT_EQ(reader.remaining_bytes(), 0);
+
+    ASSERT_FALSE(reader.next_row(row));
+}
+
+//! Test that an empty file has no rows and a missing one throws.
+TEST_F(MappedCsvReaderTest, TestEmptyAndMissing)
+{
+    write_file("");
+    Mapped_CSV_Reader reader(file_name);
+    std::vector<Mapped_CSV_Reader::Field> row;
+    ASSERT_FALSE(reader.next_row(row));
+
+    ASSERT_THROW(Mapped_CSV_Reader("no_such_dir/no_such_file.csv"), std::runtime_error);
+}
+
+//! Test that numbers convert exactly as strtod converts them, and invalid ones are rejected.
+TEST_F(MappedCsvReaderTest, TestParseDouble)
+{
+    for (const char *text : {"0", "-0", "0.1", "3.14159", "-1.5e-3", "2.5E+10", "1e300", "4.9e-324", "1.",
+                             "000123.4500", "123456789.123456789", "123456789012345678901", "9007199254740993"}) {
+        double value;
+        ASSERT_TRUE(Mapped_CSV_Reader::parse_double(field(text), value)) << text;
+        ASSERT_EQ(value, std::strtod(text, nullptr)) << text;
+    }
+
+    double value;
+    ASSERT_TRUE(Mapped_CSV_Reader::parse_double(field("  7.25\t"), value));
+    ASSERT_EQ(value, 7.25);
+
+    for (const char *text : {"", " ", ".", "abc", "1.2.3", "1e", "-", "5 6"}) {
+        ASSERT_FALSE(Mapped_CSV_Reader::parse_double(field(text), value)) << text;
+    }
+}
+
+//! Test that timestamps convert as strptime and timegm convert them.
+TEST_F(MappedCsvReaderTest, TestParseTimestamp)
+{
+    for (const char *text : {"1970-01-01 00:00:00", "2015-12-01 00:00:00", "2000-02-29 23:59:59",
+                             "2100-03-01 12:30:00", "1969-12-31 23:00:00", "2015-12-1 3:00:00"}) {
+        struct tm parsed = tm();
+        strptime(text, "%Y-%m-%d %H:%M:%S", &parsed);
+        time_t epoch_time;
+        ASSERT_TRUE(Mapped_CSV_Reader::parse_timestamp(field(text), epoch_time)) << text;
+        ASSERT_EQ(epoch_time, timegm(&parsed)) << text;
+    }
+
+    time_t epoch_time;
+    ASSERT_FALSE(Mapped_CSV_Reader::parse_timestamp(field("not a time"), epoch_time));
+}
@@ -0,0 +1,91 @@
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "utilities/Output_Line_Buffer.hpp"
+
+class OutputLineBufferTest : public ::testing::Test {
+
+    protected:
+
+    OutputLineBufferTest() {
+
+    }
+
+    ~OutputLineBufferTest() override {
+
+    }
+
+    void SetUp() override {
+
+    }
+
+    void TearDown() override {
+
+    }
+
+    static std::string stream_fixed(double value, int precision) {
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(precision) << value;
+        return stream.str();
+    }
+
+    std::vector<double> values = {0.0, -0.0, 1.0, -1.0, 42.0, 0.5, -0.5, 1.0e-10, 123456.789012345, -9.87654321e-5,
+                                  0.1 + 0.2, 1.0e15, 2.5e20, -7.0e300, std::numeric_limits<double>::min(),
+                                  std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(),
+                                  -std::numeric_limits<double>::infinity()};
+
+};
+
+//! Test that values in fixed notation match what a stream set to fixed at the same precision produces.
+TEST_F(OutputLineBufferTest, TestFixedMatchesStream)
+{
+    utils::Output_Line_Buffer line;
+    for (int precision : {0, 1, 6, 9, 17}) {
+        for (double value : values) {
+            line.clear();
+            line.append_fixed(value, precision);
+            ASSERT_EQ(line.str(), stream_fixed(value, precision)) << "precision " << precision;
+        }
+    }
+}
+
+//! Test that integers match std::to_string, including the extremes.
+TEST_F(OutputLineBufferTest, TestIntegers)
+{
+    utils::Output_Line_Buffer line;
+    for (long long value : {0LL, 7LL, -7LL, 1234567890LL, std::numeric_limits<long long>::max(),
+                            std::numeric_limits<long long>::min()}) {
+        line.clear();
+        line.append_integer(value);
+        ASSERT_EQ(line.str(), std::to_string(value));
+    }
+}
+
+//! Test building a row that outgrows the initial storage, and truncating it back.
+TEST_F(OutputLineBufferTest, TestGrowAndTruncate)
+{
+    utils::Output_Line_Buffer line;
+    std::string expected;
+    for (int i = 0; i < 100; ++i) {
+        line.append_integer(i);
+        line.append(',');
+        line.append_fixed(-7.0e300, 9);
+        line.append(std::string(";"));
+        expected += std::to_string(i) + "," + stream_fixed(-7.0e300, 9) + ";";
+    }
+    ASSERT_EQ(line.str(), expected);
+
+    size_t mark = line.size();
+    line.append("partial", 7);
+    line.truncate(mark);
+    ASSERT_EQ(line.size(), expected.size());
+    ASSERT_EQ(line.str(), expected);
+
+    line.clear();
+    ASSERT_TRUE(line.empty());
+}
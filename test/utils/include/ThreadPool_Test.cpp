@@ -0,0 +1,108 @@
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "utilities/ThreadPool.hpp"
+
+class ThreadPoolTest : public ::testing::Test {
+
+    protected:
+
+    ThreadPoolTest() {
+
+    }
+
+    ~ThreadPoolTest() override {
+
+    }
+
+    void SetUp() override {
+
+    }
+
+    void TearDown() override {
+
+    }
+
+};
+
+//! Test that a pool of size 1 runs everything on the calling thread.
+TEST_F(ThreadPoolTest, TestSingleThreadRunsOnCaller)
+{
+    utils::ThreadPool pool(1);
+    ASSERT_EQ(pool.size(), 1);
+
+    std::thread::id caller = std::this_thread::get_id();
+    std::vector<int> visited(50, 0);
+    bool all_on_caller = true;
+    pool.parallel_for(visited.size(), [&](size_t i) {
+        visited[i]++;
+        all_on_caller = all_on_caller && std::this_thread::get_id() == caller;
+    });
+
+    ASSERT_TRUE(all_on_caller);
+    for (int v : visited) {
+        ASSERT_EQ(v, 1);
+    }
+}
+
+//! Test that every index is processed exactly once, over several repeated loops.
+TEST_F(ThreadPoolTest, TestEachIndexRunsOnce)
+{
+    utils::ThreadPool pool(4);
+    ASSERT_EQ(pool.size(), 4);
+
+    for (int loop = 0; loop < 20; ++loop) {
+        std::vector<std::atomic<int>> visited(1000);
+        for (auto &v : visited) {
+            v = 0;
+        }
+        pool.parallel_for(visited.size(), [&](size_t i) { visited[i]++; });
+        for (const auto &v : visited) {
+            ASSERT_EQ(v.load(), 1);
+        }
+    }
+}
+
+//! Test that the caller-only function runs exactly once, on the calling thread.
+TEST_F(ThreadPoolTest, TestCallerFunctionOnCaller)
+{
+    utils::ThreadPool pool(3);
+
+    std::thread::id caller = std::this_thread::get_id();
+    std::thread::id caller_func_thread;
+    int caller_func_calls = 0;
+    std::atomic<size_t> count(0);
+    pool.parallel_for(100, [&](size_t i) { count++; }, [&]() {
+        caller_func_calls++;
+        caller_func_thread = std::this_thread::get_id();
+    });
+
+    ASSERT_EQ(count.load(), 100);
+    ASSERT_EQ(caller_func_calls, 1);
+    ASSERT_EQ(caller_func_thread, caller);
+}
+
+//! Test that an exception thrown by a task is rethrown on the calling thread after all work completes.
+TEST_F(ThreadPoolTest, TestExceptionPropagates)
+{
+    utils::ThreadPool pool(4);
+
+    std::atomic<size_t> count(0);
+    ASSERT_THROW(pool.parallel_for(200, [&](size_t i) {
+        count++;
+        if (i == 17) {
+            throw std::runtime_error("task failure");
+        }
+    }), std::runtime_error);
+    ASSERT_EQ(count.load(), 200);
+
+    // The pool should remain usable afterward
+    count = 0;
+    pool.parallel_for(10, [&](size_t i) { count++; });
+    ASSERT_EQ(count.load(), 10);
+}